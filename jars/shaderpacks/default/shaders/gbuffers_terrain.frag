@@ -55,13 +55,23 @@ layout(std140) uniform per_frame_uniforms {
 
 in vec2 uv;
 in vec4 color;
+in vec4 tile;
 in vec2 lightmap_uv;
 
 layout(location = 0) out vec4 color_out;
 
 void main() {
     if(textureSize(colortex, 0).x > 0) {
-        vec4 tex_sample = texture(colortex, uv);
+        vec4 tex_sample;
+        if(tile.z > 0) {
+            // Merged quads repeat one texture out of the atlas. uv is the texture's corner, tile.xy counts repeats,
+            // and tile.zw is the texture's size in 2048ths of the atlas
+            vec2 tile_size = tile.zw / 2048.0;
+            vec2 repeat_uv = tile.xy * tile_size;
+            tex_sample = textureGrad(colortex, uv + fract(tile.xy) * tile_size, dFdx(repeat_uv), dFdy(repeat_uv));
+        } else {
+            tex_sample = texture(colortex, uv);
+        }
         if(tex_sample.a < 0.5) {
             discard;
         }
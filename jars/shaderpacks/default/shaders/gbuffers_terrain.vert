@@ -4,8 +4,14 @@ layout(location = 0) in vec3 position_in;
 layout(location = 1) in vec2 uv_in;
 layout(location = 2) in vec2 lightmap_uv_in;
 layout(location = 3) in vec3 normal_in;
+// How a merged quad's texture repeats. Zero for every other quad. There's no tangent, so normal mapping has to work one
+// out from the normal and dFdx/dFdy of the UV
+layout(location = 4) in vec4 tile_in;
 layout(location = 5) in vec4 color_in;
 
+// Where the chunk section is when it's drawn by the GPU culler. Zero otherwise, and gbufferModel moves it instead
+layout(location = 6) in vec3 draw_position_in;
+
 layout(std140) uniform per_frame_uniforms {
     mat4 gbufferModelView;
     mat4 gbufferModelViewInverse;
@@ -60,13 +66,16 @@ uniform mat4 gbufferModel;
 
 out vec2 uv;
 out vec4 color;
+out vec4 tile;
 out vec2 lightmap_uv;
 out vec3 normal;
 
 void main() {
-	gl_Position = gbufferProjection * gbufferModelView * gbufferModel * vec4(position_in, 1.0f);
+	vec4 world_position = gbufferModel * vec4(position_in, 1.0f) + vec4(draw_position_in, 0.0f);
+	gl_Position = gbufferProjection * gbufferModelView * world_position;
 
 	uv = uv_in;
+	tile = tile_in;
 	color = color_in;
 	lightmap_uv = (lightmap_uv_in + 0.5) / 256;
 	normal = normal_in;
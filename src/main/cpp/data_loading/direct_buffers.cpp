@@ -1,21 +1,110 @@
-/*! 
- * \author gold1 
+/*!
+ * \author gold1
  * \date 19-Jul-17.
  */
 
+#include <stdexcept>
 #include "direct_buffers.h"
 
 namespace nova {
+    static std::size_t round_up_to_alignment(std::size_t num_bytes) {
+        return (num_bytes + shared_ring_buffer::ALIGNMENT - 1) / shared_ring_buffer::ALIGNMENT * shared_ring_buffer::ALIGNMENT;
+    }
+
+    shared_ring_buffer::shared_ring_buffer(std::size_t num_bytes) : capacity(round_up_to_alignment(num_bytes)) {
+        buffer = std::unique_ptr<unsigned char[]>(new unsigned char[capacity]);
+    }
+
+    long shared_ring_buffer::reserve(std::size_t num_bytes) {
+        num_bytes = round_up_to_alignment(num_bytes == 0 ? 1 : num_bytes);
+        if(num_bytes > capacity) {
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock_guard(lock);
+
+        std::size_t offset;
+        if(reservations.empty()) {
+            offset = 0;
+
+        } else {
+            std::size_t oldest_offset = reservations.front().offset;
+            bool has_wrapped = reservations.back().offset < oldest_offset;
+
+            if(!has_wrapped && write_offset + num_bytes <= capacity) {
+                // Room between the newest reservation and the end of the buffer
+                offset = write_offset;
+
+            } else if(!has_wrapped && num_bytes <= oldest_offset) {
+                // Room at the start of the buffer. Whatever's left at the end is skipped
+                offset = 0;
+
+            } else if(has_wrapped && write_offset + num_bytes <= oldest_offset) {
+                // Room between the newest reservation and the oldest one
+                offset = write_offset;
+
+            } else {
+                return -1;
+            }
+        }
+
+        reservations.push_back({offset, num_bytes, false});
+        write_offset = offset + num_bytes;
+
+        return static_cast<long>(offset);
+    }
+
+    void shared_ring_buffer::release(long offset) {
+        std::lock_guard<std::mutex> lock_guard(lock);
+
+        for(auto& res : reservations) {
+            if(static_cast<long>(res.offset) == offset) {
+                res.released = true;
+                break;
+            }
+        }
+
+        while(!reservations.empty() && reservations.front().released) {
+            reservations.pop_front();
+        }
+    }
+
+    bool shared_ring_buffer::contains(const void* ptr) const {
+        auto* byte_ptr = static_cast<const unsigned char*>(ptr);
+        return byte_ptr >= buffer.get() && byte_ptr < buffer.get() + capacity;
+    }
+
+    long shared_ring_buffer::offset_of(const void* ptr) const {
+        return static_cast<long>(static_cast<const unsigned char*>(ptr) - buffer.get());
+    }
+
+    unsigned char* shared_ring_buffer::data() {
+        return buffer.get();
+    }
+
+    std::size_t shared_ring_buffer::size() const {
+        return capacity;
+    }
+
+    std::size_t shared_ring_buffer::get_bytes_in_use() {
+        std::lock_guard<std::mutex> lock_guard(lock);
+
+        std::size_t bytes_in_use = 0;
+        for(const auto& res : reservations) {
+            bytes_in_use += res.num_bytes;
+        }
+
+        return bytes_in_use;
+    }
+
     void direct_buffers::create_buffer(std::string name, unsigned long num_bytes) {
-        auto vec = std::vector<unsigned char>();
-        vec.reserve(num_bytes);
-        buffers[name] = vec;
+        buffers[name] = std::make_unique<shared_ring_buffer>(num_bytes);
     }
 
-    std::vector<unsigned char> &direct_buffers::operator[](std::string buffer_name) {
+    shared_ring_buffer &direct_buffers::operator[](std::string buffer_name) {
         auto buffer_pos = buffers.find(buffer_name);
         if(buffer_pos != buffers.end()) {
-            return buffers[buffer_name];
+            return *buffer_pos->second;
         }
 
         throw std::runtime_error("No buffer named " + buffer_name);
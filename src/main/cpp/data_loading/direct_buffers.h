@@ -1,5 +1,5 @@
-/*! 
- * \author gold1 
+/*!
+ * \author gold1
  * \date 19-Jul-17.
  */
 
@@ -7,13 +7,99 @@
 #define RENDERER_DIRECT_BUFFERS_H
 
 #include <string>
-#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace nova {
-/*!
- * \brief Holds all the direct mapped buffers that allow Java nad C++ to talk directly to each other
- */
+    /*!
+     * \brief A block of native memory that Java writes into directly, carved up like a ring
+     *
+     * Java asks for space with #reserve, writes its data at the returned offset through a direct ByteBuffer, then
+     * hands Nova pointers into the buffer. Nova reads the data in place and calls #release when it's done. Space is
+     * reused in the order it was reserved, so one slow consumer holds up everything reserved after it, but reserving
+     * and releasing are both cheap.
+     *
+     * If a reservation is never released, the ring fills up and every later #reserve fails. Callers should fall back to
+     * copying their data when that happens.
+     */
+    class shared_ring_buffer {
+    public:
+        /*!
+         * \brief All reservations are rounded up to a multiple of this many bytes so that they start nicely aligned
+         */
+        static const std::size_t ALIGNMENT = 16;
+
+        /*!
+         * \brief Allocates a ring buffer of the given size
+         *
+         * \param num_bytes How big the ring is. Rounded up to a multiple of ALIGNMENT
+         */
+        explicit shared_ring_buffer(std::size_t num_bytes);
+
+        /*!
+         * \brief Reserves space in the ring. Safe to call from any thread
+         *
+         * \param num_bytes How many bytes to reserve
+         * \return The offset in bytes of the reserved space from the start of the buffer, or -1 if there isn't enough
+         * free space right now
+         */
+        long reserve(std::size_t num_bytes);
+
+        /*!
+         * \brief Gives back the reservation that starts at the given offset. Safe to call from any thread
+         *
+         * \param offset The offset that #reserve returned
+         */
+        void release(long offset);
+
+        /*!
+         * \brief Checks if the given pointer points somewhere inside this buffer
+         */
+        bool contains(const void* ptr) const;
+
+        /*!
+         * \brief Returns the offset of the given pointer from the start of this buffer. The pointer must be inside the
+         * buffer
+         */
+        long offset_of(const void* ptr) const;
+
+        unsigned char* data();
+
+        std::size_t size() const;
+
+        /*!
+         * \brief Returns how many bytes are reserved right now
+         */
+        std::size_t get_bytes_in_use();
+
+    private:
+        struct reservation {
+            std::size_t offset;
+            std::size_t num_bytes;
+            bool released;
+        };
+
+        std::unique_ptr<unsigned char[]> buffer;
+        std::size_t capacity;
+
+        std::mutex lock;
+
+        /*!
+         * \brief Where the next reservation would start if there's room
+         */
+        std::size_t write_offset = 0;
+
+        /*!
+         * \brief All the outstanding reservations, oldest first
+         */
+        std::deque<reservation> reservations;
+    };
+
+    /*!
+     * \brief Holds all the direct mapped buffers that allow Java nad C++ to talk directly to each other
+     */
     class direct_buffers {
     public:
         /*!
@@ -32,10 +118,10 @@ namespace nova {
          * \param buffer_name The name of the buffer to access
          * \return A reference to the requested buffer
          */
-        std::vector<unsigned char> &operator[](std::string buffer_name);
+        shared_ring_buffer &operator[](std::string buffer_name);
 
     private:
-        std::unordered_map<std::string, std::vector<unsigned char>> buffers;
+        std::unordered_map<std::string, std::unique_ptr<shared_ring_buffer>> buffers;
     };
 }
 
@@ -18,6 +18,10 @@ namespace nova {
             std::string fallback_name_str = json["fallback"];
             fallback_name = optional<std::string>(fallback_name_str);
         }
+
+        if(json.find("translucent") != json.end()) {
+            is_translucent = json["translucent"];
+        }
     }
 
     el::base::Writer& operator<<(el::base::Writer& out, const std::vector<shader_line>& lines) {
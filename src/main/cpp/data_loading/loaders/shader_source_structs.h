@@ -41,6 +41,12 @@ namespace nova {
         std::string filter_expression;
         optional<std::string> fallback_name;
 
+        /*!
+         * \brief If the shader's geometry blends with what's behind it, and so has to be drawn back to front after
+         * everything opaque
+         */
+        bool is_translucent = false;
+
         optional<std::shared_ptr<shader_definition>> fallback_def;
 
         std::vector<shader_line> vertex_source;
@@ -11,4 +11,20 @@ namespace nova {
     void aabb::translate(glm::vec3 &delta) {
         center += delta;
     }
+
+    glm::vec3 aabb::get_min() const {
+        return center - extents;
+    }
+
+    glm::vec3 aabb::get_max() const {
+        return center + extents;
+    }
+
+    void aabb::expand_to_include(const aabb& other) {
+        *this = from_min_max(glm::min(get_min(), other.get_min()), glm::max(get_max(), other.get_max()));
+    }
+
+    aabb aabb::from_min_max(const glm::vec3& min, const glm::vec3& max) {
+        return {(min + max) * 0.5f, (max - min) * 0.5f};
+    }
 }
\ No newline at end of file
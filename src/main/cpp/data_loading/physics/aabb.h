@@ -21,6 +21,20 @@ namespace nova {
         glm::vec3 extents;  //!< How far in each direction this AABB reaches
 
         void translate(glm::vec3 &delta);
+
+        glm::vec3 get_min() const;
+
+        glm::vec3 get_max() const;
+
+        /*!
+         * \brief Grows this AABB just enough to hold the other one as well
+         */
+        void expand_to_include(const aabb& other);
+
+        /*!
+         * \brief Makes an AABB from its minimum and maximum corners
+         */
+        static aabb from_min_max(const glm::vec3& min, const glm::vec3& max);
     };
 }
 
@@ -0,0 +1,477 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <easylogging++.h>
+#include "chunk_mesh_cache.h"
+#include "lod_builder.h"
+#include "occluder_builder.h"
+#include "../utils/mapped_file.h"
+
+namespace nova {
+    /*!
+     * \brief "NVMC", as it reads in a hex editor on a little-endian machine
+     */
+    static const std::uint32_t CACHE_MAGIC = 0x434D564E;
+    static const std::size_t HEADER_SIZE = 2 * sizeof(std::uint32_t);
+
+    static const std::uint32_t FLAG_PATCHABLE = 1;
+
+    /*!
+     * \brief The record is a tombstone for a section that was removed. It has no geometry
+     */
+    static const std::uint32_t FLAG_REMOVED = 2;
+
+    /*!
+     * \brief The record is a tombstone for every section that belongs to the parent with the record's ID. Its filter
+     * and position don't mean anything
+     */
+    static const std::uint32_t FLAG_PARENT_REMOVED = 4;
+
+    template<typename T>
+    static void put(std::vector<std::uint8_t>& dst, const T& value) {
+        auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+        dst.insert(dst.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void put_ints(std::vector<std::uint8_t>& dst, const std::vector<int>& ints) {
+        put<std::uint64_t>(dst, ints.size());
+        auto* bytes = reinterpret_cast<const std::uint8_t*>(ints.data());
+        dst.insert(dst.end(), bytes, bytes + ints.size() * sizeof(int));
+    }
+
+    /*!
+     * \brief Reads values out of a record one after another, and remembers if the record ran out
+     */
+    class record_reader {
+    public:
+        record_reader(const std::uint8_t* data, std::size_t size) : data(data), remaining(size) {}
+
+        template<typename T>
+        T get() {
+            T value = {};
+            if(remaining < sizeof(T)) {
+                ok = false;
+                return value;
+            }
+
+            std::memcpy(&value, data, sizeof(T));
+            data += sizeof(T);
+            remaining -= sizeof(T);
+            return value;
+        }
+
+        void get_ints(std::vector<int>& ints) {
+            auto num_ints = get<std::uint64_t>();
+            if(!ok || num_ints > remaining / sizeof(int)) {
+                ok = false;
+                return;
+            }
+
+            ints.resize(static_cast<std::size_t>(num_ints));
+            std::memcpy(ints.data(), data, ints.size() * sizeof(int));
+            data += ints.size() * sizeof(int);
+            remaining -= ints.size() * sizeof(int);
+        }
+
+        void get_string(std::string& str) {
+            auto length = get<std::uint32_t>();
+            if(!ok || length > remaining) {
+                ok = false;
+                return;
+            }
+
+            str.assign(reinterpret_cast<const char*>(data), length);
+            data += length;
+            remaining -= length;
+        }
+
+        bool is_ok() const {
+            return ok;
+        }
+
+    private:
+        const std::uint8_t* data;
+        std::size_t remaining;
+        bool ok = true;
+    };
+
+    /*!
+     * \brief Where a record is in the old file, the ID of the parent it belongs to, and its flags
+     */
+    struct cached_record {
+        const std::uint8_t* data;
+        std::size_t size;
+        std::int32_t id;
+        std::uint32_t flags;
+    };
+
+    /*!
+     * \brief Reads just the section that a record belongs to, its parent ID and its flags. They're at the start of
+     * every record, so this is a lot cheaper than deserializing the whole thing
+     */
+    static bool read_record_key(const std::uint8_t* data, std::size_t size, chunk_section_key& key, std::int32_t& id,
+                                std::uint32_t& flags) {
+        record_reader reader(data, size);
+
+        std::string filter_name;
+        reader.get_string(filter_name);
+        glm::vec3 position;
+        position.x = reader.get<float>();
+        position.y = reader.get<float>();
+        position.z = reader.get<float>();
+
+        // The content hash, bounds and vertex format come between the ID and the flags
+        id = reader.get<std::int32_t>();
+        reader.get<std::uint64_t>();
+        reader.get<glm::vec3>();
+        reader.get<glm::vec3>();
+        reader.get<std::int32_t>();
+        flags = reader.get<std::uint32_t>();
+
+        if(!reader.is_ok()) {
+            return false;
+        }
+
+        key = make_section_key(intern_name(filter_name), position);
+        return true;
+    }
+
+    void chunk_mesh_cache::serialize(const chunk_upload_request& request, std::vector<std::uint8_t>& dst) {
+        const auto& def = request.definition;
+
+        auto filter_name = get_interned_name(request.filter);
+        put<std::uint32_t>(dst, static_cast<std::uint32_t>(filter_name.size()));
+        dst.insert(dst.end(), filter_name.begin(), filter_name.end());
+
+        put<float>(dst, def.position.x);
+        put<float>(dst, def.position.y);
+        put<float>(dst, def.position.z);
+        put<std::int32_t>(dst, def.id);
+        put<std::uint64_t>(dst, request.content_hash);
+        put<glm::vec3>(dst, request.bounds.center);
+        put<glm::vec3>(dst, request.bounds.extents);
+        put<std::int32_t>(dst, def.vertex_format.get_value());
+        put<std::uint32_t>(dst, (request.is_patchable ? FLAG_PATCHABLE : 0) | (request.is_removal ? FLAG_REMOVED : 0) |
+                                (request.is_parent_removal ? FLAG_PARENT_REMOVED : 0));
+        put<std::uint64_t>(dst, request.num_quads);
+
+        put_ints(dst, def.vertex_data);
+        put_ints(dst, def.indices);
+
+        put<std::uint32_t>(dst, static_cast<std::uint32_t>(request.lods.size()));
+        for(const auto& lod : request.lods) {
+            put<std::uint64_t>(dst, lod.num_quads);
+            put_ints(dst, lod.vertex_data);
+        }
+
+        put<std::uint32_t>(dst, static_cast<std::uint32_t>(request.occluders.size()));
+        for(const auto& occluder : request.occluders) {
+            put<glm::vec3>(dst, occluder.center);
+            put<glm::vec3>(dst, occluder.extents);
+        }
+
+        for(auto first_quad : request.facing_ranges.first_quad) {
+            put<std::uint32_t>(dst, first_quad);
+        }
+
+        put<std::uint32_t>(dst, static_cast<std::uint32_t>(request.quad_slots.size()));
+        for(auto slot : request.quad_slots) {
+            put<std::uint16_t>(dst, slot);
+        }
+    }
+
+    bool chunk_mesh_cache::deserialize(const std::uint8_t* data, std::size_t size, chunk_upload_request& request) {
+        record_reader reader(data, size);
+        auto& def = request.definition;
+
+        std::string filter_name;
+        reader.get_string(filter_name);
+        def.position.x = reader.get<float>();
+        def.position.y = reader.get<float>();
+        def.position.z = reader.get<float>();
+        def.id = reader.get<std::int32_t>();
+        request.content_hash = reader.get<std::uint64_t>();
+        request.bounds.center = reader.get<glm::vec3>();
+        request.bounds.extents = reader.get<glm::vec3>();
+        def.vertex_format = format(reader.get<std::int32_t>());
+        auto flags = reader.get<std::uint32_t>();
+        request.is_patchable = (flags & FLAG_PATCHABLE) != 0;
+        request.is_removal = (flags & FLAG_REMOVED) != 0;
+        request.is_parent_removal = (flags & FLAG_PARENT_REMOVED) != 0;
+        request.num_quads = static_cast<std::size_t>(reader.get<std::uint64_t>());
+
+        reader.get_ints(def.vertex_data);
+        reader.get_ints(def.indices);
+
+        auto num_lods = reader.get<std::uint32_t>();
+        if(!reader.is_ok() || num_lods > MAX_CHUNK_LOD_LEVELS) {
+            return false;
+        }
+
+        request.lods.resize(num_lods);
+        for(auto& lod : request.lods) {
+            lod.num_quads = static_cast<std::size_t>(reader.get<std::uint64_t>());
+            reader.get_ints(lod.vertex_data);
+        }
+
+        auto num_occluders = reader.get<std::uint32_t>();
+        if(!reader.is_ok() || num_occluders > MAX_OCCLUDERS_PER_SECTION) {
+            return false;
+        }
+
+        request.occluders.resize(num_occluders);
+        for(auto& occluder : request.occluders) {
+            occluder.center = reader.get<glm::vec3>();
+            occluder.extents = reader.get<glm::vec3>();
+        }
+
+        for(auto& first_quad : request.facing_ranges.first_quad) {
+            first_quad = reader.get<std::uint32_t>();
+        }
+
+        auto num_quad_slots = reader.get<std::uint32_t>();
+        if(!reader.is_ok() || num_quad_slots > MAX_SORTED_QUADS) {
+            return false;
+        }
+
+        request.quad_slots.resize(num_quad_slots);
+        for(auto& slot : request.quad_slots) {
+            slot = reader.get<std::uint16_t>();
+        }
+
+        if(!reader.is_ok()) {
+            return false;
+        }
+
+        request.filter = intern_name(filter_name);
+        request.is_patch = false;
+        request.is_cached = true;
+        return true;
+    }
+
+    bool chunk_mesh_cache::open(const std::string& path) {
+        close();
+
+        // The newest records go into a fresh file, which replaces the old one once it's been read
+        std::lock_guard<std::mutex> lock_guard(lock);
+        generation++;
+        is_loading = false;
+        written_while_loading.clear();
+        parents_removed_while_loading.clear();
+
+        this->path = path;
+        file.open(path + ".tmp", std::ios::binary | std::ios::trunc);
+        if(!file) {
+            LOG(WARNING) << "Could not open chunk mesh cache " << path << ".tmp";
+            return false;
+        }
+
+        const std::uint32_t header[2] = {CACHE_MAGIC, FORMAT_VERSION};
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        is_loading = true;
+        open_for_writing = true;
+        return true;
+    }
+
+    std::size_t chunk_mesh_cache::load(const std::function<void(chunk_upload_request&&)>& on_cached_part,
+                                       const std::function<bool(const chunk_section_key&)>& should_load) {
+        std::string path;
+        std::uint64_t load_generation;
+        {
+            std::lock_guard<std::mutex> lock_guard(lock);
+            if(!is_loading) {
+                return 0;
+            }
+            path = this->path;
+            load_generation = generation;
+        }
+        std::string fresh_path = path + ".tmp";
+
+        std::size_t num_loaded = 0;
+        {
+            mapped_file old_file(path);
+            std::uint32_t header[2] = {};
+            if(old_file.is_open() && old_file.size() >= HEADER_SIZE) {
+                std::memcpy(header, old_file.data(), HEADER_SIZE);
+            }
+
+            // If the cache was closed before we got here, there's no point reading anything
+            bool is_current_version = header[0] == CACHE_MAGIC && header[1] == FORMAT_VERSION;
+            if(open_for_writing && is_current_version) {
+                std::unordered_map<chunk_section_key, cached_record, chunk_section_key_hash> newest;
+
+                // Every section that each parent has had a record for, so that a parent's tombstone doesn't have to
+                // look at every record. Sections that have moved to another parent since are skipped
+                std::unordered_map<std::int32_t, std::vector<chunk_section_key>> sections_by_parent;
+
+                const std::uint8_t* cur = old_file.data() + HEADER_SIZE;
+                const std::uint8_t* end = old_file.data() + old_file.size();
+                while(static_cast<std::size_t>(end - cur) >= sizeof(std::uint32_t)) {
+                    std::uint32_t record_size;
+                    std::memcpy(&record_size, cur, sizeof(record_size));
+                    cur += sizeof(record_size);
+
+                    // Whatever was being written when the game last closed might not have made it
+                    if(record_size > static_cast<std::size_t>(end - cur)) {
+                        break;
+                    }
+
+                    chunk_section_key key;
+                    std::int32_t id;
+                    std::uint32_t flags;
+                    bool is_readable = read_record_key(cur, record_size, key, id, flags);
+                    if(is_readable && (flags & FLAG_PARENT_REMOVED) != 0) {
+                        auto parent_itr = sections_by_parent.find(id);
+                        if(parent_itr != sections_by_parent.end()) {
+                            for(const auto& parent_key : parent_itr->second) {
+                                auto newest_itr = newest.find(parent_key);
+                                if(newest_itr != newest.end() && newest_itr->second.id == id) {
+                                    newest.erase(newest_itr);
+                                }
+                            }
+                            sections_by_parent.erase(parent_itr);
+                        }
+
+                    } else if(is_readable) {
+                        newest[key] = {cur, record_size, id, flags};
+                        sections_by_parent[id].push_back(key);
+                    }
+                    cur += record_size;
+                }
+
+                for(const auto& record : newest) {
+                    // The section was removed after it was cached, and the fresh file doesn't need to remember that
+                    if((record.second.flags & FLAG_REMOVED) != 0) {
+                        continue;
+                    }
+
+                    // Sections that aren't wanted now are still copied into the fresh file, for a later load that wants
+                    // them, but there's no point deserializing them
+                    bool is_wanted = !should_load || should_load(record.first);
+                    chunk_upload_request request;
+                    if(is_wanted && !deserialize(record.second.data, record.second.size, request)) {
+                        continue;
+                    }
+
+                    // Handing the chunk part out while the lock is held means a removal that's written after the check
+                    // is also handed out after the chunk part
+                    std::lock_guard<std::mutex> lock_guard(lock);
+                    if(generation != load_generation || !open_for_writing) {
+                        break;
+                    }
+
+                    if(written_while_loading.count(record.first) > 0 ||
+                       parents_removed_while_loading.count(record.second.id) > 0) {
+                        continue;
+                    }
+
+                    append_record(record.second.data, record.second.size);
+                    if(is_wanted) {
+                        on_cached_part(std::move(request));
+                        num_loaded++;
+                    }
+                }
+
+            } else if(open_for_writing && old_file.is_open()) {
+                LOG(INFO) << "Throwing away chunk mesh cache " << path << " because it's from a different version";
+            }
+        }
+
+        std::lock_guard<std::mutex> lock_guard(lock);
+        if(generation != load_generation) {
+            // The cache was opened again while we were reading, and that load owns the files now
+            return num_loaded;
+        }
+
+        is_loading = false;
+        written_while_loading.clear();
+        parents_removed_while_loading.clear();
+        stats.num_loaded = num_loaded;
+
+        if(!open_for_writing) {
+            // Closed while we were reading, so the old file is still the best we have
+            std::remove(fresh_path.c_str());
+            return num_loaded;
+        }
+
+        file.close();
+        std::remove(path.c_str());
+        if(std::rename(fresh_path.c_str(), path.c_str()) != 0) {
+            LOG(WARNING) << "Could not replace chunk mesh cache " << path;
+            open_for_writing = false;
+            return num_loaded;
+        }
+
+        file.open(path, std::ios::binary | std::ios::app);
+        open_for_writing = file.good();
+
+        LOG(INFO) << "Loaded " << num_loaded << " chunk parts from " << path;
+        return num_loaded;
+    }
+
+    void chunk_mesh_cache::close() {
+        std::lock_guard<std::mutex> lock_guard(lock);
+        open_for_writing = false;
+        if(file.is_open()) {
+            file.close();
+        }
+    }
+
+    bool chunk_mesh_cache::is_open() const {
+        return open_for_writing;
+    }
+
+    void chunk_mesh_cache::write(const chunk_upload_request& request) {
+        if(!open_for_writing || request.is_cached) {
+            return;
+        }
+
+        // Serialize outside the lock so the ingestion workers only wait for each other while writing
+        std::vector<std::uint8_t> record;
+        if(request.is_patch) {
+            // The cached geometry doesn't have the patch in it, so the section stays out of the cache until Minecraft
+            // sends it whole again
+            chunk_upload_request tombstone;
+            tombstone.filter = request.filter;
+            tombstone.is_removal = true;
+            tombstone.definition.position = request.definition.position;
+            tombstone.definition.id = request.definition.id;
+            serialize(tombstone, record);
+
+        } else {
+            serialize(request, record);
+        }
+
+        std::lock_guard<std::mutex> lock_guard(lock);
+        if(!open_for_writing) {
+            return;
+        }
+
+        if(is_loading && request.is_parent_removal) {
+            parents_removed_while_loading.insert(request.definition.id);
+        } else if(is_loading) {
+            written_while_loading.insert(make_section_key(request.filter, request.definition.position));
+        }
+        append_record(record.data(), record.size());
+    }
+
+    chunk_mesh_cache_stats chunk_mesh_cache::get_stats() const {
+        std::lock_guard<std::mutex> lock_guard(lock);
+        return stats;
+    }
+
+    void chunk_mesh_cache::append_record(const std::uint8_t* record, std::size_t size) {
+        auto record_size = static_cast<std::uint32_t>(size);
+        file.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+        file.write(reinterpret_cast<const char*>(record), size);
+
+        stats.num_written++;
+        stats.bytes_written += sizeof(record_size) + size;
+    }
+}
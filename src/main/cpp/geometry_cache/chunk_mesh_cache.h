@@ -0,0 +1,154 @@
+/*!
+ * \brief Keeps converted chunk geometry on disk so that rejoining a world doesn't have to wait for every section to be
+ * meshed again
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_CHUNK_MESH_CACHE_H
+#define RENDERER_CHUNK_MESH_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "chunk_section.h"
+
+namespace nova {
+    /*!
+     * \brief Counters for a chunk_mesh_cache
+     */
+    struct chunk_mesh_cache_stats {
+        /*!
+         * \brief How many chunk parts the last call to open read out of the cache
+         */
+        std::size_t num_loaded;
+        std::size_t num_written;
+        std::size_t bytes_written;
+    };
+
+    /*!
+     * \brief A file of chunk parts, already converted into the format they're uploaded in
+     *
+     * The file is a header followed by one record per chunk part, in binary, in the machine's own byte order. Records
+     * are only ever appended, so a section that's sent again has more than one record and the last one wins. A section
+     * that's removed gets a tombstone record, so a section that became empty isn't brought back by the next load, and
+     * removing every section of a parent ID leaves one tombstone for all of them. A section that's patched gets a
+     * tombstone too, since its record doesn't have the patch in it.
+     * Loading the cache reads the file through a memory mapping, hands the newest record for each section to a callback
+     * unless it's a tombstone, and writes those records to a fresh file, so the file doesn't grow forever.
+     *
+     * Each record holds the chunk part's content_hash. When Minecraft sends a section that was loaded from the cache,
+     * mesh_store compares the hashes and skips the upload if nothing's changed, so the cache never has to be checked
+     * against the world itself.
+     *
+     * Everything here can be called from any thread
+     */
+    class chunk_mesh_cache {
+    public:
+        /*!
+         * \brief Changed whenever the record layout or the vertex formats change. Caches from other versions are thrown
+         * away
+         */
+        static const std::uint32_t FORMAT_VERSION = 6;
+
+        chunk_mesh_cache() = default;
+
+        chunk_mesh_cache(const chunk_mesh_cache&) = delete;
+        chunk_mesh_cache& operator=(const chunk_mesh_cache&) = delete;
+
+        /*!
+         * \brief Starts writing to the cache at the given path. Call #load afterwards to read what's already in it
+         *
+         * This is cheap, so it can be called right when the world is joined. Chunk parts and removals that are written
+         * from then on take priority over the records in the file, even if they're written before #load gets to them.
+         * If another cache is open, it's closed first
+         *
+         * \param path The cache file. It's made if it doesn't exist, but the directory it's in has to
+         * \return False if the cache couldn't be opened
+         */
+        bool open(const std::string& path);
+
+        /*!
+         * \brief Reads the cache that #open started, then goes back to appending to it
+         *
+         * \param on_cached_part Called with the newest cached version of each section that hasn't been written or
+         * removed since #open. It's called with the cache's lock held, so that a removal can't be handed out after the
+         * chunk part it removes, which means it has to be quick and can't use the cache
+         * \param should_load If given, only the sections it returns true for are handed to on_cached_part. The others
+         * stay in the cache for next time
+         * \return How many chunk parts were handed out
+         */
+        std::size_t load(const std::function<void(chunk_upload_request&&)>& on_cached_part,
+                         const std::function<bool(const chunk_section_key&)>& should_load = nullptr);
+
+        /*!
+         * \brief Stops writing to the cache. The file stays on disk for the next open
+         */
+        void close();
+
+        bool is_open() const;
+
+        /*!
+         * \brief Appends a chunk part or a removal to the cache, if it's open. A patch is written as a removal of the
+         * section it patches
+         */
+        void write(const chunk_upload_request& request);
+
+        chunk_mesh_cache_stats get_stats() const;
+
+        /*!
+         * \brief Adds the record for a chunk part to the end of dst. The record doesn't include its own size
+         */
+        static void serialize(const chunk_upload_request& request, std::vector<std::uint8_t>& dst);
+
+        /*!
+         * \brief Reads a record that serialize made
+         *
+         * \param data The record
+         * \param size The size of the record in bytes
+         * \param request Filled in with the chunk part
+         * \return False if the record is cut short or doesn't make sense
+         */
+        static bool deserialize(const std::uint8_t* data, std::size_t size, chunk_upload_request& request);
+
+    private:
+        mutable std::mutex lock;
+
+        std::ofstream file;
+        std::string path;
+        std::atomic<bool> open_for_writing{false};
+
+        /*!
+         * \brief Sections that have been written or removed since #open, so that their older cached records aren't
+         * handed out or copied into the fresh file after them
+         */
+        std::unordered_set<chunk_section_key, chunk_section_key_hash> written_while_loading;
+
+        /*!
+         * \brief Parents whose sections have all been removed since #open, so that none of their cached records are
+         * handed out after the removal
+         */
+        std::unordered_set<std::int32_t> parents_removed_while_loading;
+        bool is_loading = false;
+
+        /*!
+         * \brief Counts calls to #open, so that a #load that's overtaken by another #open stops touching the files
+         */
+        std::uint64_t generation = 0;
+
+        chunk_mesh_cache_stats stats = {};
+
+        /*!
+         * \brief Appends a record and its size. The lock must be held
+         */
+        void append_record(const std::uint8_t* record, std::size_t size);
+    };
+}
+
+#endif //RENDERER_CHUNK_MESH_CACHE_H
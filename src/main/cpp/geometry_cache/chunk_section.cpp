@@ -0,0 +1,32 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cmath>
+#include "chunk_section.h"
+#include "../mc_interface/mc_objects.h"
+
+namespace nova {
+    bool chunk_section_key::operator==(const chunk_section_key& other) const {
+        return section == other.section && filter == other.filter;
+    }
+
+    std::size_t chunk_section_key_hash::operator()(const chunk_section_key& key) const {
+        // Large primes so that neighboring sections land in different buckets
+        std::size_t hash = static_cast<std::size_t>(key.section.x) * 73856093u;
+        hash ^= static_cast<std::size_t>(key.section.y) * 19349663u;
+        hash ^= static_cast<std::size_t>(key.section.z) * 83492791u;
+        hash ^= static_cast<std::size_t>(key.filter) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    chunk_section_key make_section_key(name_id filter, const glm::vec3& position) {
+        glm::ivec3 section = {
+                static_cast<int>(std::floor(position.x / CHUNK_WIDTH)),
+                static_cast<int>(std::floor(position.y / CHUNK_SECTION_HEIGHT)),
+                static_cast<int>(std::floor(position.z / CHUNK_DEPTH))
+        };
+        return {section, filter};
+    }
+}
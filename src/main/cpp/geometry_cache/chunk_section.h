@@ -0,0 +1,134 @@
+/*!
+ * \brief How chunk sections are identified, and the chunk parts that get passed around on their way to the GPU
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_CHUNK_SECTION_H
+#define RENDERER_CHUNK_SECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh_definition.h"
+#include "quad_facing.h"
+#include "../utils/name_table.h"
+#include "../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief Identifies the geometry of one chunk section for one filter
+     *
+     * Chunk sections are 16x16x16 blocks, so the section coordinate is the block position divided by 16
+     */
+    struct chunk_section_key {
+        glm::ivec3 section;
+        name_id filter;
+
+        bool operator==(const chunk_section_key& other) const;
+    };
+
+    struct chunk_section_key_hash {
+        std::size_t operator()(const chunk_section_key& key) const;
+    };
+
+    /*!
+     * \brief Builds the key for the chunk section at the given block position
+     *
+     * \param filter The interned name of the filter that the geometry belongs to
+     * \param position The position of the chunk section's minimum corner, in blocks
+     */
+    chunk_section_key make_section_key(name_id filter, const glm::vec3& position);
+
+    /*!
+     * \brief One simplified version of a chunk part. Always a plain list of quads
+     */
+    struct chunk_lod {
+        std::vector<int> vertex_data;
+        std::size_t num_quads;
+    };
+
+    /*!
+     * \brief A chunk part that's waiting to be sent to the GPU, along with the name of the filter it came from
+     *
+     * Removals go through the same queue as additions so that they happen in the order Minecraft sent them, and so
+     * that only the render thread ever touches the render_objects
+     */
+    struct chunk_upload_request {
+        name_id filter;
+        mesh_definition definition;
+        bool is_removal;
+
+        /*!
+         * \brief If this isn't zero, the geometry is a plain list of this many quads. Its indices have been thrown away
+         * and it's drawn with the shared quad index buffer instead
+         */
+        std::size_t num_quads = 0;
+
+        /*!
+         * \brief A hash of everything Minecraft sent for this chunk part, so that resending the same thing can be
+         * skipped
+         */
+        std::uint64_t content_hash = 0;
+
+        /*!
+         * \brief The smallest box around the geometry, in world space. Worked out from the vertices on the ingestion
+         * workers. For a patch, it's the box around the new quads
+         */
+        aabb bounds = {};
+
+        /*!
+         * \brief Simplified versions of the chunk part for drawing from far away, coarsest last. Built on the ingestion
+         * workers, in the same vertex format as the full detail geometry
+         */
+        std::vector<chunk_lod> lods;
+
+        /*!
+         * \brief Big flat rectangles of solid faces in the geometry, in world space, for occlusion culling. Only built
+         * when occlusion culling is on
+         */
+        std::vector<aabb> occluders;
+
+        /*!
+         * \brief Where the quads facing each way are, if the quads have been sorted by facing. Only sorted when facing
+         * culling is on
+         */
+        quad_facing_ranges facing_ranges = {};
+
+        /*!
+         * \brief For a patchable chunk part whose quads have been sorted by facing, where each of the quads Minecraft
+         * sent ended up
+         */
+        std::vector<std::uint16_t> quad_slots;
+
+        /*!
+         * \brief True if the geometry is a plain list of exactly the quads Minecraft sent, in the order it sent them, so
+         * that patches can be applied to it
+         */
+        bool is_patchable = false;
+
+        /*!
+         * \brief If true, this replaces some quads of a chunk part that was sent before. The definition holds the new
+         * quads and num_quads says how many there are
+         */
+        bool is_patch = false;
+        std::size_t first_patched_quad = 0;
+        std::size_t num_replaced_quads = 0;
+
+        /*!
+         * \brief If true, this was loaded from the chunk mesh cache rather than sent by Minecraft. It never replaces
+         * anything that Minecraft has sent
+         */
+        bool is_cached = false;
+
+        /*!
+         * \brief If true, this is a removal for every chunk section whose parent ID is the definition's ID, in every
+         * filter. The filter and position don't mean anything
+         */
+        bool is_parent_removal = false;
+    };
+}
+
+#endif //RENDERER_CHUNK_SECTION_H
@@ -0,0 +1,204 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <glm/glm.hpp>
+#include "lod_builder.h"
+#include "vertex_kernels.h"
+#include "../mc_interface/mc_objects.h"
+
+namespace nova {
+    /*!
+     * \brief The highest upward-facing quad in one column of a section
+     */
+    struct lod_column {
+        float height = -std::numeric_limits<float>::max();
+
+        /*!
+         * \brief The first vertex of the quad. Its color, UVs and lightmap are copied onto the column's quads
+         */
+        const int* source = nullptr;
+
+        bool has_surface() const {
+            return source != nullptr;
+        }
+    };
+
+    static glm::vec3 read_position(const int* vertex) {
+        float position[3];
+        std::memcpy(position, vertex, sizeof(position));
+        return {position[0], position[1], position[2]};
+    }
+
+    static glm::vec3 quad_normal(const int* quad) {
+        glm::vec3 p0 = read_position(quad);
+        glm::vec3 p1 = read_position(quad + MC_VERTEX_SIZE_INTS);
+        glm::vec3 p2 = read_position(quad + 2 * MC_VERTEX_SIZE_INTS);
+
+        // Same winding as compact_mc_vertices uses, so the quads we make face the same way as Minecraft's do
+        return glm::cross(p1 - p0, p2 - p0);
+    }
+
+    /*!
+     * \brief Writes one quad. The corners are flipped if they don't wind towards the given facing
+     *
+     * \param corners The quad's corners, going around its edge
+     * \param facing Which way the quad should face
+     * \param source The first of four Minecraft vertices to copy everything but the positions from
+     * \param dst The vertex data to add the quad to
+     */
+    static void emit_quad(glm::vec3 corners[VERTICES_PER_QUAD], const glm::vec3& facing, const int* source,
+                          std::vector<int>& dst) {
+        glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        if(glm::dot(normal, facing) < 0) {
+            std::swap(corners[1], corners[3]);
+        }
+
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            int vertex[MC_VERTEX_SIZE_INTS];
+            const float position[3] = {corners[i].x, corners[i].y, corners[i].z};
+            std::memcpy(vertex, position, sizeof(position));
+            std::memcpy(vertex + 3, source + i * MC_VERTEX_SIZE_INTS + 3, (MC_VERTEX_SIZE_INTS - 3) * sizeof(int));
+
+            dst.insert(dst.end(), vertex, vertex + MC_VERTEX_SIZE_INTS);
+        }
+    }
+
+    int get_lod_scale(std::size_t level) {
+        return 1 << level;
+    }
+
+    std::vector<int> build_lod_vertices(const int* src, std::size_t num_vertices, int scale) {
+        std::vector<int> lod_vertices;
+        if(num_vertices == 0 || num_vertices % VERTICES_PER_QUAD != 0 || scale <= 0) {
+            return lod_vertices;
+        }
+
+        const int columns_per_side = std::max(CHUNK_WIDTH / scale, 1);
+        std::vector<lod_column> columns(static_cast<std::size_t>(columns_per_side * columns_per_side));
+
+        auto column_coordinate = [&](float block_coordinate) {
+            auto column = static_cast<int>(std::floor(block_coordinate / scale));
+            return std::min(std::max(column, 0), columns_per_side - 1);
+        };
+
+        for(std::size_t quad = 0; quad < num_vertices / VERTICES_PER_QUAD; quad++) {
+            const int* quad_vertices = src + quad * VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+
+            // Only count quads that are mostly facing up. Sides and undersides can't be seen from far away
+            glm::vec3 normal = quad_normal(quad_vertices);
+            if(normal.y <= 0 || normal.y * normal.y < 0.5f * glm::dot(normal, normal)) {
+                continue;
+            }
+
+            glm::vec3 center(0);
+            float top = -std::numeric_limits<float>::max();
+            for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+                glm::vec3 position = read_position(quad_vertices + i * MC_VERTEX_SIZE_INTS);
+                center += position;
+                top = std::max(top, position.y);
+            }
+            center /= static_cast<float>(VERTICES_PER_QUAD);
+
+            auto& column = columns[column_coordinate(center.x) + column_coordinate(center.z) * columns_per_side];
+            if(top > column.height) {
+                column.height = top;
+                column.source = quad_vertices;
+            }
+        }
+
+        float lowest_height = std::numeric_limits<float>::max();
+        for(const auto& column : columns) {
+            if(column.has_surface()) {
+                lowest_height = std::min(lowest_height, column.height);
+            }
+        }
+
+        if(lowest_height == std::numeric_limits<float>::max()) {
+            return lod_vertices;
+        }
+
+        const glm::ivec2 neighbor_offsets[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+        for(int z = 0; z < columns_per_side; z++) {
+            for(int x = 0; x < columns_per_side; x++) {
+                const auto& column = columns[x + z * columns_per_side];
+                if(!column.has_surface()) {
+                    continue;
+                }
+
+                auto x0 = static_cast<float>(x * scale);
+                auto z0 = static_cast<float>(z * scale);
+                auto x1 = x0 + scale;
+                auto z1 = z0 + scale;
+                float height = column.height;
+
+                glm::vec3 top[VERTICES_PER_QUAD] = {{x0, height, z0}, {x0, height, z1}, {x1, height, z1}, {x1, height, z0}};
+                emit_quad(top, {0, 1, 0}, column.source, lod_vertices);
+
+                for(const auto& offset : neighbor_offsets) {
+                    int neighbor_x = x + offset.x;
+                    int neighbor_z = z + offset.y;
+
+                    // Walls go down to shorter neighbors. At the edge of the section there's no neighbor to look at,
+                    // so a skirt goes down to the lowest column instead
+                    float bottom;
+                    if(neighbor_x < 0 || neighbor_x >= columns_per_side || neighbor_z < 0 || neighbor_z >= columns_per_side) {
+                        bottom = lowest_height;
+                    } else {
+                        const auto& neighbor = columns[neighbor_x + neighbor_z * columns_per_side];
+                        if(!neighbor.has_surface()) {
+                            continue;
+                        }
+                        bottom = neighbor.height;
+                    }
+
+                    if(bottom >= height) {
+                        continue;
+                    }
+
+                    // The edge of this column that's shared with the neighbor
+                    float edge_x0 = offset.x > 0 ? x1 : x0;
+                    float edge_x1 = offset.x < 0 ? x0 : x1;
+                    float edge_z0 = offset.y > 0 ? z1 : z0;
+                    float edge_z1 = offset.y < 0 ? z0 : z1;
+
+                    glm::vec3 wall[VERTICES_PER_QUAD] = {
+                            {edge_x0, bottom, edge_z0},
+                            {edge_x0, height, edge_z0},
+                            {edge_x1, height, edge_z1},
+                            {edge_x1, bottom, edge_z1}
+                    };
+                    emit_quad(wall, glm::vec3(offset.x, 0, offset.y), column.source, lod_vertices);
+                }
+            }
+        }
+
+        return lod_vertices;
+    }
+
+    std::size_t select_lod_level(std::size_t current_level, std::size_t num_levels, float distance,
+                                 const lod_settings& settings) {
+        std::size_t level = std::min(current_level, num_levels);
+
+        // Level N starts at base_distance * 2^(N - 1)
+        auto switch_distance = [&](std::size_t level) {
+            return settings.base_distance * static_cast<float>(1 << (level - 1));
+        };
+
+        while(level < num_levels && distance > switch_distance(level + 1) * (1 + settings.hysteresis)) {
+            level++;
+        }
+
+        while(level > 0 && distance < switch_distance(level) * (1 - settings.hysteresis)) {
+            level--;
+        }
+
+        return level;
+    }
+}
@@ -0,0 +1,77 @@
+/*!
+ * \brief Functions that make and pick simplified versions of chunk sections, for drawing far away chunks
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_LOD_BUILDER_H
+#define RENDERER_LOD_BUILDER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief How many simplified versions a chunk section can have, not counting the full detail one
+     *
+     * Level 1 merges 2x2 columns of blocks, level 2 merges 4x4, and level 3 merges 8x8
+     */
+    const std::size_t MAX_CHUNK_LOD_LEVELS = 3;
+
+    /*!
+     * \brief Returns how many blocks wide each column of the given LOD level is
+     */
+    int get_lod_scale(std::size_t level);
+
+    /*!
+     * \brief Builds a heightmap-style version of a chunk section out of Minecraft's 7-int vertices
+     *
+     * The section is split into columns that are `scale` blocks wide. Each column gets one upward-facing quad at the
+     * height of the highest upward-facing quad in it, with that quad's color, UVs and lightmap stretched over the whole
+     * column. Walls are added where a column is taller than its neighbor, and skirts are hung off the edges of the
+     * section so that neighboring sections at different levels don't leave cracks.
+     *
+     * Anything that isn't a list of quads, or that has no upward-facing quads, gives back no vertices
+     *
+     * \param src The Minecraft vertices, relative to the section's minimum corner. Must hold
+     * num_vertices * MC_VERTEX_SIZE_INTS ints
+     * \param num_vertices The number of vertices in src
+     * \param scale How many blocks wide each column is. Should divide 16
+     * \return A list of quads in Minecraft's vertex format, four vertices per quad
+     */
+    std::vector<int> build_lod_vertices(const int* src, std::size_t num_vertices, int scale);
+
+    /*!
+     * \brief Controls when chunk sections switch between levels of detail
+     */
+    struct lod_settings {
+        /*!
+         * \brief How far from the camera, in blocks, a section switches from full detail to LOD level 1. Each level
+         * after that starts at twice the distance of the one before it
+         */
+        float base_distance = 128;
+
+        /*!
+         * \brief How far past a switching distance, as a fraction of it, the camera has to be before a section switches
+         *
+         * A section switches to a coarser level at distance * (1 + hysteresis) and back at distance * (1 - hysteresis),
+         * so a camera that sits right on a switching distance doesn't make the section flicker between levels
+         */
+        float hysteresis = 0.1f;
+    };
+
+    /*!
+     * \brief Picks the level of detail that something at the given distance should be drawn with
+     *
+     * \param current_level The level that the thing was drawn with last frame. 0 is full detail
+     * \param num_levels How many simplified versions the thing has
+     * \param distance How far the thing is from the camera
+     * \param settings The switching distances
+     * \return The level to draw with this frame. 0 is full detail
+     */
+    std::size_t select_lod_level(std::size_t current_level, std::size_t num_levels, float distance,
+                                 const lod_settings& settings);
+}
+
+#endif //RENDERER_LOD_BUILDER_H
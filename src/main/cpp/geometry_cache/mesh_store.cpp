@@ -9,12 +9,34 @@
 #include <easylogging++.h>
 #include <regex>
 #include <iomanip>
+#include <cmath>
+#include <chrono>
+#include <tuple>
+#include <cctype>
 #include "mesh_store.h"
+#include "vertex_kernels.h"
+#include "lod_builder.h"
+#include "quad_merger.h"
+#include "../utils/hashing.h"
+#include "../utils/utils.h"
 #include "../../../render/nova_renderer.h"
 
 namespace nova {
-    std::vector<render_object>& mesh_store::get_meshes_for_shader(std::string shader_name) {
-        return renderables_grouped_by_shader[shader_name];
+    render_object_bucket& mesh_store::get_meshes_for_shader(const std::string& shader_name) {
+        return get_meshes_for_shader(intern_name(shader_name));
+    }
+
+    render_object_bucket& mesh_store::get_meshes_for_shader(name_id shader_name) {
+        if(shader_name >= renderables_grouped_by_shader.size()) {
+            renderables_grouped_by_shader.resize(shader_name + 1);
+        }
+
+        auto& bucket = renderables_grouped_by_shader[shader_name];
+        if(!bucket) {
+            bucket = std::make_unique<render_object_bucket>();
+        }
+
+        return *bucket;
     }
 
     void mesh_store::add_gui_buffers(mc_gui_geometry* command) {
@@ -54,7 +76,8 @@ namespace nova {
         gui.color_texture = command->atlas_name;
 
         // TODO: Something more intelligent
-        renderables_grouped_by_shader["gui"].push_back(std::move(gui));
+        static const name_id gui_name = intern_name("gui");
+        get_meshes_for_shader(gui_name).insert(std::move(gui));
     }
 
     void mesh_store::remove_gui_render_objects() {
@@ -62,91 +85,882 @@ namespace nova {
     }
 
     void mesh_store::remove_render_objects(std::function<bool(render_object&)> filter) {
-        for(auto& group : renderables_grouped_by_shader) {
-            auto removed_elements = std::remove_if(group.second.begin(), group.second.end(), filter);
-            group.second.erase(removed_elements, group.second.end());
+        for(std::size_t group_idx = 0; group_idx < renderables_grouped_by_shader.size(); group_idx++) {
+            if(!renderables_grouped_by_shader[group_idx]) {
+                continue;
+            }
+
+            auto shader_name = static_cast<name_id>(group_idx);
+            auto& objects = *renderables_grouped_by_shader[group_idx];
+            for(std::size_t i = 0; i < objects.size(); i++) {
+                auto& obj = objects[i];
+                if(!filter(obj)) {
+                    continue;
+                }
+
+                auto handle = objects.get_handle(i);
+                if(obj.type == geometry_type::block) {
+                    auto key = make_section_key(shader_name, obj.position);
+                    auto index_itr = chunk_section_index.find(key);
+                    if(index_itr != chunk_section_index.end() && index_itr->second.handle == handle) {
+                        chunk_section_index.erase(index_itr);
+                        forget_section_parent(obj.parent_id, key);
+                    }
+                }
+
+                pending_removals.emplace_back(shader_name, handle);
+            }
         }
     }
 
-    void mesh_store::upload_new_geometry() {
-        chunk_parts_to_upload_lock.lock();
-        while(!chunk_parts_to_upload.empty()) {
-            const auto& entry = chunk_parts_to_upload.front();
-            const auto& def = std::get<1>(entry);
+    void mesh_store::flush_removals() {
+        for(const auto& removal : pending_removals) {
+            // The same render_object can be removed twice in one frame, e.g. by removing a chunk and then all the
+            // chunks with its parent. The second removal has a stale handle and does nothing
+            if(!get_meshes_for_shader(removal.first).erase(removal.second)) {
+                num_stale_removals++;
+            }
+        }
 
-            render_object obj = {};
-            obj.geometry = std::make_unique<gl_mesh>(def);
-            obj.type = geometry_type::block;
-            obj.name = "chunk";
-            obj.parent_id = def.id;
-            obj.color_texture = "block_color";
-            obj.position = def.position;
-            obj.bounding_box.center = {def.position.x+8,def.position.y+8,def.position.z+8};
-            obj.bounding_box.extents = {16, 16, 16};   // TODO: Make these values come from Minecraft
-            obj.needs_deletion=false;
-            const std::string& shader_name = std::get<0>(entry);
-            renderables_grouped_by_shader[shader_name].push_back(std::move(obj));
+        if(!pending_removals.empty()) {
+            LOG(TRACE) << "Removed " << pending_removals.size() << " render objects. " << num_stale_removals
+                       << " stale removals so far";
+        }
+        pending_removals.clear();
+    }
+
+    void mesh_store::upload_new_geometry(camera& player_camera) {
+        section_connectivity_update connectivity_update;
+        while(section_connectivity_updates.try_pop(connectivity_update)) {
+            if(connectivity_update.is_reset) {
+                section_visibility.clear();
+            } else {
+                section_visibility.set_connectivity(connectivity_update.section, connectivity_update.connectivity);
+            }
+        }
+
+        drain_upload_queue();
+        flush_removals();
+
+        // Fill in some of the holes that removed chunk parts left behind, before new chunk parts take up more space
+        geometry_pool.defragment(defragment_budget_bytes.load());
+
+        if(pending_chunk_uploads.empty()) {
+            return;
+        }
 
-            chunk_parts_to_upload.pop();
+        upload_order.clear();
+        for(const auto& entry : pending_chunk_uploads) {
+            aabb bounds = entry.second.bounds;
+
+            glm::vec3 to_camera = bounds.center - player_camera.position;
+            bool is_invisible = !player_camera.has_object_in_frustum(bounds);
+            upload_order.push_back({is_invisible, glm::dot(to_camera, to_camera), &entry.first});
         }
-        chunk_parts_to_upload_lock.unlock();
+        std::sort(upload_order.begin(), upload_order.end(), [](const upload_priority& a, const upload_priority& b) {
+            return std::tie(a.is_invisible, a.distance_squared) < std::tie(b.is_invisible, b.distance_squared);
+        });
+
+        std::size_t budget_bytes = upload_budget_bytes;
+        float budget_milliseconds = upload_budget_milliseconds;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::size_t bytes_uploaded = 0;
+        std::size_t num_uploaded = 0;
+
+        for(const auto& item : upload_order) {
+            auto pending_itr = pending_chunk_uploads.find(*item.key);
+            const auto& def = pending_itr->second.definition;
+            std::size_t num_bytes = (def.vertex_data.size() + def.indices.size()) * sizeof(int);
+            for(const auto& lod : pending_itr->second.lods) {
+                num_bytes += lod.vertex_data.size() * sizeof(int);
+            }
+
+            if(num_uploaded > 0) {
+                std::chrono::duration<float, std::milli> time_spent = std::chrono::high_resolution_clock::now() - start_time;
+                if(bytes_uploaded + num_bytes > budget_bytes || time_spent.count() > budget_milliseconds) {
+                    break;
+                }
+            }
+
+            upload_chunk_part(pending_itr->first, pending_itr->second);
+            bytes_uploaded += num_bytes;
+            num_uploaded++;
+
+            pending_chunk_uploads.erase(pending_itr);
+        }
+
+        LOG(TRACE) << "Uploaded " << num_uploaded << " chunk parts (" << bytes_uploaded << " bytes), "
+                   << pending_chunk_uploads.size() << " still waiting";
     }
 
-    void mesh_store::remove_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk) {
-        mesh_definition def = {};
+    void mesh_store::drain_upload_queue() {
+        while(chunk_parts_to_upload.pop_batch(upload_batch, upload_batch_size) > 0) {
+            for(auto& entry : upload_batch) {
+                if(entry.is_parent_removal) {
+                    remove_chunk_parent(entry.definition.id);
+                    continue;
+                }
 
-        def.position = {chunk.x, chunk.y, chunk.z};
-        def.id = chunk.id;
+                auto key = make_section_key(entry.filter, entry.definition.position);
 
-        try {
-            if(renderables_grouped_by_shader.find(filter_name) != renderables_grouped_by_shader.end()) {
-                auto& group = renderables_grouped_by_shader.at(filter_name);
-                for(int i=0;i<group.size();i++) {
-                    bool t=(static_cast<int>(group[i].position.x) == static_cast<int>(def.position.x)) &&
-                           (static_cast<int>(group[i].position.y) == static_cast<int>(def.position.y)) &&
-                           (static_cast<int>(group[i].position.z) == static_cast<int>(def.position.z));
-                    if(t){
-                        group[i].needs_deletion=true;
-                    }
+                if(entry.is_removal) {
+                    pending_chunk_uploads.erase(key);
+                    remove_chunk_section(key);
+                    continue;
+                }
+
+                if(entry.is_patch) {
+                    apply_chunk_patch(key, entry);
+                    continue;
+                }
+
+                // Minecraft got there first, and what it sent is newer than anything in the cache
+                if(entry.is_cached && (pending_chunk_uploads.count(key) > 0 || chunk_section_index.count(key) > 0)) {
+                    continue;
+                }
+
+                // If Minecraft resent exactly what's already on the GPU, there's nothing to do. Anything older that's
+                // still waiting would be replaced by this anyway, so it can go too
+                auto resident_itr = chunk_section_index.find(key);
+                if(resident_itr != chunk_section_index.end() && resident_itr->second.content_hash == entry.content_hash) {
+                    pending_chunk_uploads.erase(key);
+                    num_skipped_chunk_uploads++;
+                    continue;
                 }
+
+                pending_chunk_uploads[key] = std::move(entry);
             }
-        } catch(std::exception& e) {
-            LOG(ERROR)<<"REMOVING CHUNK ERROR: " << e.what();
+
+            upload_batch.clear();
         }
     }
 
-    void mesh_store::add_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk) {
-        mesh_definition def = {};
-        auto& vertex_data = def.vertex_data;
+    static std::size_t get_quad_size_ints(format vertex_format) {
+        if(vertex_format == format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT) {
+            return VERTICES_PER_QUAD * COMPACT_VERTEX_SIZE_INTS;
+        }
+
+        return VERTICES_PER_QUAD * EXPANDED_VERTEX_SIZE_INTS;
+    }
+
+    /*!
+     * \brief Splices a patch into a chunk part that hasn't been uploaded yet
+     *
+     * \return False if the chunk part can't be patched or the patch is out of range
+     */
+    static bool patch_pending_chunk_part(chunk_upload_request& pending, const chunk_upload_request& patch) {
+        auto& def = pending.definition;
+        if(!pending.is_patchable || def.vertex_format != patch.definition.vertex_format) {
+            return false;
+        }
+
+        std::size_t first_quad = patch.first_patched_quad;
+        std::size_t num_removed = patch.num_replaced_quads;
+        if(first_quad > pending.num_quads || num_removed > pending.num_quads - first_quad) {
+            return false;
+        }
+
+        std::size_t quad_size_ints = get_quad_size_ints(def.vertex_format);
+
+        // The patch is numbered by the order Minecraft sent the quads in, so the facing sort has to be undone first
+        if(!pending.quad_slots.empty()) {
+            std::vector<int> unsorted(def.vertex_data.size());
+            for(std::size_t quad = 0; quad < pending.quad_slots.size(); quad++) {
+                auto sorted_quad = def.vertex_data.begin() + pending.quad_slots[quad] * quad_size_ints;
+                std::copy(sorted_quad, sorted_quad + quad_size_ints, unsorted.begin() + quad * quad_size_ints);
+            }
+            def.vertex_data = std::move(unsorted);
+            pending.quad_slots = std::vector<std::uint16_t>();
+        }
+        pending.facing_ranges = {};
+
+        auto first = def.vertex_data.begin() + first_quad * quad_size_ints;
+        first = def.vertex_data.erase(first, first + num_removed * quad_size_ints);
+        def.vertex_data.insert(first, patch.definition.vertex_data.begin(), patch.definition.vertex_data.end());
+
+        pending.num_quads = pending.num_quads - num_removed + patch.num_quads;
+
+        // Working out how much the removed quads shrank the bounds would mean looking at every quad, so the bounds only
+        // ever grow. They shrink back the next time the section is sent whole
+        if(patch.num_quads > 0) {
+            pending.bounds.expand_to_include(patch.bounds);
+        }
+
+        // This no longer matches anything Minecraft has sent whole. The simplified versions are left alone until the
+        // section is sent whole again, since a block or two doesn't show up from that far away
+        pending.content_hash = 0;
+
+        // The patch may have knocked a hole in an occluder, and it's cheaper to stop trusting them than to rebuild them
+        pending.occluders.clear();
+        return true;
+    }
+
+    void mesh_store::apply_chunk_patch(const chunk_section_key& key, const chunk_upload_request& patch) {
+        if(!patch.is_patchable) {
+            fail_chunk_patch(patch);
+            return;
+        }
+
+        auto pending_itr = pending_chunk_uploads.find(key);
+        if(pending_itr != pending_chunk_uploads.end()) {
+            if(patch_pending_chunk_part(pending_itr->second, patch)) {
+                patch_stats.num_applied_before_upload++;
+
+            } else {
+                // Later patches would be numbered against geometry we don't have
+                pending_itr->second.is_patchable = false;
+                fail_chunk_patch(patch);
+            }
+            return;
+        }
+
+        if(patch_resident_chunk_section(key, patch)) {
+            patch_stats.num_applied_in_place++;
+            return;
+        }
+
+        auto index_itr = chunk_section_index.find(key);
+        if(index_itr != chunk_section_index.end()) {
+            index_itr->second.layout = quad_layout();
+        }
+        fail_chunk_patch(patch);
+    }
+
+    bool mesh_store::patch_resident_chunk_section(const chunk_section_key& key, const chunk_upload_request& patch) {
+        auto index_itr = chunk_section_index.find(key);
+        if(index_itr == chunk_section_index.end()) {
+            return false;
+        }
+
+        auto& section = index_itr->second;
+        auto* obj = get_meshes_for_shader(key.filter).get(section.handle);
+        if(obj == nullptr || !obj->geometry || obj->geometry->get_format() != patch.definition.vertex_format) {
+            return false;
+        }
+
+        patch_writes.clear();
+        if(!section.layout.splice(patch.first_patched_quad, patch.num_replaced_quads, patch.num_quads, patch_writes)) {
+            return false;
+        }
+
+        std::size_t quad_size_ints = get_quad_size_ints(patch.definition.vertex_format);
+        const auto& new_vertices = patch.definition.vertex_data;
+        std::vector<int> degenerate_quads;
+
+        // Neighboring slots that get neighboring new quads, or that are all being freed, go in one write
+        for(std::size_t i = 0; i < patch_writes.size();) {
+            const auto& first = patch_writes[i];
+            std::size_t num_quads = 1;
+            while(i + num_quads < patch_writes.size()) {
+                const auto& next = patch_writes[i + num_quads];
+                bool same_run = next.slot == first.slot + num_quads &&
+                        (first.source_quad < 0 ? next.source_quad < 0
+                                               : next.source_quad == first.source_quad + static_cast<long>(num_quads));
+                if(!same_run) {
+                    break;
+                }
+                num_quads++;
+            }
+
+            const int* data;
+            if(first.source_quad < 0) {
+                // All zeros puts every corner in the same place, so the quad doesn't cover any pixels
+                degenerate_quads.resize(std::max(degenerate_quads.size(), num_quads * quad_size_ints), 0);
+                data = degenerate_quads.data();
+            } else {
+                data = &new_vertices[first.source_quad * quad_size_ints];
+            }
+
+            obj->geometry->write_quads(first.slot, data, num_quads);
+            patch_stats.bytes_written += num_quads * quad_size_ints * sizeof(int);
+
+            i += num_quads;
+        }
+
+        obj->geometry->set_num_quads(section.layout.get_num_slots_to_draw());
+
+        // Like with a pending chunk part, the bounds only grow
+        if(patch.num_quads > 0) {
+            aabb new_bounds = obj->bounding_box;
+            new_bounds.expand_to_include(patch.bounds);
+            get_meshes_for_shader(key.filter).set_bounds(section.handle, new_bounds);
+        }
+
+        // The section no longer matches anything Minecraft has sent whole. Like with a pending chunk part, the
+        // simplified versions stay as they are
+        section.content_hash = 0;
+        obj->occluders.clear();
+
+        // The new quads went wherever there was room, not into the range for their facing
+        get_meshes_for_shader(key.filter).set_facing_ranges(section.handle, {});
+        return true;
+    }
+
+    void mesh_store::fail_chunk_patch(const chunk_upload_request& patch) {
+        patch_stats.num_failed++;
+
+        mc_chunk_patch failed = {};
+        failed.x = patch.definition.position.x;
+        failed.y = patch.definition.position.y;
+        failed.z = patch.definition.position.z;
+        failed.id = patch.definition.id;
+
+        std::lock_guard<std::mutex> lock(failed_chunk_patches_lock);
+        failed_chunk_patches.push_back(failed);
+    }
+
+    bool mesh_store::get_next_failed_chunk_patch(mc_chunk_patch& patch) {
+        std::lock_guard<std::mutex> lock(failed_chunk_patches_lock);
+        if(failed_chunk_patches.empty()) {
+            return false;
+        }
+
+        patch = failed_chunk_patches.front();
+        failed_chunk_patches.pop_front();
+        return true;
+    }
+
+    std::unique_ptr<gl_mesh> mesh_store::make_chunk_mesh(const mesh_definition& def, std::size_t num_quads,
+                                                         std::size_t reserved_quads) {
+        std::unique_ptr<gl_mesh> mesh;
+        if(gl_geometry_pool::supports_format(def.vertex_format)) {
+            mesh = geometry_pool.create_mesh(def, num_quads, reserved_quads);
+        }
+
+        if(!mesh && num_quads > 0) {
+            auto& quad_indices = geometry_pool.get_quad_indices();
+            mesh = std::make_unique<gl_mesh>();
+            mesh->set_data(def.vertex_data, def.vertex_format, usage::static_draw);
+            mesh->set_shared_index_array(quad_indices.get_buffer(num_quads),
+                                         static_cast<unsigned int>(num_quads * INDICES_PER_QUAD));
+        } else if(!mesh) {
+            mesh = std::make_unique<gl_mesh>(def);
+        }
+
+        return mesh;
+    }
+
+    void mesh_store::upload_chunk_part(const chunk_section_key& key, chunk_upload_request& request) {
+        const auto& def = request.definition;
+
+        std::size_t reserved_quads = 0;
+        float patch_room = chunk_patch_room;
+        if(request.is_patchable && patch_room > 0) {
+            auto room = static_cast<std::size_t>(std::ceil(request.num_quads * patch_room));
+            reserved_quads = request.num_quads + std::max(room, MIN_CHUNK_PATCH_ROOM_QUADS);
+        }
+
+        render_object obj = {};
+        obj.geometry = make_chunk_mesh(def, request.num_quads, reserved_quads);
+
+        // Meshes that didn't fit in the pool don't have any room to patch
+        quad_layout layout;
+        if(request.is_patchable && obj.geometry->get_quad_capacity() > 0) {
+            if(request.quad_slots.empty()) {
+                layout = quad_layout(request.num_quads, obj.geometry->get_quad_capacity());
+            } else {
+                layout = quad_layout(request.quad_slots, obj.geometry->get_quad_capacity());
+            }
+        }
+
+        for(auto& lod : request.lods) {
+            mesh_definition lod_def = {};
+            lod_def.vertex_format = def.vertex_format;
+            lod_def.vertex_data = std::move(lod.vertex_data);
+            lod_def.position = def.position;
+            lod_def.id = def.id;
+
+            obj.lod_geometry.push_back(make_chunk_mesh(lod_def, lod.num_quads));
+        }
+
+        obj.type = geometry_type::block;
+        obj.name = "chunk";
+        obj.parent_id = def.id;
+        obj.color_texture = "block_color";
+        obj.position = def.position;
+        obj.bounding_box = request.bounds;
+        obj.occluders = std::move(request.occluders);
+        obj.facing_ranges = request.facing_ranges;
+        insert_chunk_section(key, std::move(obj), request.content_hash, std::move(layout));
+    }
+
+    std::size_t mesh_store::get_num_pending_chunk_uploads() const {
+        return pending_chunk_uploads.size();
+    }
+
+    void mesh_store::on_config_change(nlohmann::json& new_config) {
+        upload_budget_bytes = new_config.value("chunkUploadBudgetBytes", upload_budget_bytes.load());
+        upload_budget_milliseconds = new_config.value("chunkUploadBudgetMilliseconds",
+                                                      upload_budget_milliseconds.load());
+        defragment_budget_bytes = new_config.value("geometryDefragmentBudgetBytes", defragment_budget_bytes.load());
+        compact_chunk_vertices = new_config.value("compactChunkVertices", compact_chunk_vertices.load());
+        build_chunk_lods = new_config.value("buildChunkLods", build_chunk_lods.load());
+        merge_chunk_quads = new_config.value("mergeCoplanarQuads", merge_chunk_quads.load());
+        build_chunk_occluders = new_config.value("occlusionCulling", build_chunk_occluders.load());
+        sort_chunk_quads_by_facing = new_config.value("quadFacingCulling", sort_chunk_quads_by_facing.load());
+        chunk_lod_distance = new_config.value("chunkLodDistance", chunk_lod_distance.load());
+        chunk_lod_hysteresis = new_config.value("chunkLodHysteresis", chunk_lod_hysteresis.load());
+        chunk_patch_room = new_config.value("chunkPatchRoom", chunk_patch_room.load());
+        use_chunk_mesh_cache = new_config.value("useChunkMeshCache", use_chunk_mesh_cache);
+        chunk_mesh_cache_directory = new_config.value("chunkMeshCacheDirectory", chunk_mesh_cache_directory);
+    }
+
+    void mesh_store::on_config_loaded(nlohmann::json& config) {}
 
-        for(int i = 0; i < chunk.vertex_buffer_size; i++) {
-            vertex_data.push_back(chunk.vertex_data[i]);
+    mpsc_queue_stats mesh_store::get_chunk_upload_stats() const {
+        return chunk_parts_to_upload.get_stats();
+    }
+
+    std::size_t mesh_store::get_num_skipped_chunk_uploads() const {
+        return num_skipped_chunk_uploads;
+    }
+
+    geometry_pool_stats mesh_store::get_geometry_pool_stats() const {
+        return geometry_pool.get_stats();
+    }
+
+    std::uint64_t mesh_store::get_geometry_version() const {
+        return geometry_pool.get_version();
+    }
+
+    quad_merge_stats mesh_store::get_quad_merge_stats() const {
+        quad_merge_stats stats;
+        stats.num_input_quads = num_quads_before_merging;
+        stats.num_output_quads = num_quads_after_merging;
+        return stats;
+    }
+
+    chunk_patch_stats mesh_store::get_chunk_patch_stats() const {
+        return patch_stats;
+    }
+
+    lod_settings mesh_store::get_lod_settings() const {
+        lod_settings settings;
+        settings.base_distance = chunk_lod_distance;
+        settings.hysteresis = chunk_lod_hysteresis;
+        return settings;
+    }
+
+    void mesh_store::remove_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk) {
+        auto request = std::make_shared<chunk_upload_request>();
+        request->filter = intern_name(filter_name);
+        request->definition.position = {chunk.x, chunk.y, chunk.z};
+        request->definition.id = chunk.id;
+        request->is_removal = true;
 
-            if(i % 7 == 6) {
-                // Add 0s for the normals and tangets since we don't compute those yet
-                vertex_data.push_back(0);
-                vertex_data.push_back(0);
-                vertex_data.push_back(0);
-                vertex_data.push_back(0);
-                vertex_data.push_back(0);
-                vertex_data.push_back(0);
+        auto key = make_section_key(request->filter, request->definition.position);
+        ingestion_workers.submit(chunk_section_key_hash()(key), [this, request]() {
+            // The tombstone has to be written before the removal is queued, so the cache can't hand out the removed
+            // section's old geometry after the removal
+            chunk_cache.write(*request);
+            chunk_parts_to_upload.push(std::move(*request));
+        });
+    }
+
+    static std::vector<int> convert_mc_vertices(const int* vertex_data, std::size_t num_ints, bool compact) {
+        if(compact) {
+            return compact_mc_vertices(vertex_data, num_ints);
+        }
+
+        return expand_mc_vertices(vertex_data, num_ints);
+    }
+
+    /*!
+     * \brief If the request's indices just draw a list of quads, throws them away so that the request is drawn with the
+     * shared quad index buffer
+     */
+    static void check_for_quad_list(chunk_upload_request& request, std::size_t num_vertices) {
+        auto& indices = request.definition.indices;
+        if(is_quad_list(indices.data(), indices.size(), num_vertices)) {
+            request.num_quads = indices.size() / INDICES_PER_QUAD;
+            indices = std::vector<int>();
+        }
+    }
+
+    /*!
+     * \brief Builds the simplified versions of a chunk part that's a plain list of quads
+     *
+     * Stops at the first level that doesn't have fewer quads than the level before it, since drawing it wouldn't save
+     * anything
+     *
+     * \param request The chunk part. Its num_quads must already be set
+     * \param vertex_data Minecraft's vertices for the chunk part
+     * \param num_vertices The number of vertices in vertex_data
+     * \param compact Whether to pack the simplified vertices like the full detail ones
+     */
+    static void build_lods(chunk_upload_request& request, const int* vertex_data, std::size_t num_vertices, bool compact) {
+        std::size_t previous_num_quads = request.num_quads;
+        if(previous_num_quads == 0) {
+            return;
+        }
+
+        for(std::size_t level = 1; level <= MAX_CHUNK_LOD_LEVELS; level++) {
+            auto lod_vertices = build_lod_vertices(vertex_data, num_vertices, get_lod_scale(level));
+            std::size_t num_quads = lod_vertices.size() / (4 * MC_VERTEX_SIZE_INTS);
+            if(num_quads == 0 || num_quads >= previous_num_quads) {
+                break;
             }
+
+            request.lods.push_back({convert_mc_vertices(lod_vertices.data(), lod_vertices.size(), compact), num_quads});
+            previous_num_quads = num_quads;
         }
+    }
+
+    /*!
+     * \brief Hashes Minecraft's data for a chunk part, along with everything else that ends up in its render_object
+     */
+    static std::uint64_t hash_chunk_part(const int* vertex_data, std::size_t num_vertex_ints, const int* indices,
+                                         std::size_t num_indices, const mesh_definition& def,
+                                         const chunk_conversion_options& options) {
+        std::uint64_t hash = hash_bytes(vertex_data, num_vertex_ints * sizeof(int));
+        hash = hash_bytes(indices, num_indices * sizeof(int), hash);
+
+        int extra[6] = {static_cast<int>(def.vertex_format), def.id, options.build_lods ? 1 : 0,
+                        options.merge_quads ? 1 : 0, options.build_occluders ? 1 : 0, options.sort_by_facing ? 1 : 0};
+        return hash_bytes(extra, sizeof(extra), hash);
+    }
 
-        for(int i = 0; i < chunk.index_buffer_size; i++) {
-            def.indices.push_back(chunk.indices[i]);
+    void mesh_store::convert_chunk_part(chunk_upload_request& request, const int* vertex_data, std::size_t num_vertex_ints,
+                                        const int* indices, std::size_t num_indices,
+                                        const chunk_conversion_options& options) {
+        auto& def = request.definition;
+        std::size_t num_vertices = num_vertex_ints / MC_VERTEX_SIZE_INTS;
+        request.content_hash = hash_chunk_part(vertex_data, num_vertex_ints, indices, num_indices, def, options);
+
+        // Empty chunk parts get the whole section, so there's still something sensible to sort them by
+        glm::vec3 section_size(CHUNK_WIDTH, CHUNK_SECTION_HEIGHT, CHUNK_DEPTH);
+        request.bounds = aabb::from_min_max(def.position, def.position + section_size);
+        compute_mc_vertex_bounds(vertex_data, num_vertices, def.position, request.bounds);
+
+        // Done before merging, since merged quads aren't whole block faces any more
+        if(options.build_occluders && is_quad_list(indices, num_indices, num_vertices)) {
+            request.occluders = build_section_occluders(vertex_data, num_vertices, def.position);
+        }
+
+        // Sorting only moves whole quads around, so the simplified versions are still built from what Minecraft sent
+        const int* sorted_vertex_data = vertex_data;
+        std::vector<int> sorted;
+        std::vector<std::uint16_t> quad_slots;
+        if(options.sort_by_facing && is_quad_list(indices, num_indices, num_vertices) &&
+           num_vertices / VERTICES_PER_QUAD <= MAX_SORTED_QUADS) {
+            request.facing_ranges = sort_mc_quads_by_facing(vertex_data, num_vertices, sorted, quad_slots);
+            sorted_vertex_data = sorted.data();
+        }
+
+        if(options.merge_quads && options.compact && is_quad_list(indices, num_indices, num_vertices)) {
+            std::vector<int> merged;
+            quad_merge_stats stats = {};
+            if(request.facing_ranges.is_sorted()) {
+                // Each facing is merged on its own so that the merged quads stay in their own range
+                const std::size_t quad_size_ints = VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+                auto input_ranges = request.facing_ranges;
+                for(std::size_t range = 0; range < NUM_FACING_RANGES; range++) {
+                    std::uint32_t first_quad = input_ranges.first_quad[range];
+                    std::uint32_t num_quads = input_ranges.first_quad[range + 1] - first_quad;
+                    auto range_stats = merge_coplanar_quads(sorted_vertex_data + first_quad * quad_size_ints,
+                                                            num_quads * VERTICES_PER_QUAD, merged);
+                    stats.num_input_quads += range_stats.num_input_quads;
+                    stats.num_output_quads += range_stats.num_output_quads;
+                    request.facing_ranges.first_quad[range + 1] = static_cast<std::uint32_t>(stats.num_output_quads);
+                }
+
+            } else {
+                stats = merge_coplanar_quads(vertex_data, num_vertices, merged);
+            }
+            def.vertex_data = std::move(merged);
+            def.indices = std::vector<int>();
+            request.num_quads = stats.num_output_quads;
+
+            num_quads_before_merging += stats.num_input_quads;
+            num_quads_after_merging += stats.num_output_quads;
+            LOG(TRACE) << "Merged chunk part " << def.id << " from " << stats.num_input_quads << " quads to "
+                       << stats.num_output_quads << " (" << stats.get_triangle_reduction() * 100 << "% fewer triangles)";
+
+        } else {
+            def.vertex_data = convert_mc_vertices(sorted_vertex_data, num_vertex_ints, options.compact);
+            def.indices.assign(indices, indices + num_indices);
+            check_for_quad_list(request, num_vertices);
+            request.is_patchable = request.num_quads > 0;
+
+            // Patches are numbered by the order Minecraft sent the quads in
+            if(request.is_patchable && request.facing_ranges.is_sorted()) {
+                request.quad_slots = std::move(quad_slots);
+            }
+        }
+
+        if(options.build_lods) {
+            build_lods(request, vertex_data, num_vertices, options.compact);
         }
+    }
 
-        def.vertex_format = format::all_values()[chunk.format];
+    void mesh_store::ingest_chunk_part(chunk_upload_request& request, const int* vertex_data, std::size_t num_vertex_ints,
+                                       const int* indices, std::size_t num_indices,
+                                       const chunk_conversion_options& options) {
+        convert_chunk_part(request, vertex_data, num_vertex_ints, indices, num_indices, options);
+        chunk_cache.write(request);
+        chunk_parts_to_upload.push(std::move(request));
+    }
+
+    void mesh_store::add_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk) {
+        auto request = std::make_shared<chunk_upload_request>();
+        request->filter = intern_name(filter_name);
+        request->is_removal = false;
+
+        auto& def = request->definition;
         def.position = {chunk.x, chunk.y, chunk.z};
         def.id = chunk.id;
-        remove_chunk_render_object(filter_name,chunk);
-        chunk_parts_to_upload_lock.lock();
-        chunk_parts_to_upload.emplace(filter_name, def);
-        chunk_parts_to_upload_lock.unlock();
+
+        std::size_t worker_key = chunk_section_key_hash()(make_section_key(request->filter, def.position));
+
+        chunk_conversion_options options = {};
+        options.compact = compact_chunk_vertices;
+        options.build_lods = build_chunk_lods;
+        options.merge_quads = merge_chunk_quads;
+        options.build_occluders = build_chunk_occluders;
+        options.sort_by_facing = sort_chunk_quads_by_facing;
+
+        // Minecraft always sends its own vertex layout, so chunk.format doesn't say anything we don't know already
+        def.vertex_format = options.compact ? format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT
+                                            : format::POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT;
+
+        // The old geometry for this section gets replaced when the new geometry is uploaded
+
+        // Anything in the transfer buffer has a reservation behind it, even if it's empty, and the ring can't reuse
+        // anything reserved after it until it's released
+        if(chunk_transfer_buffer.contains(chunk.vertex_data)) {
+            // Java wrote the data straight into our memory, so we can read it where it is
+            const int* vertex_data = chunk.vertex_data;
+            const int* indices = chunk.indices;
+            std::size_t num_vertex_ints = static_cast<std::size_t>(chunk.vertex_buffer_size);
+            std::size_t num_indices = static_cast<std::size_t>(chunk.index_buffer_size);
+
+            ingestion_workers.submit(worker_key, [this, request, vertex_data, indices, num_vertex_ints, num_indices, options]() {
+                ingest_chunk_part(*request, vertex_data, num_vertex_ints, indices, num_indices, options);
+                chunk_transfer_buffer.release(chunk_transfer_buffer.offset_of(vertex_data));
+            });
+            return;
+        }
+
+        // Minecraft owns the chunk's memory, so we need our own copy before we return
+        def.vertex_data.assign(chunk.vertex_data, chunk.vertex_data + chunk.vertex_buffer_size);
+        def.indices.assign(chunk.indices, chunk.indices + chunk.index_buffer_size);
+
+        ingestion_workers.submit(worker_key, [this, request, options]() {
+            auto mc_vertices = std::move(request->definition.vertex_data);
+            auto mc_indices = std::move(request->definition.indices);
+            ingest_chunk_part(*request, mc_vertices.data(), mc_vertices.size(), mc_indices.data(), mc_indices.size(),
+                              options);
+        });
+    }
+
+    void mesh_store::patch_chunk_render_object(std::string filter_name, mc_chunk_patch& patch) {
+        auto request = std::make_shared<chunk_upload_request>();
+        request->filter = intern_name(filter_name);
+        request->is_removal = false;
+        request->is_patch = true;
+
+        auto& def = request->definition;
+        def.position = {patch.x, patch.y, patch.z};
+        def.id = patch.id;
+
+        bool compact = compact_chunk_vertices;
+        def.vertex_format = compact ? format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT
+                                    : format::POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT;
+
+        // Patches are a handful of quads, so they're always copied rather than read from the transfer buffer
+        bool in_range = patch.first_quad >= 0 && patch.num_replaced_quads >= 0 && patch.vertex_buffer_size >= 0;
+        if(in_range) {
+            request->first_patched_quad = static_cast<std::size_t>(patch.first_quad);
+            request->num_replaced_quads = static_cast<std::size_t>(patch.num_replaced_quads);
+            def.vertex_data.assign(patch.vertex_data, patch.vertex_data + patch.vertex_buffer_size);
+        }
+
+        auto key = make_section_key(request->filter, def.position);
+        ingestion_workers.submit(chunk_section_key_hash()(key), [this, request, compact, in_range]() {
+            auto mc_vertices = std::move(request->definition.vertex_data);
+            std::size_t mc_quad_size_ints = VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+
+            request->is_patchable = in_range && mc_vertices.size() % mc_quad_size_ints == 0;
+            request->num_quads = mc_vertices.size() / mc_quad_size_ints;
+            compute_mc_vertex_bounds(mc_vertices.data(), request->num_quads * VERTICES_PER_QUAD,
+                                     request->definition.position, request->bounds);
+            request->definition.vertex_data = convert_mc_vertices(mc_vertices.data(), mc_vertices.size(), compact);
+
+            chunk_cache.write(*request);
+            chunk_parts_to_upload.push(std::move(*request));
+        });
+    }
+
+    /*!
+     * \brief Turns a world name into something that's safe to use as a file name
+     */
+    static std::string make_cache_file_name(const std::string& world_name) {
+        std::string file_name = world_name;
+        for(auto& c : file_name) {
+            if(!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.') {
+                c = '_';
+            }
+        }
+
+        return file_name + ".nova_meshes";
+    }
+
+    void mesh_store::open_chunk_mesh_cache(const std::string& world_name) {
+        if(!use_chunk_mesh_cache) {
+            return;
+        }
+
+        make_directory(chunk_mesh_cache_directory);
+        std::string path = chunk_mesh_cache_directory + "/" + make_cache_file_name(world_name);
+
+        // Opening right away means that every removal from here on makes it into the cache, even the ones that come in
+        // before loading gets to their sections
+        chunk_cache.open(path);
+    }
+
+    void mesh_store::load_chunk_mesh_cache(glm::vec2 center, float radius) {
+        if(!chunk_cache.is_open()) {
+            return;
+        }
+
+        // Loading takes a while for big worlds, so it happens next to everything else that makes chunk parts
+        ingestion_workers.submit(0, [this, center, radius]() {
+            auto is_near_player = [center, radius](const chunk_section_key& key) {
+                glm::vec2 column_center((key.section.x + 0.5f) * CHUNK_WIDTH, (key.section.z + 0.5f) * CHUNK_DEPTH);
+                return glm::distance(column_center, center) <= radius;
+            };
+
+            chunk_cache.load([this](chunk_upload_request&& cached_part) {
+                chunk_parts_to_upload.push(std::move(cached_part));
+            }, is_near_player);
+        });
+    }
+
+    void mesh_store::close_chunk_mesh_cache() {
+        chunk_cache.close();
+
+        ingestion_workers.wait_idle();
+        section_connectivity_updates.push({{}, 0, true});
+    }
+
+    void mesh_store::set_chunk_section_opacity(mc_chunk_section_opacity& section) {
+        auto opaque = std::make_shared<std::vector<std::uint64_t>>(SECTION_OPACITY_WORDS);
+        for(std::size_t word = 0; word < SECTION_OPACITY_WORDS; word++) {
+            auto low = static_cast<std::uint32_t>(section.opaque_blocks[word * 2]);
+            auto high = static_cast<std::uint32_t>(section.opaque_blocks[word * 2 + 1]);
+            (*opaque)[word] = low | (static_cast<std::uint64_t>(high) << 32);
+        }
+
+        glm::ivec3 position = make_section_key(0, {section.x, section.y, section.z}).section;
+        ingestion_workers.submit(section_position_hash()(position), [this, opaque, position]() {
+            section_connectivity_updates.push({position, compute_section_connectivity(opaque->data()), false});
+        });
+    }
+
+    section_visibility_graph& mesh_store::get_section_visibility() {
+        return section_visibility;
+    }
+
+    chunk_mesh_cache_stats mesh_store::get_chunk_mesh_cache_stats() const {
+        return chunk_cache.get_stats();
+    }
+
+    shared_ring_buffer& mesh_store::get_chunk_transfer_buffer() {
+        return chunk_transfer_buffer;
+    }
+
+    void mesh_store::wait_for_ingestion() {
+        ingestion_workers.wait_idle();
     }
 
     void mesh_store::remove_render_objects_with_parent(long parent_id) {
-        remove_render_objects([&](render_object& obj) { return obj.parent_id == parent_id; });
+        auto request = std::make_shared<chunk_upload_request>();
+        request->filter = NO_NAME;
+        request->definition.id = static_cast<int>(parent_id);
+        request->is_removal = true;
+        request->is_parent_removal = true;
+
+        // The parent's sections could be on any of the ingestion workers, so the removal waits for all of them
+        ingestion_workers.submit_barrier([this, request]() {
+            chunk_cache.write(*request);
+            chunk_parts_to_upload.push(std::move(*request));
+        });
+    }
+
+    void mesh_store::remove_chunk_parent(long parent_id) {
+        // These were sent before the removal, so they'd bring the parent back if they were uploaded after it
+        for(auto pending_itr = pending_chunk_uploads.begin(); pending_itr != pending_chunk_uploads.end();) {
+            if(pending_itr->second.definition.id == parent_id) {
+                pending_itr = pending_chunk_uploads.erase(pending_itr);
+            } else {
+                ++pending_itr;
+            }
+        }
+
+        auto parent_itr = sections_by_parent.find(parent_id);
+        if(parent_itr == sections_by_parent.end()) {
+            return;
+        }
+
+        // remove_chunk_section edits sections_by_parent, so we need our own copy of the keys
+        auto keys = parent_itr->second;
+        for(const auto& key : keys) {
+            remove_chunk_section(key);
+        }
+    }
+
+    void mesh_store::insert_chunk_section(const chunk_section_key& key, render_object&& obj, std::uint64_t content_hash,
+                                          quad_layout layout) {
+        auto& group = get_meshes_for_shader(key.filter);
+
+        auto index_itr = chunk_section_index.find(key);
+        if(index_itr != chunk_section_index.end()) {
+            index_itr->second.content_hash = content_hash;
+            index_itr->second.layout = std::move(layout);
+
+            auto& old_obj = *group.get(index_itr->second.handle);
+            if(old_obj.parent_id != obj.parent_id) {
+                forget_section_parent(old_obj.parent_id, key);
+                sections_by_parent[obj.parent_id].push_back(key);
+            }
+
+            group.replace(index_itr->second.handle, std::move(obj));
+            return;
+        }
+
+        sections_by_parent[obj.parent_id].push_back(key);
+        chunk_section_index.emplace(key, resident_chunk_section{group.insert(std::move(obj)), content_hash,
+                                                                std::move(layout)});
+    }
+
+    void mesh_store::remove_chunk_section(const chunk_section_key& key) {
+        auto index_itr = chunk_section_index.find(key);
+        if(index_itr == chunk_section_index.end()) {
+            return;
+        }
+
+        auto handle = index_itr->second.handle;
+        chunk_section_index.erase(index_itr);
+
+        auto* obj = get_meshes_for_shader(key.filter).get(handle);
+        if(obj != nullptr) {
+            forget_section_parent(obj->parent_id, key);
+        }
+
+        pending_removals.emplace_back(key.filter, handle);
+    }
+
+    void mesh_store::forget_section_parent(long parent_id, const chunk_section_key& key) {
+        auto parent_itr = sections_by_parent.find(parent_id);
+        if(parent_itr == sections_by_parent.end()) {
+            return;
+        }
+
+        auto& keys = parent_itr->second;
+        keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+        if(keys.empty()) {
+            sections_by_parent.erase(parent_itr);
+        }
     }
 }
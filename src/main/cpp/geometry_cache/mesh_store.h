@@ -9,28 +9,120 @@
 #define RENDERER_GEOMETRY_CACHE_H
 
 #include <vector>
-#include <mutex>
 #include <functional>
 #include <unordered_map>
-#include <queue>
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include "../render/objects/render_object.h"
+#include "../render/objects/render_object_bucket.h"
 #include "../render/objects/shaders/shaderpack.h"
+#include "../render/objects/camera.h"
+#include "../render/objects/gl_geometry_pool.h"
+#include "../data_loading/settings.h"
+#include "../data_loading/direct_buffers.h"
 #include "../mc_interface/mc_gui_objects.h"
 #include "../mc_interface/mc_objects.h"
+#include "../utils/mpsc_queue.h"
+#include "../utils/worker_pool.h"
+#include "../utils/slot_map.h"
+#include "../utils/name_table.h"
+#include "lod_builder.h"
+#include "quad_merger.h"
+#include "quad_layout.h"
+#include "occluder_builder.h"
+#include "section_connectivity.h"
+#include "../render/objects/section_visibility.h"
+#include "chunk_section.h"
+#include "chunk_mesh_cache.h"
 
 namespace nova {
+    /*!
+     * \brief How the ingestion workers should turn a chunk part into a mesh_definition. Snapshotted from the settings
+     * when the chunk part is handed to us
+     */
+    struct chunk_conversion_options {
+        bool compact;
+        bool build_lods;
+        bool merge_quads;
+        bool build_occluders;
+        bool sort_by_facing;
+    };
+
+    /*!
+     * \brief A chunk section's connectivity, on its way from an ingestion worker to the render thread
+     */
+    struct section_connectivity_update {
+        glm::ivec3 section;
+        section_connectivity connectivity;
+
+        /*!
+         * \brief If true, every section's connectivity is forgotten instead
+         */
+        bool is_reset;
+    };
+
+    /*!
+     * \brief What mesh_store knows about a chunk section that's been uploaded
+     */
+    struct resident_chunk_section {
+        slot_handle handle;
+
+        /*!
+         * \brief The content_hash of the chunk_upload_request that the section was uploaded from
+         */
+        std::uint64_t content_hash;
+
+        /*!
+         * \brief Which slot of the section's mesh each of Minecraft's quads is in. Has no capacity if the section can't
+         * be patched
+         */
+        quad_layout layout;
+    };
+
+    /*!
+     * \brief Counters for patches to chunk sections
+     */
+    struct chunk_patch_stats {
+        /*!
+         * \brief Patches that were written straight into a mesh on the GPU
+         */
+        std::size_t num_applied_in_place;
+
+        /*!
+         * \brief Patches that were applied to a chunk part that hadn't been uploaded yet
+         */
+        std::size_t num_applied_before_upload;
+
+        /*!
+         * \brief Patches that couldn't be applied, so Minecraft had to send the whole section again
+         */
+        std::size_t num_failed;
+
+        /*!
+         * \brief How many bytes of vertex data patches have written to the GPU
+         */
+        std::size_t bytes_written;
+    };
+
     /*!
          * \brief Provides access to the meshes that Nova will want to deal with
          *
          * The primary way it does this is by allowing the user to specify
          */
-    class mesh_store {
+    class mesh_store : public iconfig_listener {
     public:
         void add_gui_buffers(mc_gui_geometry* command);
 
         /*!
          * \brief Adds a chunk to the mesh store if the chunk doesn't exist, or replaces the chunks if it does exist
          *
+         * If the chunk's vertex data points into the chunk transfer buffer, it's read in place by one of the ingestion
+         * workers and its space in the transfer buffer is released afterwards. In that case the vertex data must be at
+         * the start of a reservation, and the indices must be in the same reservation. Otherwise the chunk's data is
+         * copied before this method returns. Either way, the data is turned into a mesh_definition on an ingestion
+         * worker
+         *
          * \param chunk The chunk to add or update
          */
         void add_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk);
@@ -38,10 +130,90 @@ namespace nova {
         /*!
          * \brief Removes a chunk's geometry for the specified filter
          *
+         * The geometry is removed the next time upload_new_geometry runs
+         *
          * \param filter_name The name of the filter to remove the chunk geometry from
          * \param chunk The chunk to remove
          */
         void remove_chunk_render_object(std::string filter_name, mc_chunk_render_object &chunk);
+
+        /*!
+         * \brief Replaces some of the quads of a chunk section that's already been added
+         *
+         * The new quads are converted on an ingestion worker, in order with everything else for the section. If the
+         * section is still waiting to be uploaded, the patch is applied to it there. Otherwise it's written into the
+         * section's mesh during the next upload_new_geometry, as long as the mesh has room. Patches that can't be
+         * applied are reported by get_next_failed_chunk_patch, and the section isn't patched again until Minecraft sends
+         * it whole
+         *
+         * \param filter_name The name of the filter that the section's geometry belongs to
+         * \param patch The quads to replace. Copied before this method returns
+         */
+        void patch_chunk_render_object(std::string filter_name, mc_chunk_patch& patch);
+
+        /*!
+         * \brief Takes one of the chunk sections that a patch couldn't be applied to
+         *
+         * Can be called from any thread
+         *
+         * \param patch Filled in with the section's position and ID
+         * \return False if there are no failed patches
+         */
+        bool get_next_failed_chunk_patch(mc_chunk_patch& patch);
+
+        /*!
+         * \brief Works out which faces of a chunk section can see each other, on an ingestion worker
+         *
+         * The section visibility graph gets the result during the next upload_new_geometry
+         *
+         * \param section Which of the section's blocks are opaque. Copied before this method returns
+         */
+        void set_chunk_section_opacity(mc_chunk_section_opacity& section);
+
+        /*!
+         * \brief Returns which chunk sections can see each other. Only touched on the render thread
+         */
+        section_visibility_graph& get_section_visibility();
+
+        /*!
+         * \brief Starts using the chunk mesh cache for the given world. Call #load_chunk_mesh_cache once the player's
+         * position is known
+         *
+         * Every chunk part that's converted from then on is written to the cache, and every removal leaves a tombstone
+         * so the removed section isn't loaded again
+         *
+         * Does nothing if the useChunkMeshCache setting is off
+         *
+         * \param world_name Something that identifies the world or server, like its folder or address
+         */
+        void open_chunk_mesh_cache(const std::string& world_name);
+
+        /*!
+         * \brief Queues the cached chunk sections around the player for upload
+         *
+         * They're queued the same as if Minecraft had just sent them, so the world can be drawn before Minecraft has
+         * meshed anything. Whatever Minecraft sends afterwards replaces the cached version, or is skipped if it's the
+         * same. Minecraft only ever sends or removes sections within its render distance, so anything cached further
+         * away than that would never be replaced or removed, and it's left in the cache instead. Reading the cache
+         * happens on an ingestion worker, so this returns right away
+         *
+         * Does nothing if #open_chunk_mesh_cache hasn't been called since the last load
+         *
+         * \param center The player's position on the X and Z axes
+         * \param radius How far from the player a chunk column can be to be loaded, in blocks
+         */
+        void load_chunk_mesh_cache(glm::vec2 center, float radius);
+
+        /*!
+         * \brief Stops writing chunk parts to the chunk mesh cache, and forgets every chunk section's connectivity.
+         * Call this when leaving a world
+         *
+         * Waits for the ingestion workers, so that nothing they were still working on for the old world comes through
+         * after it's been forgotten
+         */
+        void close_chunk_mesh_cache();
+
+        chunk_mesh_cache_stats get_chunk_mesh_cache_stats() const;
         
         /*!
          * \brief Retrieves the list of meshes that the shader with the provided name should render
@@ -49,12 +221,48 @@ namespace nova {
          * \param shader_name The name of the shader to get meshes for
          * \return All the meshes that should be rendered with the given name
          */
-        std::vector<render_object>& get_meshes_for_shader(std::string shader_name);
+        render_object_bucket& get_meshes_for_shader(const std::string& shader_name);
 
         /*!
-         * \brief Takes geometry that's been added in the last frame and sends it to the GPU
+         * \brief Retrieves the list of meshes that the shader with the provided interned name should render
+         *
+         * This is just an array lookup, so it's what the draw loop uses
+         */
+        render_object_bucket& get_meshes_for_shader(name_id shader_name);
+
+        /*!
+         * \brief Takes geometry that's been added since the last frame and sends as much of it to the GPU as the upload
+         * budget allows
+         *
+         * Chunk parts that are inside the camera's frustum go first, then everything else. Within each of those groups,
+         * chunk parts closer to the camera go first. Anything that doesn't fit in this frame's budget waits for the next
+         * frame. At least one chunk part is uploaded every frame so that the queue always drains eventually. Chunk
+         * section connectivity that's been worked out since the last frame goes into the section visibility graph first
+         *
+         * \param player_camera The camera to prioritize chunk parts for. Its frustum should be up to date
          */
-        void upload_new_geometry();
+        void upload_new_geometry(camera& player_camera);
+
+        /*!
+         * \brief Returns the buffer that Java can write chunk geometry into so that Nova doesn't have to copy it
+         */
+        shared_ring_buffer& get_chunk_transfer_buffer();
+
+        /*!
+         * \brief Blocks until the ingestion workers have put every chunk part they've been given into the upload queue
+         */
+        void wait_for_ingestion();
+
+        /*!
+         * \brief Returns the number of chunk parts that have been received but not yet sent to the GPU
+         */
+        std::size_t get_num_pending_chunk_uploads() const;
+
+        // Overrides from iconfig_listener
+
+        void on_config_change(nlohmann::json& new_config) override;
+
+        void on_config_loaded(nlohmann::json& config) override;
 
         /*!
         * \brief Removes all gui render objects and thereby deletes all the buffers
@@ -62,22 +270,239 @@ namespace nova {
         void remove_gui_render_objects();
 
         /*!
-         * \brief Removes all known render objects that come from the given ID
+         * \brief Removes all known chunk render objects that come from the given ID
          *
-         * This method shoudl be called when updating a chunk, or when unloading a chunk
+         * This method shoudl be called when updating a chunk, or when unloading a chunk. Only the sections that belong to
+         * the given parent are touched. The removal goes through the ingestion workers and the upload queue like every
+         * other removal, after everything that's already been sent for the parent, and the render_objects stick around
+         * until the next upload_new_geometry. Can be called from any thread
          *
          * \param parent_id The id of the objects to remove
          */
         void remove_render_objects_with_parent(long parent_id);
 
+        /*!
+         * \brief Returns the counters for the queue that chunk parts wait in before they're uploaded
+         *
+         * Useful for seeing how much the chunk builder threads and the render thread get in each other's way
+         */
+        mpsc_queue_stats get_chunk_upload_stats() const;
+
+        /*!
+         * \brief Returns how many chunk parts weren't uploaded because they were exactly the same as what was already
+         * on the GPU
+         */
+        std::size_t get_num_skipped_chunk_uploads() const;
+
+        /*!
+         * \brief Returns how full and how fragmented the GPU buffers that hold chunk geometry are
+         */
+        geometry_pool_stats get_geometry_pool_stats() const;
+
+        /*!
+         * \brief Returns a number that changes whenever pooled chunk geometry is added, removed, moved or patched
+         */
+        std::uint64_t get_geometry_version() const;
+
+        /*!
+         * \brief Returns the distances at which chunk sections switch to their simplified versions
+         */
+        lod_settings get_lod_settings() const;
+
+        /*!
+         * \brief Returns how many quads have gone into and come out of merge_coplanar_quads, over every chunk part that's
+         * been merged so far
+         */
+        quad_merge_stats get_quad_merge_stats() const;
+
+        chunk_patch_stats get_chunk_patch_stats() const;
+
     private:
-        std::unordered_map<std::string, std::vector<render_object>> renderables_grouped_by_shader;
+        /*!
+         * \brief The size of the buffer that Java writes chunk geometry into. Big enough for a few dozen busy chunk
+         * sections
+         */
+        static const std::size_t CHUNK_TRANSFER_BUFFER_SIZE = 32 * 1024 * 1024;
+
+        /*!
+         * \brief The least room to leave for patches in a chunk section's mesh, so that small sections can still have a
+         * block or two added
+         */
+        static const std::size_t MIN_CHUNK_PATCH_ROOM_QUADS = 16;
+
+        /*!
+         * \brief How many chunk parts to pull off the upload queue at once
+         */
+        const std::size_t upload_batch_size = 64;
+
+        /*!
+         * \brief Where chunk geometry lives on the GPU. Declared before the render_objects so that it outlives their
+         * meshes
+         */
+        gl_geometry_pool geometry_pool;
+
+        /*!
+         * \brief The render_objects for each shader, indexed by the shader's interned name. Empty slots belong to names
+         * that aren't shaders, or that haven't had anything added yet
+         */
+        std::vector<std::unique_ptr<render_object_bucket>> renderables_grouped_by_shader;
+
+        /*!
+         * \brief The render_objects that have been removed since the last frame, and the shader each one belongs to
+         *
+         * Removals are batched up and applied all at once in flush_removals, so nothing disappears in the middle of a
+         * frame
+         */
+        std::vector<std::pair<name_id, slot_handle>> pending_removals;
+
+        /*!
+         * \brief How many removals have named a render_object that was already gone
+         */
+        std::size_t num_stale_removals = 0;
+
+        std::size_t num_skipped_chunk_uploads = 0;
 
-        std::mutex chunk_parts_to_upload_lock;
         /*!
          * \brief A list of chunk renderable things that are ready to upload to the GPU
+         *
+         * Minecraft's chunk builder threads push into this, and the render thread drains it in upload_new_geometry
+         */
+        mpsc_queue<chunk_upload_request> chunk_parts_to_upload;
+
+        /*!
+         * \brief Where each chunk section's render_object lives in its filter's list of render_objects
+         */
+        std::unordered_map<chunk_section_key, resident_chunk_section, chunk_section_key_hash> chunk_section_index;
+
+        /*!
+         * \brief All the chunk sections that belong to each parent ID
+         */
+        std::unordered_map<long, std::vector<chunk_section_key>> sections_by_parent;
+
+        /*!
+         * \brief Scratch space for the batch of chunk parts being pulled off the queue. Kept around so we don't allocate
+         * every frame
+         */
+        std::vector<chunk_upload_request> upload_batch;
+
+        shared_ring_buffer chunk_transfer_buffer{CHUNK_TRANSFER_BUFFER_SIZE};
+
+        /*!
+         * \brief Chunk parts that have been pulled off the queue but haven't fit in an upload budget yet
+         *
+         * If Minecraft sends a chunk section again before the old version is uploaded, the old version is simply replaced
+         */
+        std::unordered_map<chunk_section_key, chunk_upload_request, chunk_section_key_hash> pending_chunk_uploads;
+
+        /*!
+         * \brief Where a pending chunk part goes in the upload order. Visible parts go before invisible ones, then closer
+         * goes before farther
+         */
+        struct upload_priority {
+            bool is_invisible;
+            float distance_squared;
+            const chunk_section_key* key;
+        };
+
+        /*!
+         * \brief Scratch space for sorting the pending chunk parts by priority
+         */
+        std::vector<upload_priority> upload_order;
+
+        /*!
+         * \brief The most bytes of chunk geometry to send to the GPU in one frame
+         *
+         * The budgets are set from the config thread and read on the render thread, so they're atomic
+         */
+        std::atomic<std::size_t> upload_budget_bytes{4 * 1024 * 1024};
+
+        /*!
+         * \brief The most time to spend sending chunk geometry to the GPU in one frame
+         */
+        std::atomic<float> upload_budget_milliseconds{4};
+
+        /*!
+         * \brief About how many bytes of chunk geometry the geometry pool may move around each frame to fill holes
+         */
+        std::atomic<std::size_t> defragment_budget_bytes{1024 * 1024};
+
+        /*!
+         * \brief If true, chunk vertices are packed into COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT instead of
+         * being expanded into POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT
+         *
+         * Read when a chunk is handed to us, so a change only affects chunks that Minecraft sends afterwards
+         */
+        std::atomic<bool> compact_chunk_vertices{true};
+
+        /*!
+         * \brief If true, the ingestion workers build simplified versions of each chunk part. Read when a chunk is
+         * handed to us, like compact_chunk_vertices
+         */
+        std::atomic<bool> build_chunk_lods{true};
+
+        /*!
+         * \brief The fields of the lod_settings that get_lod_settings hands out. Set from the config thread and read on
+         * the render thread, so they're kept apart as atomics
+         */
+        std::atomic<float> chunk_lod_distance{lod_settings().base_distance};
+        std::atomic<float> chunk_lod_hysteresis{lod_settings().hysteresis};
+
+        /*!
+         * \brief If true, neighboring coplanar block faces are merged into bigger quads. Only applies to compact vertices,
+         * and needs a shaderpack that understands repeat-UV mode
+         */
+        std::atomic<bool> merge_chunk_quads{false};
+
+        /*!
+         * \brief If true, the ingestion workers find the big solid faces in each chunk section for occlusion culling.
+         * Read when a chunk is handed to us, like compact_chunk_vertices
+         */
+        std::atomic<bool> build_chunk_occluders{false};
+
+        /*!
+         * \brief If true, the ingestion workers sort each chunk section's quads by which way they face, so that the
+         * quads facing away from the camera can be skipped. Read when a chunk is handed to us, like
+         * compact_chunk_vertices
+         */
+        std::atomic<bool> sort_chunk_quads_by_facing{true};
+
+        std::atomic<std::size_t> num_quads_before_merging{0};
+        std::atomic<std::size_t> num_quads_after_merging{0};
+
+        /*!
+         * \brief How much room to leave after each chunk section's quads for patches to add more, as a fraction of the
+         * section's quads. Set from the config thread while chunk parts are being converted, so it's atomic
+         */
+        std::atomic<float> chunk_patch_room{0.25f};
+
+        chunk_patch_stats patch_stats = {};
+
+        /*!
+         * \brief Sections that patches couldn't be applied to, waiting for Minecraft to ask about them
+         */
+        std::deque<mc_chunk_patch> failed_chunk_patches;
+        mutable std::mutex failed_chunk_patches_lock;
+
+        /*!
+         * \brief Scratch space for the quads that a patch writes. Kept around so we don't allocate for every patch
+         */
+        std::vector<quad_slot_write> patch_writes;
+
+        bool use_chunk_mesh_cache = true;
+
+        /*!
+         * \brief The directory that each world's chunk mesh cache goes in. Made if it doesn't exist
+         */
+        std::string chunk_mesh_cache_directory = "cache";
+
+        chunk_mesh_cache chunk_cache;
+
+        /*!
+         * \brief Chunk section connectivity that the ingestion workers have worked out, waiting for the render thread
          */
-        std::queue<std::tuple<std::string, mesh_definition>> chunk_parts_to_upload;
+        mpsc_queue<section_connectivity_update> section_connectivity_updates;
+
+        section_visibility_graph section_visibility;
 
         float seconds_spent_updating_chunks = 0;
         long total_chunks_updated = 0;
@@ -91,6 +516,102 @@ namespace nova {
          * \param filter The function to use to decide which (if any) objects to remove
          */
         void remove_render_objects(std::function<bool(render_object&)> fitler);
+
+        /*!
+         * \brief Adds the render_object for a chunk section, replacing whatever render_object the section had before
+         *
+         * \param key The section that the render_object belongs to
+         * \param obj The render_object to add
+         * \param content_hash The hash of the data the render_object was made from
+         * \param layout Where the render_object's quads are in its mesh
+         */
+        void insert_chunk_section(const chunk_section_key& key, render_object&& obj, std::uint64_t content_hash,
+                                  quad_layout layout);
+
+        /*!
+         * \brief Forgets the given chunk section and queues its render_object for removal, if there is one
+         *
+         * \param key The section to remove
+         */
+        void remove_chunk_section(const chunk_section_key& key);
+
+        /*!
+         * \brief Removes every render_object in pending_removals
+         *
+         * Each removal is an O(1) swap with the last render_object in its shader's list
+         */
+        void flush_removals();
+
+        void forget_section_parent(long parent_id, const chunk_section_key& key);
+
+        /*!
+         * \brief Forgets every chunk section that belongs to the given parent, and every chunk part of the parent's
+         * that's still waiting to be uploaded. Only called on the render thread, while draining the upload queue
+         */
+        void remove_chunk_parent(long parent_id);
+
+        /*!
+         * \brief Moves everything in the lock-free upload queue into pending_chunk_uploads, applying removals right away
+         */
+        void drain_upload_queue();
+
+        /*!
+         * \brief Applies a patch to the chunk part waiting for upload, or to the resident section if nothing's waiting
+         */
+        void apply_chunk_patch(const chunk_section_key& key, const chunk_upload_request& patch);
+
+        /*!
+         * \brief Writes a patch's quads into a resident section's mesh
+         *
+         * \return False if the section isn't there, can't be patched, or doesn't have room for the new quads
+         */
+        bool patch_resident_chunk_section(const chunk_section_key& key, const chunk_upload_request& patch);
+
+        /*!
+         * \brief Remembers that a patch couldn't be applied, so that Minecraft can send the section whole
+         */
+        void fail_chunk_patch(const chunk_upload_request& patch);
+
+        /*!
+         * \brief Turns Minecraft's data for a chunk part into the request's mesh_definition. Runs on an ingestion worker
+         *
+         * Nothing keeps a pointer to vertex_data or indices, so they can be freed as soon as this returns
+         */
+        void convert_chunk_part(chunk_upload_request& request, const int* vertex_data, std::size_t num_vertex_ints,
+                                const int* indices, std::size_t num_indices, const chunk_conversion_options& options);
+
+        /*!
+         * \brief Converts a chunk part, writes it to the chunk mesh cache and queues it for upload. Runs on an ingestion
+         * worker
+         *
+         * Minecraft sends each chunk section on its own, so the chunk part stays in the section it was sent for, along
+         * with any quads that hang over the top of that section
+         */
+        void ingest_chunk_part(chunk_upload_request& request, const int* vertex_data, std::size_t num_vertex_ints,
+                               const int* indices, std::size_t num_indices, const chunk_conversion_options& options);
+
+        /*!
+         * \brief Sends a chunk part and its simplified versions to the GPU. The request's vertex data is moved out of
+         */
+        void upload_chunk_part(const chunk_section_key& key, chunk_upload_request& request);
+
+        /*!
+         * \brief Makes a mesh for chunk geometry, in the geometry pool if there's room and on its own if there isn't
+         *
+         * \param def The geometry
+         * \param num_quads If this isn't zero, def is a plain list of this many quads with no indices
+         * \param reserved_quads How many quads to make room for, if the mesh goes in the geometry pool
+         */
+        std::unique_ptr<gl_mesh> make_chunk_mesh(const mesh_definition& def, std::size_t num_quads,
+                                                 std::size_t reserved_quads = 0);
+
+        /*!
+         * \brief The threads that turn Minecraft's chunk data into mesh_definitions
+         *
+         * Everything for one chunk section goes to the same worker so that additions and removals stay in order.
+         * Declared last so the workers stop before anything they push into is destroyed
+         */
+        worker_pool ingestion_workers;
     };
 
 };
@@ -0,0 +1,180 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "occluder_builder.h"
+#include "vertex_kernels.h"
+#include "../mc_interface/mc_objects.h"
+
+namespace nova {
+    static const int SECTION_SIZE = 16;
+
+    /*!
+     * \brief One grid per axis per plane. A section has 17 planes along each axis, counting both of its sides
+     */
+    static const int NUM_PLANES = SECTION_SIZE + 1;
+
+    /*!
+     * \brief How far a corner can be from a whole block position and still count as being on it
+     */
+    static const float GRID_EPSILON = 1.0f / 256;
+
+    struct occluder_rect {
+        int axis;
+        int plane;
+        int min_u;
+        int min_v;
+        int width;
+        int height;
+
+        int get_area() const {
+            return width * height;
+        }
+    };
+
+    static std::size_t cell_index(int axis, int plane, int u, int v) {
+        return ((static_cast<std::size_t>(axis) * NUM_PLANES + plane) * SECTION_SIZE + v) * SECTION_SIZE + u;
+    }
+
+    static bool snap_to_grid(float value, int& snapped) {
+        float rounded = std::round(value);
+        snapped = static_cast<int>(rounded);
+        return std::abs(value - rounded) < GRID_EPSILON;
+    }
+
+    /*!
+     * \brief Works out which grid cell a quad covers, if it covers exactly one whole block face
+     */
+    static bool find_face_cell(const int* quad, int& axis, int& plane, int& u, int& v) {
+        float corners[VERTICES_PER_QUAD][3];
+        for(std::size_t vertex = 0; vertex < VERTICES_PER_QUAD; vertex++) {
+            std::memcpy(corners[vertex], quad + vertex * MC_VERTEX_SIZE_INTS, sizeof(corners[vertex]));
+        }
+
+        for(axis = 0; axis < 3; axis++) {
+            bool is_flat = true;
+            for(std::size_t vertex = 1; vertex < VERTICES_PER_QUAD; vertex++) {
+                is_flat &= std::abs(corners[vertex][axis] - corners[0][axis]) < GRID_EPSILON;
+            }
+            if(is_flat) {
+                break;
+            }
+        }
+        if(axis == 3 || !snap_to_grid(corners[0][axis], plane) || plane < 0 || plane >= NUM_PLANES) {
+            return false;
+        }
+
+        int u_axis = (axis + 1) % 3;
+        int v_axis = (axis + 2) % 3;
+        float min_u = std::min({corners[0][u_axis], corners[1][u_axis], corners[2][u_axis], corners[3][u_axis]});
+        float min_v = std::min({corners[0][v_axis], corners[1][v_axis], corners[2][v_axis], corners[3][v_axis]});
+        if(!snap_to_grid(min_u, u) || !snap_to_grid(min_v, v) || u < 0 || u >= SECTION_SIZE || v < 0 ||
+           v >= SECTION_SIZE) {
+            return false;
+        }
+
+        // Every corner has to be a corner of the block face, and the four of them can't all be the same corner
+        int corners_seen = 0;
+        for(const auto& corner : corners) {
+            int corner_u, corner_v;
+            if(!snap_to_grid(corner[u_axis] - u, corner_u) || !snap_to_grid(corner[v_axis] - v, corner_v) ||
+               corner_u < 0 || corner_u > 1 || corner_v < 0 || corner_v > 1) {
+                return false;
+            }
+            corners_seen |= 1 << (corner_u + corner_v * 2);
+        }
+
+        return corners_seen == 0xF;
+    }
+
+    std::vector<aabb> build_section_occluders(const int* src, std::size_t num_vertices, const glm::vec3& origin) {
+        std::vector<aabb> occluders;
+        if(num_vertices % VERTICES_PER_QUAD != 0) {
+            return occluders;
+        }
+
+        std::vector<std::uint8_t> cells(cell_index(3, 0, 0, 0), 0);
+        bool has_faces = false;
+
+        std::size_t num_quads = num_vertices / VERTICES_PER_QUAD;
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            int axis, plane, u, v;
+            if(find_face_cell(src + quad * VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS, axis, plane, u, v)) {
+                cells[cell_index(axis, plane, u, v)] = 1;
+                has_faces = true;
+            }
+        }
+
+        if(!has_faces) {
+            return occluders;
+        }
+
+        // Greedily cover each grid with rectangles: run along a row as far as possible, then stretch that run
+        // across as many rows as it fits in. Covered cells are cleared so they're only used once
+        std::vector<occluder_rect> rects;
+        for(int axis = 0; axis < 3; axis++) {
+            for(int plane = 0; plane < NUM_PLANES; plane++) {
+                for(int v = 0; v < SECTION_SIZE; v++) {
+                    for(int u = 0; u < SECTION_SIZE; u++) {
+                        if(!cells[cell_index(axis, plane, u, v)]) {
+                            continue;
+                        }
+
+                        int width = 1;
+                        while(u + width < SECTION_SIZE && cells[cell_index(axis, plane, u + width, v)]) {
+                            width++;
+                        }
+
+                        int height = 1;
+                        for(; v + height < SECTION_SIZE; height++) {
+                            bool row_is_full = true;
+                            for(int i = 0; i < width && row_is_full; i++) {
+                                row_is_full = cells[cell_index(axis, plane, u + i, v + height)] != 0;
+                            }
+                            if(!row_is_full) {
+                                break;
+                            }
+                        }
+
+                        for(int j = 0; j < height; j++) {
+                            for(int i = 0; i < width; i++) {
+                                cells[cell_index(axis, plane, u + i, v + j)] = 0;
+                            }
+                        }
+
+                        rects.push_back({axis, plane, u, v, width, height});
+                    }
+                }
+            }
+        }
+
+        std::size_t num_to_keep = std::min(rects.size(), MAX_OCCLUDERS_PER_SECTION);
+        std::partial_sort(rects.begin(), rects.begin() + num_to_keep, rects.end(),
+                          [](const occluder_rect& a, const occluder_rect& b) { return a.get_area() > b.get_area(); });
+
+        occluders.reserve(num_to_keep);
+        for(std::size_t i = 0; i < num_to_keep; i++) {
+            const auto& rect = rects[i];
+            int u_axis = (rect.axis + 1) % 3;
+            int v_axis = (rect.axis + 2) % 3;
+
+            glm::vec3 min = origin;
+            glm::vec3 max = origin;
+            min[rect.axis] += rect.plane;
+            max[rect.axis] += rect.plane;
+            min[u_axis] += rect.min_u;
+            max[u_axis] += rect.min_u + rect.width;
+            min[v_axis] += rect.min_v;
+            max[v_axis] += rect.min_v + rect.height;
+
+            occluders.push_back(aabb::from_min_max(min, max));
+        }
+
+        return occluders;
+    }
+}
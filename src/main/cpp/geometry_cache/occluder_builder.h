@@ -0,0 +1,40 @@
+/*!
+ * \brief Finds the big flat parts of a chunk section, for the occlusion culler to hide other sections behind
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_OCCLUDER_BUILDER_H
+#define RENDERER_OCCLUDER_BUILDER_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief The most occluders that one chunk section gets. The biggest ones are kept
+     */
+    const std::size_t MAX_OCCLUDERS_PER_SECTION = 32;
+
+    /*!
+     * \brief Builds occluders out of the whole block faces in a chunk section
+     *
+     * Every quad that covers exactly one face of a block is marked on a 16x16 grid for the plane it's in. Which way the
+     * face points doesn't matter, since it hides things from both sides. Each grid is then covered greedily with
+     * rectangles, and the largest rectangles become occluders. Partial faces, like slabs and torches, never become
+     * occluders, so an occluder is always something solid that's at least one block big.
+     *
+     * That does assume the faces aren't see-through, so only geometry from opaque blocks should be given to this
+     *
+     * \param src The Minecraft vertices, relative to the section's minimum corner. Must be a list of quads
+     * \param num_vertices The number of vertices in src
+     * \param origin The section's minimum corner in world space. It's added to the occluders
+     * \return The occluders, as boxes with no thickness along the axis they face, biggest first
+     */
+    std::vector<aabb> build_section_occluders(const int* src, std::size_t num_vertices, const glm::vec3& origin);
+}
+
+#endif //RENDERER_OCCLUDER_BUILDER_H
@@ -0,0 +1,120 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cmath>
+#include <cstring>
+#include "quad_facing.h"
+#include "vertex_kernels.h"
+
+namespace nova {
+    /*!
+     * \brief How much of a quad's normal has to be along one axis for the quad to count as facing along it
+     */
+    static const float AXIS_ALIGNMENT = 0.999f;
+
+    bool quad_facing_ranges::is_sorted() const {
+        return first_quad[NUM_FACING_RANGES] > 0;
+    }
+
+    int get_mc_quad_facing(const int* quad) {
+        glm::vec3 corners[3];
+        for(int vertex = 0; vertex < 3; vertex++) {
+            float position[3];
+            std::memcpy(position, quad + vertex * MC_VERTEX_SIZE_INTS, sizeof(position));
+            corners[vertex] = {position[0], position[1], position[2]};
+        }
+
+        // The same winding that compact_mc_vertices gets its normals from, so the front of the quad is the side that
+        // back face culling keeps
+        glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        float length = glm::length(normal);
+        if(length < 1e-12f) {
+            return FACING_ANY;
+        }
+        normal /= length;
+
+        for(int axis = 0; axis < 3; axis++) {
+            if(std::abs(normal[axis]) >= AXIS_ALIGNMENT) {
+                // section_face goes -y, +y, -z, +z, -x, +x
+                static const int first_face_of_axis[3] = {FACE_WEST, FACE_DOWN, FACE_NORTH};
+                return first_face_of_axis[axis] + (normal[axis] > 0 ? 1 : 0);
+            }
+        }
+
+        return FACING_ANY;
+    }
+
+    quad_facing_ranges sort_mc_quads_by_facing(const int* src, std::size_t num_vertices, std::vector<int>& dst,
+                                               std::vector<std::uint16_t>& quad_slots) {
+        const std::size_t quad_size_ints = VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+        std::size_t num_quads = num_vertices / VERTICES_PER_QUAD;
+
+        std::vector<std::uint8_t> facings(num_quads);
+        quad_facing_ranges ranges = {};
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            facings[quad] = static_cast<std::uint8_t>(get_mc_quad_facing(src + quad * quad_size_ints));
+            ranges.first_quad[facings[quad] + 1]++;
+        }
+
+        // Counts to offsets
+        for(std::size_t range = 1; range <= NUM_FACING_RANGES; range++) {
+            ranges.first_quad[range] += ranges.first_quad[range - 1];
+        }
+
+        std::uint32_t next_quad[NUM_FACING_RANGES];
+        std::memcpy(next_quad, ranges.first_quad, sizeof(next_quad));
+
+        dst.resize(num_quads * quad_size_ints);
+        quad_slots.resize(num_quads);
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            std::uint32_t slot = next_quad[facings[quad]]++;
+            quad_slots[quad] = static_cast<std::uint16_t>(slot);
+            std::memcpy(&dst[slot * quad_size_ints], src + quad * quad_size_ints, quad_size_ints * sizeof(int));
+        }
+
+        return ranges;
+    }
+
+    std::uint8_t get_visible_facings(const aabb& bounds, const glm::vec3& camera_position) {
+        glm::vec3 min = bounds.get_min();
+        glm::vec3 max = bounds.get_max();
+
+        std::uint8_t visible = 1 << FACING_ANY;
+        visible |= (camera_position.y < max.y) << FACE_DOWN;
+        visible |= (camera_position.y > min.y) << FACE_UP;
+        visible |= (camera_position.z < max.z) << FACE_NORTH;
+        visible |= (camera_position.z > min.z) << FACE_SOUTH;
+        visible |= (camera_position.x < max.x) << FACE_WEST;
+        visible |= (camera_position.x > min.x) << FACE_EAST;
+        return visible;
+    }
+
+    std::size_t get_visible_quad_runs(const quad_facing_ranges& ranges, std::uint8_t visible_facings, quad_run* runs,
+                                      facing_cull_stats& stats) {
+        std::size_t num_runs = 0;
+        for(std::size_t range = 0; range < NUM_FACING_RANGES; range++) {
+            std::uint32_t range_start = ranges.first_quad[range];
+            std::uint32_t range_end = ranges.first_quad[range + 1];
+            if(range_start == range_end) {
+                continue;
+            }
+
+            if((visible_facings & (1 << range)) == 0) {
+                stats.num_ranges_skipped++;
+                stats.num_quads_skipped += range_end - range_start;
+                continue;
+            }
+
+            auto* last_run = num_runs > 0 ? &runs[num_runs - 1] : nullptr;
+            if(last_run != nullptr && last_run->first_quad + last_run->num_quads == range_start) {
+                last_run->num_quads += range_end - range_start;
+            } else {
+                runs[num_runs++] = {range_start, range_end - range_start};
+            }
+        }
+
+        return num_runs;
+    }
+}
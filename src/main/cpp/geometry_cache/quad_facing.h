@@ -0,0 +1,109 @@
+/*!
+ * \brief Groups a chunk section's quads by which way they face, so that the groups facing away from the camera can be
+ * skipped
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_QUAD_FACING_H
+#define RENDERER_QUAD_FACING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "section_connectivity.h"
+#include "../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief Quads that don't face straight along an axis, like the crossed quads of plants, go in the range after the
+     * six section_faces
+     */
+    const int FACING_ANY = NUM_SECTION_FACES;
+
+    const std::size_t NUM_FACING_RANGES = NUM_SECTION_FACES + 1;
+
+    /*!
+     * \brief The most quads that sort_mc_quads_by_facing can sort, since where each quad went is kept in 16 bits
+     */
+    const std::size_t MAX_SORTED_QUADS = 65536;
+
+    /*!
+     * \brief Where each facing's quads are in a mesh whose quads have been sorted by sort_mc_quads_by_facing
+     *
+     * The quads facing each section_face, in order, and then the quads facing any other way. Range r is the quads from
+     * first_quad[r] up to first_quad[r + 1]. A mesh that hasn't been sorted has all zeros
+     */
+    struct quad_facing_ranges {
+        std::uint32_t first_quad[NUM_FACING_RANGES + 1];
+
+        bool is_sorted() const;
+    };
+
+    /*!
+     * \brief How many quads facing away from the camera weren't drawn
+     */
+    struct facing_cull_stats {
+        std::size_t num_ranges_skipped;
+        std::size_t num_quads_skipped;
+    };
+
+    /*!
+     * \brief A run of quads next to each other in a mesh
+     */
+    struct quad_run {
+        std::uint32_t first_quad;
+        std::uint32_t num_quads;
+    };
+
+    /*!
+     * \brief Works out which way a quad of Minecraft vertices faces, from the winding of its first three corners
+     *
+     * \return The section_face the quad faces, or FACING_ANY if it doesn't face along an axis
+     */
+    int get_mc_quad_facing(const int* quad);
+
+    /*!
+     * \brief Reorders a list of Minecraft quads so that the quads facing each way are next to each other
+     *
+     * Quads keep their order within each facing
+     *
+     * \param src The Minecraft vertices. Must be whole quads
+     * \param num_vertices The number of vertices in src
+     * \param dst Filled with the sorted vertices
+     * \param quad_slots Filled with where each quad of src ended up in dst
+     * \return Where each facing's quads are in dst
+     */
+    quad_facing_ranges sort_mc_quads_by_facing(const int* src, std::size_t num_vertices, std::vector<int>& dst,
+                                               std::vector<std::uint16_t>& quad_slots);
+
+    /*!
+     * \brief Returns a bit for each facing range that might have a quad facing the camera. The FACING_ANY range is
+     * always included
+     *
+     * A quad can only be seen from in front of the plane it's in. Every quad is inside the bounds, so when the camera
+     * is, say, below the bottom of the bounds, none of the upwards facing quads can be seen
+     *
+     * \param bounds The bounds of the quads, in world space
+     * \param camera_position Where the camera is, in world space
+     */
+    std::uint8_t get_visible_facings(const aabb& bounds, const glm::vec3& camera_position);
+
+    /*!
+     * \brief Finds the runs of quads to draw so that only the given facings are drawn
+     *
+     * Visible ranges next to each other go in one run. Empty ranges don't split them up
+     *
+     * \param ranges Where the quads facing each way are
+     * \param visible_facings A bit for each range to draw, like get_visible_facings returns
+     * \param runs Filled with the runs to draw. Must have room for NUM_FACING_RANGES runs
+     * \param stats The ranges that aren't drawn are added to this
+     * \return How many runs were written to runs
+     */
+    std::size_t get_visible_quad_runs(const quad_facing_ranges& ranges, std::uint8_t visible_facings, quad_run* runs,
+                                      facing_cull_stats& stats);
+}
+
+#endif //RENDERER_QUAD_FACING_H
@@ -0,0 +1,106 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include "quad_layout.h"
+
+namespace nova {
+    static const std::size_t MAX_SLOTS = std::numeric_limits<std::uint16_t>::max() + static_cast<std::size_t>(1);
+
+    quad_layout::quad_layout(std::size_t num_quads, std::size_t capacity) :
+            capacity(std::min(std::max(capacity, num_quads), MAX_SLOTS)) {
+        num_quads = std::min(num_quads, this->capacity);
+
+        slots.resize(num_quads);
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            slots[quad] = static_cast<std::uint16_t>(quad);
+        }
+
+        // Ascending order is already a valid min-heap
+        for(std::size_t slot = num_quads; slot < this->capacity; slot++) {
+            free_slots.push_back(static_cast<std::uint16_t>(slot));
+        }
+
+        num_slots_to_draw = num_quads;
+    }
+
+    quad_layout::quad_layout(const std::vector<std::uint16_t>& quad_slots, std::size_t capacity) :
+            slots(quad_slots), capacity(std::min(std::max(capacity, quad_slots.size()), MAX_SLOTS)) {
+        for(std::size_t slot = slots.size(); slot < this->capacity; slot++) {
+            free_slots.push_back(static_cast<std::uint16_t>(slot));
+        }
+
+        num_slots_to_draw = slots.size();
+    }
+
+    bool quad_layout::splice(std::size_t first_quad, std::size_t num_removed, std::size_t num_added,
+                             std::vector<quad_slot_write>& writes) {
+        if(first_quad > slots.size() || num_removed > slots.size() - first_quad) {
+            return false;
+        }
+
+        if(num_added > free_slots.size() + num_removed) {
+            return false;
+        }
+
+        std::size_t first_write = writes.size();
+        auto lowest_first = std::greater<std::uint16_t>();
+
+        // Reuse the replaced quads' slots first, since their old contents have to be overwritten anyway
+        std::vector<std::uint16_t> new_slots;
+        new_slots.reserve(num_added);
+        for(std::size_t i = 0; i < num_added; i++) {
+            if(i < num_removed) {
+                new_slots.push_back(slots[first_quad + i]);
+
+            } else {
+                std::pop_heap(free_slots.begin(), free_slots.end(), lowest_first);
+                new_slots.push_back(free_slots.back());
+                free_slots.pop_back();
+            }
+
+            writes.push_back({new_slots.back(), static_cast<long>(i)});
+        }
+
+        for(std::size_t i = num_added; i < num_removed; i++) {
+            std::uint16_t slot = slots[first_quad + i];
+            free_slots.push_back(slot);
+            std::push_heap(free_slots.begin(), free_slots.end(), lowest_first);
+
+            writes.push_back({slot, -1});
+        }
+
+        auto first = slots.begin() + first_quad;
+        first = slots.erase(first, first + num_removed);
+        slots.insert(first, new_slots.begin(), new_slots.end());
+
+        auto highest_slot = std::max_element(slots.begin(), slots.end());
+        num_slots_to_draw = highest_slot == slots.end() ? 0 : *highest_slot + static_cast<std::size_t>(1);
+
+        std::sort(writes.begin() + first_write, writes.end(), [](const quad_slot_write& a, const quad_slot_write& b) {
+            return a.slot < b.slot;
+        });
+
+        return true;
+    }
+
+    std::size_t quad_layout::size() const {
+        return slots.size();
+    }
+
+    std::size_t quad_layout::get_capacity() const {
+        return capacity;
+    }
+
+    std::size_t quad_layout::get_num_slots_to_draw() const {
+        return num_slots_to_draw;
+    }
+
+    std::size_t quad_layout::get_slot(std::size_t quad) const {
+        return slots[quad];
+    }
+}
@@ -0,0 +1,114 @@
+/*!
+ * \brief Keeps track of which quad of a chunk section lives where in the section's mesh, so that the section can be
+ * patched in place
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_QUAD_LAYOUT_H
+#define RENDERER_QUAD_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief One quad that has to be written to a mesh after a quad_layout has been spliced
+     */
+    struct quad_slot_write {
+        /*!
+         * \brief Which of the mesh's quads to write
+         */
+        std::size_t slot;
+
+        /*!
+         * \brief Which of the spliced-in quads goes in the slot, or -1 if the slot was freed and should be filled with a
+         * degenerate quad
+         */
+        long source_quad;
+    };
+
+    /*!
+     * \brief Maps the quads that Minecraft knows about onto the quads of a mesh that has room for more than it holds
+     *
+     * Minecraft numbers a chunk section's quads in the order it built them. When a block changes, it replaces a run of
+     * those quads with a different number of new ones. Shifting everything after the run down the vertex buffer would
+     * mean uploading most of the section again, so instead each of Minecraft's quads is given a slot in the mesh, and
+     * new quads go in whatever slots are free. Freed slots are filled with degenerate quads, which draw nothing.
+     *
+     * Lower slots are always handed out first, so the quads that need to be drawn stay packed towards the start of the
+     * mesh
+     */
+    class quad_layout {
+    public:
+        /*!
+         * \brief Makes a layout with no room at all, for sections that can't be patched
+         */
+        quad_layout() = default;
+
+        /*!
+         * \brief Makes a layout where quad N is in slot N
+         *
+         * \param num_quads How many quads the mesh starts with
+         * \param capacity How many quads the mesh has room for. At most 65536
+         */
+        quad_layout(std::size_t num_quads, std::size_t capacity);
+
+        /*!
+         * \brief Makes a layout for a mesh whose quads have been moved around, like by sort_mc_quads_by_facing
+         *
+         * \param quad_slots The slot that each quad is in. Must use every slot below its size exactly once
+         * \param capacity How many quads the mesh has room for. At most 65536
+         */
+        quad_layout(const std::vector<std::uint16_t>& quad_slots, std::size_t capacity);
+
+        /*!
+         * \brief Replaces a run of quads with a different number of new ones
+         *
+         * Nothing changes if the run is out of range or if there aren't enough free slots for the new quads
+         *
+         * \param first_quad The first quad to replace
+         * \param num_removed How many quads to replace
+         * \param num_added How many quads to put in their place
+         * \param writes The quads that have to be written to the mesh are added to the end of this, sorted by slot
+         * \return True if the layout was changed, false if it couldn't be
+         */
+        bool splice(std::size_t first_quad, std::size_t num_removed, std::size_t num_added,
+                    std::vector<quad_slot_write>& writes);
+
+        /*!
+         * \brief Returns how many quads Minecraft thinks the section has
+         */
+        std::size_t size() const;
+
+        std::size_t get_capacity() const;
+
+        /*!
+         * \brief Returns how many slots, starting from the first one, have to be drawn to draw every quad
+         */
+        std::size_t get_num_slots_to_draw() const;
+
+        /*!
+         * \brief Returns the slot that the given quad is in
+         */
+        std::size_t get_slot(std::size_t quad) const;
+
+    private:
+        /*!
+         * \brief The slot that each of Minecraft's quads is in
+         */
+        std::vector<std::uint16_t> slots;
+
+        /*!
+         * \brief The slots that aren't in use, as a min-heap so the lowest one comes out first
+         */
+        std::vector<std::uint16_t> free_slots;
+
+        std::size_t capacity = 0;
+        std::size_t num_slots_to_draw = 0;
+    };
+}
+
+#endif //RENDERER_QUAD_LAYOUT_H
@@ -0,0 +1,394 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "quad_merger.h"
+#include "vertex_kernels.h"
+
+namespace nova {
+    static const std::size_t QUAD_SIZE_INTS = VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+
+    /*!
+     * \brief Everything that has to match for two faces to be merged
+     *
+     * In order: facing, plane, min U, min V, max U, max V, color, lightmap, corner order, UV orientation
+     */
+    using merge_key = std::array<int, 10>;
+
+    enum merge_key_field {
+        KEY_FACING = 0,
+        KEY_UV_MIN_U = 2,
+        KEY_UV_MIN_V = 3,
+        KEY_CORNERS = 8,
+        KEY_UV_ORIENTATION = 9
+    };
+
+    // Bits of the UV orientation
+    static const int U_FOLLOWS_B = 1;
+    static const int U_FLIPPED = 2;
+    static const int V_FLIPPED = 4;
+
+    /*!
+     * \brief A block face that can be merged with its neighbors
+     */
+    struct mergeable_quad {
+        merge_key key;
+
+        /*!
+         * \brief The block coordinates of the face's minimum corner along the two axes in its plane
+         */
+        int a;
+        int b;
+
+        const int* vertices;
+    };
+
+    static float read_float(const int* src) {
+        float value;
+        std::memcpy(&value, src, sizeof(float));
+        return value;
+    }
+
+    static int float_bits(float value) {
+        int bits;
+        std::memcpy(&bits, &value, sizeof(int));
+        return bits;
+    }
+
+    /*!
+     * \brief Converts a tile size in UV space into 1/TILE_SIZE_SCALEs of the atlas, or returns 0 if that can't be done
+     * exactly
+     */
+    static int encode_tile_size(float size) {
+        float scaled = size * TILE_SIZE_SCALE;
+        float rounded = std::round(scaled);
+        if(std::abs(scaled - rounded) > 1e-3f || rounded < 1 || rounded > 255) {
+            return 0;
+        }
+
+        return static_cast<int>(rounded);
+    }
+
+    /*!
+     * \brief Works out if a quad is a whole block face that can be merged, and if so fills in how to merge it
+     */
+    static bool classify_quad(const int* quad, mergeable_quad& out) {
+        float positions[VERTICES_PER_QUAD][3];
+        float uvs[VERTICES_PER_QUAD][2];
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            const int* vertex = quad + i * MC_VERTEX_SIZE_INTS;
+            for(int axis = 0; axis < 3; axis++) {
+                positions[i][axis] = read_float(vertex + axis);
+            }
+            uvs[i][0] = read_float(vertex + 4);
+            uvs[i][1] = read_float(vertex + 5);
+
+            // Smooth lighting and biome tints that vary across a face can't be stretched over a bigger quad
+            if(vertex[3] != quad[3] || vertex[6] != quad[6]) {
+                return false;
+            }
+        }
+
+        float e1[3], e2[3];
+        for(int axis = 0; axis < 3; axis++) {
+            e1[axis] = positions[1][axis] - positions[0][axis];
+            e2[axis] = positions[2][axis] - positions[0][axis];
+        }
+        float normal[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0]
+        };
+
+        int facing_axis = 0;
+        for(int axis = 1; axis < 3; axis++) {
+            if(std::abs(normal[axis]) > std::abs(normal[facing_axis])) {
+                facing_axis = axis;
+            }
+        }
+
+        int a_axis = (facing_axis + 1) % 3;
+        int b_axis = (facing_axis + 2) % 3;
+        if(normal[facing_axis] == 0 || normal[a_axis] != 0 || normal[b_axis] != 0) {
+            return false;
+        }
+
+        float plane = positions[0][facing_axis];
+        float a_min = positions[0][a_axis], b_min = positions[0][b_axis];
+        float u_min = uvs[0][0], u_max = uvs[0][0];
+        float v_min = uvs[0][1], v_max = uvs[0][1];
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            if(positions[i][facing_axis] != plane) {
+                return false;
+            }
+            a_min = std::min(a_min, positions[i][a_axis]);
+            b_min = std::min(b_min, positions[i][b_axis]);
+            u_min = std::min(u_min, uvs[i][0]);
+            u_max = std::max(u_max, uvs[i][0]);
+            v_min = std::min(v_min, uvs[i][1]);
+            v_max = std::max(v_max, uvs[i][1]);
+        }
+
+        // Only whole block faces line up with their neighbors
+        if(a_min != std::floor(a_min) || b_min != std::floor(b_min)) {
+            return false;
+        }
+
+        if(encode_tile_size(u_max - u_min) == 0 || encode_tile_size(v_max - v_min) == 0) {
+            return false;
+        }
+
+        int corners = 0;
+        int used_corners = 0;
+        bool is_a_max[VERTICES_PER_QUAD], is_b_max[VERTICES_PER_QUAD];
+        bool is_u_max[VERTICES_PER_QUAD], is_v_max[VERTICES_PER_QUAD];
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            float a = positions[i][a_axis];
+            float b = positions[i][b_axis];
+            if((a != a_min && a != a_min + 1) || (b != b_min && b != b_min + 1)) {
+                return false;
+            }
+
+            float u = uvs[i][0];
+            float v = uvs[i][1];
+            if((u != u_min && u != u_max) || (v != v_min && v != v_max)) {
+                return false;
+            }
+
+            is_a_max[i] = a != a_min;
+            is_b_max[i] = b != b_min;
+            is_u_max[i] = u == u_max;
+            is_v_max[i] = v == v_max;
+
+            int corner = (is_a_max[i] ? 1 : 0) | (is_b_max[i] ? 2 : 0);
+            if(used_corners & (1 << corner)) {
+                // Two vertices in the same corner
+                return false;
+            }
+            used_corners |= 1 << corner;
+            corners |= corner << (2 * i);
+        }
+
+        // The texture can be rotated or flipped, but each of U and V has to run along one edge of the face
+        int orientation = -1;
+        for(int candidate = 0; candidate < 8 && orientation < 0; candidate++) {
+            bool u_follows_b = (candidate & U_FOLLOWS_B) != 0;
+            bool u_flipped = (candidate & U_FLIPPED) != 0;
+            bool v_flipped = (candidate & V_FLIPPED) != 0;
+
+            bool matches = true;
+            for(std::size_t i = 0; i < VERTICES_PER_QUAD && matches; i++) {
+                bool u_axis_max = u_follows_b ? is_b_max[i] : is_a_max[i];
+                bool v_axis_max = u_follows_b ? is_a_max[i] : is_b_max[i];
+                matches = is_u_max[i] == (u_axis_max != u_flipped) && is_v_max[i] == (v_axis_max != v_flipped);
+            }
+
+            if(matches) {
+                orientation = candidate;
+            }
+        }
+
+        if(orientation < 0) {
+            return false;
+        }
+
+        int facing = facing_axis * 2 + (normal[facing_axis] > 0 ? 1 : 0);
+        out.key = {facing, float_bits(plane), float_bits(u_min), float_bits(v_min), float_bits(u_max),
+                   float_bits(v_max), quad[3], quad[6], corners, orientation};
+        out.a = static_cast<int>(a_min);
+        out.b = static_cast<int>(b_min);
+        out.vertices = quad;
+
+        return true;
+    }
+
+    /*!
+     * \brief Writes one quad that covers width x height faces, starting at the given face
+     */
+    static void emit_merged_quad(const mergeable_quad& first, int width, int height, std::vector<int>& dst) {
+        const auto& key = first.key;
+        int facing_axis = key[KEY_FACING] / 2;
+        int a_axis = (facing_axis + 1) % 3;
+        int b_axis = (facing_axis + 2) % 3;
+
+        int orientation = key[KEY_UV_ORIENTATION];
+        int u_extent = (orientation & U_FOLLOWS_B) ? height : width;
+        int v_extent = (orientation & U_FOLLOWS_B) ? width : height;
+
+        float u_min = read_float(&key[KEY_UV_MIN_U]);
+        float v_min = read_float(&key[KEY_UV_MIN_V]);
+        auto tile_width = static_cast<std::uint8_t>(encode_tile_size(read_float(&key[KEY_UV_MIN_U + 2]) - u_min));
+        auto tile_height = static_cast<std::uint8_t>(encode_tile_size(read_float(&key[KEY_UV_MIN_V + 2]) - v_min));
+
+        int merged[QUAD_SIZE_INTS];
+        std::memcpy(merged, first.vertices, sizeof(merged));
+
+        std::uint8_t tiles[VERTICES_PER_QUAD][4];
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            int* vertex = merged + i * MC_VERTEX_SIZE_INTS;
+            int corner = (key[KEY_CORNERS] >> (2 * i)) & 3;
+            bool is_a_max = (corner & 1) != 0;
+            bool is_b_max = (corner & 2) != 0;
+
+            float position[3];
+            std::memcpy(position, vertex, sizeof(position));
+            position[a_axis] = static_cast<float>(first.a + (is_a_max ? width : 0));
+            position[b_axis] = static_cast<float>(first.b + (is_b_max ? height : 0));
+            std::memcpy(vertex, position, sizeof(position));
+
+            vertex[4] = key[KEY_UV_MIN_U];
+            vertex[5] = key[KEY_UV_MIN_V];
+
+            bool u_axis_max = (orientation & U_FOLLOWS_B) ? is_b_max : is_a_max;
+            bool v_axis_max = (orientation & U_FOLLOWS_B) ? is_a_max : is_b_max;
+            bool at_u_max = u_axis_max != ((orientation & U_FLIPPED) != 0);
+            bool at_v_max = v_axis_max != ((orientation & V_FLIPPED) != 0);
+
+            tiles[i][0] = static_cast<std::uint8_t>(at_u_max ? u_extent : 0);
+            tiles[i][1] = static_cast<std::uint8_t>(at_v_max ? v_extent : 0);
+            tiles[i][2] = tile_width;
+            tiles[i][3] = tile_height;
+        }
+
+        std::size_t start = dst.size();
+        dst.resize(start + VERTICES_PER_QUAD * COMPACT_VERTEX_SIZE_INTS);
+        compact_mc_vertices(merged, VERTICES_PER_QUAD, &dst[start]);
+
+        // The tangent is the last int of each compact vertex
+        for(std::size_t i = 0; i < VERTICES_PER_QUAD; i++) {
+            std::memcpy(&dst[start + (i + 1) * COMPACT_VERTEX_SIZE_INTS - 1], tiles[i], sizeof(tiles[i]));
+        }
+    }
+
+    static void emit_quad(const int* quad, std::vector<int>& dst) {
+        std::size_t start = dst.size();
+        dst.resize(start + VERTICES_PER_QUAD * COMPACT_VERTEX_SIZE_INTS);
+        compact_mc_vertices(quad, VERTICES_PER_QUAD, &dst[start]);
+    }
+
+    /*!
+     * \brief Greedily merges faces that all have the same key
+     *
+     * \return The number of quads written
+     */
+    static std::size_t merge_group(const mergeable_quad* quads, std::size_t num_quads, std::vector<int>& dst) {
+        int min_a = quads[0].a, max_a = quads[0].a;
+        int min_b = quads[0].b, max_b = quads[0].b;
+        for(std::size_t i = 1; i < num_quads; i++) {
+            min_a = std::min(min_a, quads[i].a);
+            max_a = std::max(max_a, quads[i].a);
+            min_b = std::min(min_b, quads[i].b);
+            max_b = std::max(max_b, quads[i].b);
+        }
+
+        int columns = max_a - min_a + 1;
+        int rows = max_b - min_b + 1;
+        std::vector<const mergeable_quad*> grid(static_cast<std::size_t>(columns * rows), nullptr);
+        auto cell = [&](int a, int b) -> const mergeable_quad*& {
+            return grid[(a - min_a) + (b - min_b) * columns];
+        };
+
+        std::size_t num_written = 0;
+        for(std::size_t i = 0; i < num_quads; i++) {
+            auto& slot = cell(quads[i].a, quads[i].b);
+            if(slot != nullptr) {
+                // The same face twice. Keep them both, but only merge one of them
+                emit_quad(quads[i].vertices, dst);
+                num_written++;
+                continue;
+            }
+            slot = &quads[i];
+        }
+
+        for(int b = min_b; b <= max_b; b++) {
+            for(int a = min_a; a <= max_a; a++) {
+                const mergeable_quad* first = cell(a, b);
+                if(first == nullptr) {
+                    continue;
+                }
+
+                int width = 1;
+                while(a + width <= max_a && cell(a + width, b) != nullptr) {
+                    width++;
+                }
+
+                int height = 1;
+                while(b + height <= max_b) {
+                    bool row_is_full = true;
+                    for(int x = a; x < a + width && row_is_full; x++) {
+                        row_is_full = cell(x, b + height) != nullptr;
+                    }
+                    if(!row_is_full) {
+                        break;
+                    }
+                    height++;
+                }
+
+                for(int y = b; y < b + height; y++) {
+                    for(int x = a; x < a + width; x++) {
+                        cell(x, y) = nullptr;
+                    }
+                }
+
+                if(width == 1 && height == 1) {
+                    emit_quad(first->vertices, dst);
+                } else {
+                    emit_merged_quad(*first, width, height, dst);
+                }
+                num_written++;
+            }
+        }
+
+        return num_written;
+    }
+
+    float quad_merge_stats::get_triangle_reduction() const {
+        if(num_input_quads == 0) {
+            return 0;
+        }
+
+        return 1.0f - static_cast<float>(num_output_quads) / static_cast<float>(num_input_quads);
+    }
+
+    quad_merge_stats merge_coplanar_quads(const int* src, std::size_t num_vertices, std::vector<int>& dst) {
+        quad_merge_stats stats;
+        stats.num_input_quads = num_vertices / VERTICES_PER_QUAD;
+
+        std::vector<mergeable_quad> mergeable;
+        mergeable.reserve(stats.num_input_quads);
+
+        for(std::size_t quad = 0; quad < stats.num_input_quads; quad++) {
+            const int* quad_vertices = src + quad * QUAD_SIZE_INTS;
+
+            mergeable_quad classified;
+            if(classify_quad(quad_vertices, classified)) {
+                mergeable.push_back(classified);
+            } else {
+                emit_quad(quad_vertices, dst);
+                stats.num_output_quads++;
+            }
+        }
+
+        std::sort(mergeable.begin(), mergeable.end(), [](const mergeable_quad& lhs, const mergeable_quad& rhs) {
+            return lhs.key < rhs.key;
+        });
+
+        for(std::size_t group_start = 0; group_start < mergeable.size();) {
+            std::size_t group_end = group_start + 1;
+            while(group_end < mergeable.size() && mergeable[group_end].key == mergeable[group_start].key) {
+                group_end++;
+            }
+
+            stats.num_output_quads += merge_group(&mergeable[group_start], group_end - group_start, dst);
+            group_start = group_end;
+        }
+
+        return stats;
+    }
+}
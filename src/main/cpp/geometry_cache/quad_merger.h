@@ -0,0 +1,62 @@
+/*!
+ * \brief Merges neighboring block faces that look the same into bigger quads
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_QUAD_MERGER_H
+#define RENDERER_QUAD_MERGER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Tile sizes in merged quads are stored in units of 1/TILE_SIZE_SCALE of the atlas
+     *
+     * That's exact for any power-of-two tile in a power-of-two atlas, as long as the tile is between 1/2048th and
+     * 255/2048ths of the atlas wide. A 16x16 texture fits from a 128x128 atlas up to a 32768x32768 one
+     */
+    const float TILE_SIZE_SCALE = 2048;
+
+    /*!
+     * \brief How much merge_coplanar_quads got rid of
+     */
+    struct quad_merge_stats {
+        std::size_t num_input_quads = 0;
+        std::size_t num_output_quads = 0;
+
+        /*!
+         * \brief Returns the fraction of triangles that merging removed, from 0 (nothing merged) to just under 1
+         */
+        float get_triangle_reduction() const;
+    };
+
+    /*!
+     * \brief Merges neighboring coplanar block faces into bigger quads and packs the result into
+     * COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT vertices
+     *
+     * Two faces are merged if they're whole, axis-aligned block faces in the same plane that face the same way and
+     * have the same texture coordinates, color and lightmap value at every corner. Merging goes greedily along rows,
+     * then stretches each row as far as it can go in the other direction.
+     *
+     * Texture atlases can't repeat a texture with plain UVs, so merged quads are drawn in repeat-UV mode. Their texture
+     * UV is the minimum corner of the texture in the atlas, and their tangent slot holds four unsigned bytes instead of
+     * a tangent: how many times the texture repeats along U and along V at that vertex, then the width and height of
+     * the texture in 1/TILE_SIZE_SCALE of the atlas. A shader gets the atlas UV with
+     * `uv + fract(tile.xy) * tile.zw / TILE_SIZE_SCALE`. Faces that aren't merged have a tangent slot of zero.
+     *
+     * Everything that can't be merged is packed as is. The output is always a plain list of quads, so it doesn't need
+     * indices
+     *
+     * \param src The Minecraft vertices, relative to the section's minimum corner. Must be a list of quads, four
+     * vertices each
+     * \param num_vertices The number of vertices in src
+     * \param dst The compact vertices are added to the end of this
+     * \return How many quads went in and how many came out
+     */
+    quad_merge_stats merge_coplanar_quads(const int* src, std::size_t num_vertices, std::vector<int>& dst);
+}
+
+#endif //RENDERER_QUAD_MERGER_H
@@ -0,0 +1,120 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <bitset>
+#include <vector>
+#include "section_connectivity.h"
+
+namespace nova {
+    static const int SECTION_SIZE = 16;
+    static const int NUM_BLOCKS = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+
+    /*!
+     * \brief A whole plane of opaque blocks is the least it takes to cut a section in two
+     */
+    static const int MIN_OPAQUE_BLOCKS_TO_SEPARATE = SECTION_SIZE * SECTION_SIZE;
+
+    static int get_pair_bit(section_face a, section_face b) {
+        int low = a < b ? a : b;
+        int high = a < b ? b : a;
+        return low * (11 - low) / 2 + (high - low - 1);
+    }
+
+    static bool is_opaque(const std::uint64_t* opaque, int block) {
+        return ((opaque[block / 64] >> (block % 64)) & 1) != 0;
+    }
+
+    section_face get_opposite_face(section_face face) {
+        return static_cast<section_face>(face ^ 1);
+    }
+
+    bool faces_connect(section_connectivity connectivity, section_face a, section_face b) {
+        if(a == b) {
+            return true;
+        }
+        return ((connectivity >> get_pair_bit(a, b)) & 1) != 0;
+    }
+
+    /*!
+     * \brief Returns a bit for each face of the section that the block is on
+     */
+    static std::uint8_t get_faces_touched(int x, int y, int z) {
+        std::uint8_t faces = 0;
+        faces |= (y == 0) << FACE_DOWN;
+        faces |= (y == SECTION_SIZE - 1) << FACE_UP;
+        faces |= (z == 0) << FACE_NORTH;
+        faces |= (z == SECTION_SIZE - 1) << FACE_SOUTH;
+        faces |= (x == 0) << FACE_WEST;
+        faces |= (x == SECTION_SIZE - 1) << FACE_EAST;
+        return faces;
+    }
+
+    section_connectivity compute_section_connectivity(const std::uint64_t* opaque) {
+        int num_opaque = 0;
+        for(std::size_t word = 0; word < SECTION_OPACITY_WORDS; word++) {
+            num_opaque += static_cast<int>(std::bitset<64>(opaque[word]).count());
+        }
+        if(num_opaque < MIN_OPAQUE_BLOCKS_TO_SEPARATE) {
+            return ALL_FACES_CONNECTED;
+        }
+
+        std::bitset<NUM_BLOCKS> visited;
+        std::vector<int> to_visit;
+        section_connectivity connectivity = 0;
+
+        for(int start = 0; start < NUM_BLOCKS; start++) {
+            int start_x = start % SECTION_SIZE;
+            int start_z = (start / SECTION_SIZE) % SECTION_SIZE;
+            int start_y = start / (SECTION_SIZE * SECTION_SIZE);
+
+            // Groups that don't reach the edge of the section can't connect anything, so only the edges start fills
+            if(visited[start] || is_opaque(opaque, start) || get_faces_touched(start_x, start_y, start_z) == 0) {
+                continue;
+            }
+
+            std::uint8_t faces = 0;
+            visited[start] = true;
+            to_visit.push_back(start);
+            while(!to_visit.empty()) {
+                int block = to_visit.back();
+                to_visit.pop_back();
+
+                int x = block % SECTION_SIZE;
+                int z = (block / SECTION_SIZE) % SECTION_SIZE;
+                int y = block / (SECTION_SIZE * SECTION_SIZE);
+                faces |= get_faces_touched(x, y, z);
+
+                const int neighbors[6] = {
+                        y > 0 ? block - SECTION_SIZE * SECTION_SIZE : -1,
+                        y < SECTION_SIZE - 1 ? block + SECTION_SIZE * SECTION_SIZE : -1,
+                        z > 0 ? block - SECTION_SIZE : -1,
+                        z < SECTION_SIZE - 1 ? block + SECTION_SIZE : -1,
+                        x > 0 ? block - 1 : -1,
+                        x < SECTION_SIZE - 1 ? block + 1 : -1
+                };
+                for(int neighbor : neighbors) {
+                    if(neighbor >= 0 && !visited[neighbor] && !is_opaque(opaque, neighbor)) {
+                        visited[neighbor] = true;
+                        to_visit.push_back(neighbor);
+                    }
+                }
+            }
+
+            for(int a = 0; a < NUM_SECTION_FACES; a++) {
+                for(int b = a + 1; b < NUM_SECTION_FACES; b++) {
+                    if(((faces >> a) & 1) && ((faces >> b) & 1)) {
+                        connectivity |= 1 << get_pair_bit(static_cast<section_face>(a), static_cast<section_face>(b));
+                    }
+                }
+            }
+
+            if(connectivity == ALL_FACES_CONNECTED) {
+                break;
+            }
+        }
+
+        return connectivity;
+    }
+}
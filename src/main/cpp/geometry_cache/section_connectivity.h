@@ -0,0 +1,61 @@
+/*!
+ * \brief Works out which faces of a chunk section can be seen from which other faces
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_SECTION_CONNECTIVITY_H
+#define RENDERER_SECTION_CONNECTIVITY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nova {
+    /*!
+     * \brief The faces of a chunk section, in the same order as Minecraft's EnumFacing
+     */
+    enum section_face {
+        FACE_DOWN = 0,      //!< -y
+        FACE_UP = 1,        //!< +y
+        FACE_NORTH = 2,     //!< -z
+        FACE_SOUTH = 3,     //!< +z
+        FACE_WEST = 4,      //!< -x
+        FACE_EAST = 5,      //!< +x
+    };
+
+    const int NUM_SECTION_FACES = 6;
+
+    /*!
+     * \brief One bit for each of the 15 pairs of different faces, set if there's a path through the section's see-through
+     * blocks from one face of the pair to the other
+     */
+    typedef std::uint16_t section_connectivity;
+
+    const section_connectivity ALL_FACES_CONNECTED = 0x7FFF;
+
+    /*!
+     * \brief A chunk section's opaque blocks, one bit per block. Block (x, y, z) is bit x + z * 16 + y * 256, counting
+     * from the lowest bit of the first word
+     */
+    const std::size_t SECTION_OPACITY_WORDS = 64;
+
+    section_face get_opposite_face(section_face face);
+
+    /*!
+     * \brief Returns true if the two faces can see each other through the section. A face can always see itself
+     */
+    bool faces_connect(section_connectivity connectivity, section_face a, section_face b);
+
+    /*!
+     * \brief Flood fills the see-through blocks of a chunk section to find which of its faces can see each other
+     *
+     * Each group of connected see-through blocks connects every face that it touches. Sections with fewer than 256
+     * opaque blocks can't possibly wall one face off from another, so they're connected everywhere without looking
+     *
+     * \param opaque SECTION_OPACITY_WORDS words of opacity bits
+     */
+    section_connectivity compute_section_connectivity(const std::uint64_t* opaque);
+}
+
+#endif //RENDERER_SECTION_CONNECTIVITY_H
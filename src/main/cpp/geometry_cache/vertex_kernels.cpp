@@ -0,0 +1,216 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include "vertex_kernels.h"
+#include "../mc_interface/mc_objects.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace nova {
+    static void expand_mc_vertex_scalar(const int* src, int* dst) {
+        std::memcpy(dst, src, MC_VERTEX_SIZE_INTS * sizeof(int));
+        std::memset(dst + MC_VERTEX_SIZE_INTS, 0, (EXPANDED_VERTEX_SIZE_INTS - MC_VERTEX_SIZE_INTS) * sizeof(int));
+    }
+
+    void expand_mc_vertices(const int* src, std::size_t num_vertices, int* dst) {
+        std::size_t vertex = 0;
+
+#ifdef NOVA_HAS_SSE2
+        // Each vertex is two unaligned loads and four unaligned stores. The second load reads one int past the end of
+        // the vertex, and the zero stores overwrite that int in the output, so the last vertex is done the slow way to
+        // stay inside the source buffer
+        const __m128i zero = _mm_setzero_si128();
+        for(; vertex + 1 < num_vertices; vertex++) {
+            const int* in = src + vertex * MC_VERTEX_SIZE_INTS;
+            int* out = dst + vertex * EXPANDED_VERTEX_SIZE_INTS;
+
+            __m128i position_and_color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            __m128i uv_and_lightmap = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), position_and_color);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), uv_and_lightmap);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 7), zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 9), zero);
+        }
+#endif
+
+        for(; vertex < num_vertices; vertex++) {
+            expand_mc_vertex_scalar(src + vertex * MC_VERTEX_SIZE_INTS, dst + vertex * EXPANDED_VERTEX_SIZE_INTS);
+        }
+    }
+
+    std::vector<int> expand_mc_vertices(const int* src, std::size_t num_ints) {
+        std::size_t num_vertices = num_ints / MC_VERTEX_SIZE_INTS;
+
+        std::vector<int> expanded(num_vertices * EXPANDED_VERTEX_SIZE_INTS);
+        expand_mc_vertices(src, num_vertices, expanded.data());
+
+        return expanded;
+    }
+
+    static float int_bits_to_float(int bits) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    }
+
+    static std::uint16_t quantize_position(float position) {
+        float quantized = std::round((position + COMPACT_POSITION_BIAS) * COMPACT_POSITION_SCALE);
+        return static_cast<std::uint16_t>(std::min(std::max(quantized, 0.0f), 65535.0f));
+    }
+
+    static std::uint16_t quantize_unorm16(float value) {
+        return static_cast<std::uint16_t>(std::round(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f));
+    }
+
+    /*!
+     * \brief Packs a unit vector into GL_INT_2_10_10_10_REV, with a w of zero
+     */
+    static std::uint32_t pack_snorm_10_10_10_2(float x, float y, float z) {
+        auto pack_component = [](float value) {
+            auto quantized = static_cast<std::int32_t>(std::round(std::min(std::max(value, -1.0f), 1.0f) * 511.0f));
+            return static_cast<std::uint32_t>(quantized) & 0x3FF;
+        };
+
+        return pack_component(x) | (pack_component(y) << 10) | (pack_component(z) << 20);
+    }
+
+    static std::uint32_t compute_quad_normal(const int* quad) {
+        float p0[3], p1[3], p2[3];
+        for(int i = 0; i < 3; i++) {
+            p0[i] = int_bits_to_float(quad[i]);
+            p1[i] = int_bits_to_float(quad[MC_VERTEX_SIZE_INTS + i]);
+            p2[i] = int_bits_to_float(quad[2 * MC_VERTEX_SIZE_INTS + i]);
+        }
+
+        float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        float n[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0]
+        };
+
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if(length < 1e-12f) {
+            return 0;
+        }
+
+        return pack_snorm_10_10_10_2(n[0] / length, n[1] / length, n[2] / length);
+    }
+
+    static void compact_mc_vertex(const int* src, std::uint32_t normal, int* dst) {
+        std::uint16_t shorts[8];
+
+        shorts[0] = quantize_position(int_bits_to_float(src[0]));
+        shorts[1] = quantize_position(int_bits_to_float(src[1]));
+        shorts[2] = quantize_position(int_bits_to_float(src[2]));
+
+        // Minecraft packs the block light in the low short and the sky light in the high short, each from 0 to 240
+        auto lightmap = static_cast<std::uint32_t>(src[6]);
+        shorts[3] = static_cast<std::uint16_t>((lightmap & 0xFF) | (((lightmap >> 16) & 0xFF) << 8));
+
+        // Color is copied as-is, so its four bytes land in shorts 4 and 5
+        std::memcpy(&shorts[4], &src[3], sizeof(int));
+
+        shorts[6] = quantize_unorm16(int_bits_to_float(src[4]));
+        shorts[7] = quantize_unorm16(int_bits_to_float(src[5]));
+
+        std::memcpy(dst, shorts, sizeof(shorts));
+        dst[4] = static_cast<int>(normal);
+        dst[5] = 0;
+    }
+
+    void compact_mc_vertices(const int* src, std::size_t num_vertices, int* dst) {
+        const std::size_t vertices_per_quad = 4;
+        bool is_quads = num_vertices % vertices_per_quad == 0;
+
+        std::uint32_t normal = 0;
+        for(std::size_t vertex = 0; vertex < num_vertices; vertex++) {
+            const int* in = src + vertex * MC_VERTEX_SIZE_INTS;
+            if(is_quads && vertex % vertices_per_quad == 0) {
+                normal = compute_quad_normal(in);
+            }
+
+            compact_mc_vertex(in, normal, dst + vertex * COMPACT_VERTEX_SIZE_INTS);
+        }
+    }
+
+    std::vector<int> compact_mc_vertices(const int* src, std::size_t num_ints) {
+        std::size_t num_vertices = num_ints / MC_VERTEX_SIZE_INTS;
+
+        std::vector<int> compacted(num_vertices * COMPACT_VERTEX_SIZE_INTS);
+        compact_mc_vertices(src, num_vertices, compacted.data());
+
+        return compacted;
+    }
+
+    static const unsigned int quad_index_pattern[INDICES_PER_QUAD] = {0, 1, 2, 0, 2, 3};
+
+    bool is_quad_list(const int* indices, std::size_t num_indices, std::size_t num_vertices) {
+        if(num_indices == 0 || num_indices % INDICES_PER_QUAD != 0) {
+            return false;
+        }
+
+        std::size_t num_quads = num_indices / INDICES_PER_QUAD;
+        if(num_vertices != num_quads * 4) {
+            return false;
+        }
+
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            const int* quad_indices = indices + quad * INDICES_PER_QUAD;
+            for(std::size_t i = 0; i < INDICES_PER_QUAD; i++) {
+                if(quad_indices[i] != static_cast<int>(quad * 4 + quad_index_pattern[i])) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<unsigned int> make_quad_indices(std::size_t num_quads) {
+        std::vector<unsigned int> indices(num_quads * INDICES_PER_QUAD);
+        for(std::size_t quad = 0; quad < num_quads; quad++) {
+            for(std::size_t i = 0; i < INDICES_PER_QUAD; i++) {
+                indices[quad * INDICES_PER_QUAD + i] = static_cast<unsigned int>(quad * 4 + quad_index_pattern[i]);
+            }
+        }
+
+        return indices;
+    }
+
+    static float read_float(const int* src) {
+        float value;
+        std::memcpy(&value, src, sizeof(float));
+        return value;
+    }
+
+    bool compute_mc_vertex_bounds(const int* src, std::size_t num_vertices, const glm::vec3& origin, aabb& bounds) {
+        if(num_vertices == 0) {
+            return false;
+        }
+
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(-std::numeric_limits<float>::max());
+        for(std::size_t vertex = 0; vertex < num_vertices; vertex++) {
+            const int* position = src + vertex * MC_VERTEX_SIZE_INTS;
+            glm::vec3 point(read_float(position), read_float(position + 1), read_float(position + 2));
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        bounds = aabb::from_min_max(min + origin, max + origin);
+        return true;
+    }
+}
@@ -0,0 +1,139 @@
+/*!
+ * \brief Functions that turn the vertex and index data Minecraft sends us into the data we send to the GPU
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_VERTEX_KERNELS_H
+#define RENDERER_VERTEX_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief The number of ints in one of Minecraft's block vertices: position (3), color (1), UV (2), lightmap UV (1)
+     */
+    const std::size_t MC_VERTEX_SIZE_INTS = 7;
+
+    /*!
+     * \brief The number of ints in one POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT vertex. It's Minecraft's vertex followed
+     * by a normal (3) and a tangent (3)
+     */
+    const std::size_t EXPANDED_VERTEX_SIZE_INTS = 13;
+
+    /*!
+     * \brief The number of ints in one COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT vertex
+     *
+     * A compact vertex is 24 bytes, down from 52 for the expanded format. Despite the format's name it has no tangent,
+     * since Minecraft doesn't send one and the expanded format's is always zero. Shaders that do normal mapping have to
+     * work the tangent out themselves, from the normal and the derivatives of the UV. The layout is:
+     * - bytes 0-5: position, three unsigned shorts. See COMPACT_POSITION_SCALE and COMPACT_POSITION_BIAS
+     * - bytes 6-7: lightmap UV, two unsigned bytes
+     * - bytes 8-11: color, four unsigned bytes
+     * - bytes 12-15: texture UV, two normalized unsigned shorts
+     * - bytes 16-19: normal, packed 10:10:10:2 signed normalized
+     * - bytes 20-23: tile repeat data, four unsigned bytes. Zero unless the vertex belongs to a merged quad, see
+     *   merge_coplanar_quads. It's bound to attribute 4, where the expanded format has its tangent
+     */
+    const std::size_t COMPACT_VERTEX_SIZE_INTS = 6;
+
+    /*!
+     * \brief How many steps per block compact vertex positions have
+     */
+    const float COMPACT_POSITION_SCALE = 128;
+
+    /*!
+     * \brief How far below the chunk's origin, in blocks, a compact vertex position can be
+     *
+     * Compact positions are stored as (position + COMPACT_POSITION_BIAS) * COMPACT_POSITION_SCALE, so they can describe
+     * anything from 16 blocks below the chunk's origin to 496 blocks above it. The model matrix undoes the scale and bias
+     */
+    const float COMPACT_POSITION_BIAS = 16;
+
+    /*!
+     * \brief Expands Minecraft's 7-int vertices into POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT vertices
+     *
+     * The normals and tangents are filled with zeros since we don't compute them yet. Uses SSE2 where it's available
+     *
+     * \param src The Minecraft vertices. Must hold num_vertices * MC_VERTEX_SIZE_INTS ints
+     * \param num_vertices The number of vertices to expand
+     * \param dst Where to write the expanded vertices. Must have room for num_vertices * EXPANDED_VERTEX_SIZE_INTS ints
+     */
+    void expand_mc_vertices(const int* src, std::size_t num_vertices, int* dst);
+
+    /*!
+     * \brief Expands Minecraft's 7-int vertices into a new, exactly-sized vector
+     *
+     * Any ints at the end of the data that don't make up a full vertex are ignored
+     *
+     * \param src The Minecraft vertex data
+     * \param num_ints The number of ints in src
+     * \return The expanded vertex data
+     */
+    std::vector<int> expand_mc_vertices(const int* src, std::size_t num_ints);
+
+    /*!
+     * \brief Packs Minecraft's 7-int vertices into COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT vertices
+     *
+     * Minecraft doesn't send normals, so if the vertices make up whole quads each quad's normal is worked out from its
+     * positions. Otherwise zero is stored. The tile repeat data is always zero
+     *
+     * \param src The Minecraft vertices. Must hold num_vertices * MC_VERTEX_SIZE_INTS ints
+     * \param num_vertices The number of vertices to pack
+     * \param dst Where to write the packed vertices. Must have room for num_vertices * COMPACT_VERTEX_SIZE_INTS ints
+     */
+    void compact_mc_vertices(const int* src, std::size_t num_vertices, int* dst);
+
+    /*!
+     * \brief Packs Minecraft's 7-int vertices into a new, exactly-sized vector
+     *
+     * Any ints at the end of the data that don't make up a full vertex are ignored
+     *
+     * \param src The Minecraft vertex data
+     * \param num_ints The number of ints in src
+     * \return The packed vertex data
+     */
+    std::vector<int> compact_mc_vertices(const int* src, std::size_t num_ints);
+
+    /*!
+     * \brief The number of indices that make up the two triangles of one quad
+     */
+    const std::size_t INDICES_PER_QUAD = 6;
+
+    const std::size_t VERTICES_PER_QUAD = 4;
+
+    /*!
+     * \brief Checks if the given indices are exactly the indices that make_quad_indices would make
+     *
+     * \param indices The indices to check
+     * \param num_indices The number of indices
+     * \param num_vertices The number of vertices that the indices index into. Must be exactly four per quad
+     */
+    bool is_quad_list(const int* indices, std::size_t num_indices, std::size_t num_vertices);
+
+    /*!
+     * \brief Makes the indices for a list of quads, where quad N is the vertices 4N through 4N+3
+     *
+     * Each quad is drawn as the triangles (4N, 4N+1, 4N+2) and (4N, 4N+2, 4N+3), same as Minecraft does
+     *
+     * \param num_quads The number of quads to make indices for
+     */
+    std::vector<unsigned int> make_quad_indices(std::size_t num_quads);
+
+    /*!
+     * \brief Finds the smallest box that holds all the given Minecraft vertices
+     *
+     * \param src The vertices
+     * \param num_vertices The number of vertices in src
+     * \param origin Added to every position, so that the box can be in world space
+     * \param bounds Set to the box. Left alone if there aren't any vertices
+     * \return False if there weren't any vertices
+     */
+    bool compute_mc_vertex_bounds(const int* src, std::size_t num_vertices, const glm::vec3& origin, aabb& bounds);
+}
+
+#endif //RENDERER_VERTEX_KERNELS_H
@@ -14,6 +14,7 @@
 const int CHUNK_WIDTH = 16;
 const int CHUNK_HEIGHT = 256;
 const int CHUNK_DEPTH = 16;
+const int CHUNK_SECTION_HEIGHT = 16;
 
 /*!
  * \brief Holds the information that comes from MC textures
@@ -63,6 +64,10 @@ struct mc_block {
  * \brief Represents a chunk in Minecraft. It's really just a large array of blocks and an ID
  */
 struct mc_chunk_render_object {
+	/*!
+	 * \brief Ignored. Nova always gets Minecraft's own vertex layout, and picks the format to convert it to from the
+	 * compactChunkVertices setting
+	 */
 	int format;
 	float x;
 	float y;
@@ -75,6 +80,38 @@ struct mc_chunk_render_object {
 
 };
 
+/*!
+ * \brief A change to part of a chunk section that's already been sent to Nova
+ *
+ * The quads [first_quad, first_quad + num_replaced_quads) of the section's geometry are replaced by the quads in
+ * vertex_data, which may be more or fewer than were replaced. Quads are numbered in the order they were in when the
+ * section was sent whole, and later patches number them as if every earlier patch had been applied
+ */
+struct mc_chunk_patch {
+	float x;
+	float y;
+	float z;
+	int id;
+	int first_quad;
+	int num_replaced_quads;
+	int* vertex_data;
+	int vertex_buffer_size;
+};
+
+/*!
+ * \brief Which blocks of a chunk section are opaque, so that Nova can work out which faces of the section can see each
+ * other
+ *
+ * Block (x, y, z) of the section, counting from its minimum corner, is bit (x + z * 16 + y * 256) % 32 of
+ * opaque_blocks[(x + z * 16 + y * 256) / 32]
+ */
+struct mc_chunk_section_opacity {
+	float x;
+	float y;
+	float z;
+	int* opaque_blocks;
+};
+
 /*!
  * \brief Represents a single quad in Minecraft
  */
@@ -81,6 +81,92 @@ NOVA_API void reset_texture_manager();
  */
 NOVA_API void add_chunk_geometry_for_filter(const char* filter_name, mc_chunk_render_object* chunk);
 
+/*!
+ * \brief Replaces some of the quads of a chunk section that's already been added, without sending the whole section
+ * again
+ *
+ * The section's geometry must be a plain list of quads, four vertices each, and so must the patch's. Patches are applied
+ * in place on the GPU, in room that Nova leaves after each section's quads. If a patch can't be applied, because the
+ * section doesn't have enough room left or can't be patched at all, it shows up in get_next_failed_chunk_patch and the
+ * section should be sent whole with add_chunk_geometry_for_filter
+ *
+ * \param patch The quads to replace. The vertex data is copied before this returns
+ */
+NOVA_API void patch_chunk_geometry_for_filter(const char* filter_name, mc_chunk_patch* patch);
+
+/*!
+ * \brief Gets a chunk section that a patch couldn't be applied to
+ *
+ * \param patch Filled in with the position and ID of the section, and nothing else
+ * \return False if there are no more failed patches
+ */
+NOVA_API bool get_next_failed_chunk_patch(mc_chunk_patch* patch);
+
+/*!
+ * \brief Tells Nova which blocks of a chunk section are opaque
+ *
+ * Nova works out which faces of the section can see each other through its other blocks, and skips drawing sections
+ * that the camera can't see through the sections in between. Send this for a section whenever its blocks change.
+ * Sections that this hasn't been sent for are treated as see-through
+ *
+ * \param section The section's position and opacity bits. The bits are copied before this returns
+ */
+NOVA_API void set_chunk_section_opacity(mc_chunk_section_opacity* section);
+
+/*!
+ * \brief Starts caching chunk geometry for a world
+ *
+ * Call this when joining a world, before sending any chunks, and call load_chunk_mesh_cache once the player's position
+ * is known
+ *
+ * \param world_name Something that identifies the world, like its save folder or the server's address
+ */
+NOVA_API void open_chunk_mesh_cache(const char* world_name);
+
+/*!
+ * \brief Loads the cached chunk geometry around the player for the world that open_chunk_mesh_cache was called for
+ *
+ * Cached geometry is drawn until the chunks are sent again, and chunks that haven't changed since they were cached are
+ * skipped when they are
+ *
+ * \param center_x The player's X position
+ * \param center_z The player's Z position
+ * \param radius How far from the player to load chunks, in blocks. Should be the render distance
+ */
+NOVA_API void load_chunk_mesh_cache(float center_x, float center_z, float radius);
+
+/*!
+ * \brief Stops caching chunk geometry, and forgets the opacity of every chunk section. Call this when leaving a world
+ */
+NOVA_API void close_chunk_mesh_cache();
+
+/*!
+ * \brief Returns a pointer to the native buffer that chunk geometry can be written into
+ *
+ * Writing chunk geometry into this buffer and pointing an mc_chunk_render_object at it lets Nova read the geometry
+ * where it is, instead of copying it out of Java's memory. Space in the buffer has to be reserved with
+ * reserve_chunk_transfer_space first
+ */
+NOVA_API unsigned char* get_chunk_transfer_buffer();
+
+/*!
+ * \brief Returns the size in bytes of the chunk transfer buffer
+ */
+NOVA_API int get_chunk_transfer_buffer_size();
+
+/*!
+ * \brief Reserves space in the chunk transfer buffer
+ *
+ * Write the chunk's vertex data at the start of the reserved space and its indices right after, then send the chunk to
+ * add_chunk_geometry_for_filter with its pointers set to those locations. Nova gives the space back once it's read the
+ * geometry
+ *
+ * \param num_bytes The number of bytes to reserve
+ * \return The offset of the reserved space from the start of the buffer, or -1 if the buffer is full. If the buffer
+ * is full, send the chunk with pointers to Java-owned memory instead
+ */
+NOVA_API int reserve_chunk_transfer_space(int num_bytes);
+
 /*!
  * \brief Updates the Nova Renderer and renders the current frame
  */
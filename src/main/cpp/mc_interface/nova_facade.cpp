@@ -77,6 +77,44 @@ NOVA_API void add_chunk_geometry_for_filter(const char* filter_name, mc_chunk_re
     PROFILER::end("add_chunk_geometry_for_filter");
 }
 
+NOVA_API void patch_chunk_geometry_for_filter(const char* filter_name, mc_chunk_patch * patch) {
+    PROFILER::start("patch_chunk_geometry_for_filter");
+    MESH_STORE.patch_chunk_render_object(std::string(filter_name), *patch);
+    PROFILER::end("patch_chunk_geometry_for_filter");
+}
+
+NOVA_API bool get_next_failed_chunk_patch(mc_chunk_patch * patch) {
+    return MESH_STORE.get_next_failed_chunk_patch(*patch);
+}
+
+NOVA_API void set_chunk_section_opacity(mc_chunk_section_opacity * section) {
+    MESH_STORE.set_chunk_section_opacity(*section);
+}
+
+NOVA_API void open_chunk_mesh_cache(const char* world_name) {
+    MESH_STORE.open_chunk_mesh_cache(std::string(world_name));
+}
+
+NOVA_API void load_chunk_mesh_cache(float center_x, float center_z, float radius) {
+    MESH_STORE.load_chunk_mesh_cache({center_x, center_z}, radius);
+}
+
+NOVA_API void close_chunk_mesh_cache() {
+    MESH_STORE.close_chunk_mesh_cache();
+}
+
+NOVA_API unsigned char* get_chunk_transfer_buffer() {
+    return MESH_STORE.get_chunk_transfer_buffer().data();
+}
+
+NOVA_API int get_chunk_transfer_buffer_size() {
+    return static_cast<int>(MESH_STORE.get_chunk_transfer_buffer().size());
+}
+
+NOVA_API int reserve_chunk_transfer_space(int num_bytes) {
+    return static_cast<int>(MESH_STORE.get_chunk_transfer_buffer().reserve(static_cast<std::size_t>(num_bytes)));
+}
+
 NOVA_API void remove_chunk_geometry_for_filter(const char* filter_name, mc_chunk_render_object * chunk) {
     PROFILER::start("remove_chunk_geometry_for_filter");
     MESH_STORE.remove_chunk_render_object(std::string(filter_name), *chunk);
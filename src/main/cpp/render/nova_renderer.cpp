@@ -6,13 +6,32 @@
 #include "../utils/utils.h"
 #include "../data_loading/loaders/loaders.h"
 #include "../utils/profiler.h"
+#include "../geometry_cache/vertex_kernels.h"
+#include "../geometry_cache/lod_builder.h"
+#include "objects/gl_geometry_pool.h"
 
+#include <algorithm>
 #include <easylogging++.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 INITIALIZE_EASYLOGGINGPP
 
 namespace nova {
+    /*!
+     * \brief The occlusion culler's depth buffer is tiny. Occluders are big, and a box only has to reach one pixel that
+     * isn't covered to be drawn, so a bigger buffer doesn't hide much more
+     */
+    static const int OCCLUSION_BUFFER_WIDTH = 256;
+    static const int OCCLUSION_BUFFER_HEIGHT = 128;
+    static const std::size_t NUM_OCCLUSION_WORKERS = 2;
+
+    /*!
+     * \brief Only terrain this close to the player is drawn as occluders. Farther away, occluders cover too few
+     * pixels to hide anything that the near ones don't
+     */
+    static const float MAX_OCCLUDER_DISTANCE = 96;
+    static const std::size_t MAX_OCCLUDERS_PER_FRAME = 2048;
+
     std::unique_ptr<nova_renderer> nova_renderer::instance;
 
     nova_renderer::nova_renderer() {
@@ -21,9 +40,12 @@ namespace nova {
         ubo_manager = std::make_unique<uniform_buffer_store>();
         textures = std::make_unique<texture_manager>();
         meshes = std::make_unique<mesh_store>();
+        occlusion = std::make_unique<occlusion_culler>(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT,
+                                                       NUM_OCCLUSION_WORKERS);
         inputs = std::make_unique<input_handler>();
 		render_settings->register_change_listener(ubo_manager.get());
 		render_settings->register_change_listener(game_window.get());
+        render_settings->register_change_listener(meshes.get());
         render_settings->register_change_listener(this);
 
         render_settings->update_config_loaded();
@@ -54,6 +76,9 @@ namespace nova {
     }
 
     nova_renderer::~nova_renderer() {
+        // These own GL objects, so they have to go while the window's context is still around
+        multi_draws.reset();
+        gpu_culling.reset();
         inputs.reset();
         meshes.reset();
         textures.reset();
@@ -64,9 +89,25 @@ namespace nova {
     void nova_renderer::render_frame() {
         profiler::log_all_profiler_data();
         player_camera.recalculate_frustum();
+        cull_stats = {};
+        occlusion_stats = {};
+        facing_stats = {};
+        multi_draw_counts = {};
+        queue_stats = {};
 
         // Make geometry for any new chunks
-        meshes->upload_new_geometry();
+        meshes->upload_new_geometry(player_camera);
+
+        visibility_stats = {};
+        if(use_cave_culling) {
+            profiler::start("find_visible_sections");
+            auto& section_visibility = meshes->get_section_visibility();
+            section_visibility.find_visible_sections(player_camera.position, player_camera.get_frustum_planes());
+            visibility_stats = section_visibility.get_stats();
+            profiler::end("find_visible_sections");
+        }
+
+        update_occlusion_culling();
 
 
         // upload shadow UBO things
@@ -79,6 +120,13 @@ namespace nova {
 
         render_gbuffers();
 
+        // The GUI clears the depth buffer, so the GPU culler has to take its copy now
+        if(use_gpu_culling) {
+            profiler::start("capture_depth");
+            gpu_culling->capture_depth(player_camera.get_projection_matrix() * player_camera.get_view_matrix());
+            profiler::end("capture_depth");
+        }
+
         render_composite_passes();
 
         //glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -94,6 +142,60 @@ namespace nova {
         game_window->end_frame();
     }
 
+    void nova_renderer::update_occlusion_culling() {
+        if(!use_occlusion_culling) {
+            return;
+        }
+
+        profiler::start("occlusion_culling");
+        occlusion->begin_frame(player_camera.get_projection_matrix() * player_camera.get_view_matrix());
+
+        // Only opaque terrain hides what's behind it. Water and the like are drawn with other shaders
+        static const name_id terrain_name = intern_name("gbuffers_terrain");
+        auto& terrain = meshes->get_meshes_for_shader(terrain_name);
+        const auto& bounds = terrain.get_bounds();
+
+        frustum_cull_stats occluder_cull_stats = {};
+        terrain.cull(player_camera.get_frustum_planes(), visible_objects, occluder_cull_stats);
+
+        occluder_sources.clear();
+        for(std::size_t i = 0; i < terrain.size(); i++) {
+            if(!visible_objects[i] || terrain[i].occluders.empty()) {
+                continue;
+            }
+
+            float distance = glm::distance(bounds.get(i).center, player_camera.position);
+            if(distance < MAX_OCCLUDER_DISTANCE) {
+                occluder_sources.emplace_back(distance, i);
+            }
+        }
+
+        // Near occluders cover the most pixels, so they go in first in case there are too many
+        std::sort(occluder_sources.begin(), occluder_sources.end());
+
+        std::size_t num_occluders = 0;
+        for(const auto& source : occluder_sources) {
+            const auto& occluders = terrain[source.second].occluders;
+            if(num_occluders + occluders.size() > MAX_OCCLUDERS_PER_FRAME) {
+                break;
+            }
+
+            for(const auto& occluder : occluders) {
+                occlusion->add_occluder(occluder);
+            }
+            num_occluders += occluders.size();
+        }
+
+        profiler::start("rasterize_occluders");
+        occlusion->rasterize();
+        profiler::end("rasterize_occluders");
+
+        auto occluder_stats = occlusion->get_occluder_stats();
+        occlusion_stats.num_occluders = occluder_stats.num_occluders;
+        occlusion_stats.num_occluders_drawn = occluder_stats.num_occluders_drawn;
+        profiler::end("occlusion_culling");
+    }
+
     void nova_renderer::render_shadow_pass() {
         LOG(TRACE) << "Rendering shadow pass";
     }
@@ -101,11 +203,28 @@ namespace nova {
     void nova_renderer::render_gbuffers() {
         LOG(TRACE) << "Rendering gbuffer pass";
 
-        // TODO: Get shaders with gbuffers prefix, draw transparents last, etc
-        auto& terrain_shader = loaded_shaderpack->get_shader("gbuffers_terrain");
-        render_shader(terrain_shader);
-        auto& water_shader = loaded_shaderpack->get_shader("gbuffers_water");
-        render_shader(water_shader);
+        profiler::start("build_render_queue");
+        draw_queue.clear();
+        for(std::size_t slot = 0; slot < gbuffers_shaders.size(); slot++) {
+            queue_shader(static_cast<std::uint16_t>(slot));
+        }
+        draw_queue.sort();
+        profiler::end("build_render_queue");
+
+        const auto& entries = draw_queue.get_entries();
+        queue_stats.num_entries = entries.size();
+        queue_stats.num_sort_passes = draw_queue.get_num_sort_passes();
+
+        bound_textures = {NO_NAME, NO_NAME, NO_NAME};
+        bound_vertex_array = 0;
+
+        // Nothing else uses texture unit 3, so the lightmap only needs to be bound once
+        static const name_id lightmap_name = intern_name("lightmap");
+        textures->get_texture(lightmap_name).bind(3);
+
+        std::size_t translucent_start = draw_queue.find_pass_start(render_pass::translucent);
+        draw_queued_pass(render_pass::opaque, 0, translucent_start);
+        draw_queued_pass(render_pass::translucent, translucent_start, entries.size());
     }
 
     void nova_renderer::render_composite_passes() {
@@ -129,11 +248,10 @@ namespace nova {
         upload_gui_model_matrix(gui_shader);
 
         // Render GUI objects
-        std::vector<render_object>& gui_geometry = meshes->get_meshes_for_shader("gui");
+        auto& gui_geometry = meshes->get_meshes_for_shader("gui");
         for(const auto& geom : gui_geometry) {
             if (!geom.color_texture.empty()) {
-                auto color_texture = textures->get_texture(geom.color_texture);
-                color_texture.bind(0);
+                textures->get_texture(geom.color_texture).bind(0);
             }
             geom.geometry->set_active();
             geom.geometry->draw();
@@ -234,6 +352,37 @@ namespace nova {
     }
 
     void nova_renderer::on_config_change(nlohmann::json &new_config) {
+        use_occlusion_culling = new_config.value("occlusionCulling", use_occlusion_culling);
+        use_cave_culling = new_config.value("caveCulling", use_cave_culling);
+        use_facing_culling = new_config.value("quadFacingCulling", use_facing_culling);
+
+        use_multi_draw = new_config.value("multiDrawIndirect", use_multi_draw);
+        if(use_multi_draw && !multi_draws) {
+            if(multi_draw_batcher::is_supported()) {
+                multi_draws = std::make_unique<multi_draw_batcher>();
+            } else {
+                LOG(WARNING) << "Multi-draw indirect needs OpenGL 4.3, so everything will be drawn one at a time";
+                use_multi_draw = false;
+            }
+        }
+
+        use_gpu_culling = new_config.value("gpuCulling", use_gpu_culling);
+        if(use_gpu_culling && !gpu_culling) {
+            if(!gpu_culler::is_supported()) {
+                LOG(WARNING) << "GPU culling needs OpenGL 4.5 and ARB_indirect_parameters, so everything will be "
+                             << "culled on the CPU";
+                use_gpu_culling = false;
+
+            } else {
+                try {
+                    gpu_culling = std::make_unique<gpu_culler>();
+                } catch(program_linking_failure& e) {
+                    LOG(ERROR) << "Couldn't set up GPU culling, so everything will be culled on the CPU: " << e.what();
+                    use_gpu_culling = false;
+                }
+            }
+        }
+
 		auto& shaderpack_name = new_config["loadedShaderpack"];
         LOG(INFO) << "Shaderpack in settings: " << shaderpack_name;
 
@@ -286,6 +435,8 @@ namespace nova {
         link_up_uniform_buffers(loaded_shaderpack->get_loaded_shaders(), *ubo_manager);
         LOG(DEBUG) << "Linked up UBOs";
 
+        find_gbuffers_shaders();
+
         create_framebuffers_from_shaderpack();
     }
 
@@ -321,64 +472,323 @@ namespace nova {
         instance.release();
     }
 
-    void nova_renderer::render_shader(gl_shader_program &shader) {
-        LOG(TRACE) << "Rendering everything for shader " << shader.get_name();
+    void nova_renderer::find_gbuffers_shaders() {
+        gbuffers_shaders.clear();
+        for(const auto& name : loaded_shaderpack->get_shader_order()) {
+            if(name.compare(0, 9, "gbuffers_") != 0) {
+                continue;
+            }
+
+            if(gbuffers_shaders.size() == MAX_QUEUED_SHADERS) {
+                LOG(ERROR) << "The render queue can only tell " << MAX_QUEUED_SHADERS
+                           << " shaders apart, so shader " << name << " won't be drawn";
+                continue;
+            }
+
+            auto& shader = loaded_shaderpack->get_shader(name);
+
+            // The draw_position_in attribute is the only way the batched draws get their positions
+            bool reads_draw_position = glGetAttribLocation(shader.gl_name, "draw_position_in") >= 0;
+            gbuffers_shaders.push_back({&shader, reads_draw_position});
+        }
+
+        LOG(DEBUG) << "Found " << gbuffers_shaders.size() << " gbuffers shaders";
+    }
+
+    void nova_renderer::queue_shader(std::uint16_t slot) {
+        auto& shader = *gbuffers_shaders[slot].program;
+        auto& geometry = meshes->get_meshes_for_shader(shader.get_name_id());
+        if(geometry.size() == 0) {
+            return;
+        }
+
         profiler::start(shader.get_name());
-        shader.bind();
 
-        profiler::start("get_meshes_for_shader");
-        auto& geometry = meshes->get_meshes_for_shader(shader.get_name());
-        profiler::end("get_meshes_for_shader");
-        profiler::start("process_all");
-        for(auto& geom : geometry) {
-            profiler::start("process_renderable");
-
-            // if(!player_camera.has_object_in_frustum(geom.bounding_box)) {
-            //     continue;
-            // }
-
-            if(geom.geometry->has_data()) {
-                if(!geom.color_texture.empty()) {
-                    auto color_texture = textures->get_texture(geom.color_texture);
-                    color_texture.bind(0);
-                }
+        const auto& bounds = geometry.get_bounds();
+        const auto& object_textures = geometry.get_textures();
+        const auto& planes = player_camera.get_frustum_planes();
+        auto pass = shader.is_translucent() ? render_pass::translucent : render_pass::opaque;
+
+        auto queue_object = [&](std::size_t i) {
+            float distance = glm::distance(bounds.get(i).center, player_camera.position);
+
+            std::size_t level;
+            gl_mesh* mesh = select_lod_mesh(geometry, i, distance, level);
+            if(!mesh->has_data()) {
+                LOG(TRACE) << "Skipping some geometry since it has no data";
+                return;
+            }
 
-                if(geom.normalmap) {
-                    textures->get_texture(*geom.normalmap).bind(1);
+            const geometry_allocation* allocation = mesh->get_allocation();
+            auto pool_page = allocation != nullptr ? static_cast<std::uint32_t>(allocation->page) : NO_POOL_PAGE;
+            const auto& textures_to_bind = object_textures[i];
+            auto texture_set = hash_texture_set(textures_to_bind.color, textures_to_bind.normalmap,
+                                                textures_to_bind.data);
+            auto depth = quantize_sort_depth(distance, player_camera.far_plane);
+
+            draw_queue.add(make_sort_key(pass, slot, texture_set, pool_page, depth), static_cast<std::uint32_t>(i),
+                           slot, static_cast<std::uint8_t>(level));
+        };
+
+        // The GPU culler's draws can't be sorted back to front, so it only takes opaque shaders. There aren't many
+        // render_objects outside of the geometry pool, so they're only frustum culled
+        if(use_gpu_culling && pass == render_pass::opaque) {
+            gpu_culling->prepare(shader.get_name_id(), geometry, meshes->get_geometry_version());
+            for(std::size_t i : gpu_culling->get_cpu_objects()) {
+                if(is_aabb_in_frustum(planes, bounds.get(i))) {
+                    queue_object(i);
                 }
+            }
+
+            profiler::end(shader.get_name());
+            return;
+        }
+
+        profiler::start("frustum_cull");
+        geometry.cull(planes, visible_objects, cull_stats);
+        profiler::end("frustum_cull");
+
+        if(use_cave_culling) {
+            meshes->get_section_visibility().cull(bounds, visible_objects, visibility_stats);
+        }
+
+        if(use_occlusion_culling) {
+            profiler::start("occlusion_cull");
+            occlusion->cull(bounds, visible_objects, occlusion_stats);
+            profiler::end("occlusion_cull");
+        }
+
+        for(std::size_t i = 0; i < geometry.size(); i++) {
+            if(visible_objects[i]) {
+                queue_object(i);
+            }
+        }
+
+        profiler::end(shader.get_name());
+    }
+
+    void nova_renderer::draw_queued_pass(render_pass pass, std::size_t first, std::size_t last) {
+        const char* pass_name = pass == render_pass::opaque ? "opaque_pass" : "translucent_pass";
+        profiler::start(pass_name);
 
-                if(geom.data_texture) {
-                    textures->get_texture(*geom.data_texture).bind(2);
+        if(use_gpu_culling && pass == render_pass::opaque) {
+            for(const auto& shader : gbuffers_shaders) {
+                if(!shader.program->is_translucent()) {
+                    draw_gpu_culled(*shader.program);
                 }
+            }
+        }
 
-                textures->get_texture("lightmap").bind(3);
+        // Opaque keys start with the shader, so each shader's opaque draws are one run. Translucent keys start with
+        // the depth, so their runs are only as long as the shader happens to stay the same
+        const auto& entries = draw_queue.get_entries();
+        std::size_t run_start = first;
+        while(run_start < last) {
+            std::uint16_t slot = entries[run_start].shader;
+            std::size_t run_end = run_start + 1;
+            while(run_end < last && entries[run_end].shader == slot) {
+                run_end++;
+            }
 
-                upload_model_matrix(geom, shader);
+            auto& shader = *gbuffers_shaders[slot].program;
+            auto& geometry = meshes->get_meshes_for_shader(shader.get_name_id());
+            shader.bind();
+            queue_stats.num_shader_binds++;
 
-                profiler::start("drawcall");
-                geom.geometry->set_active();
-                geom.geometry->draw();
-                profiler::end("drawcall");
+            if(pass == render_pass::opaque && use_multi_draw && gbuffers_shaders[slot].reads_draw_position) {
+                draw_queued_batch(shader, geometry, run_start, run_end);
             } else {
-                LOG(TRACE) << "Skipping some geometry since it has no data";
+                for(std::size_t entry = run_start; entry < run_end; entry++) {
+                    draw_queued_object(shader, geometry, entries[entry]);
+                }
             }
-            profiler::end("process_renderable");
+
+            run_start = run_end;
         }
-        for(int i=0;i<geometry.size();i++){
-            if(geometry[i].needs_deletion){
-                geometry.erase( geometry.begin()+i);
-                i--;
+
+        profiler::end(pass_name);
+    }
+
+    void nova_renderer::draw_gpu_culled(gl_shader_program& shader) {
+        auto& geometry = meshes->get_meshes_for_shader(shader.get_name_id());
+        if(geometry.size() == 0) {
+            return;
+        }
+
+        // queue_shader already brought the shader's records up to date this frame
+        if(!gpu_culling->select(shader.get_name_id())) {
+            return;
+        }
+
+        profiler::start("gpu_cull");
+        gpu_culling->cull(player_camera.get_frustum_planes(), player_camera.position, meshes->get_lod_settings());
+        profiler::end("gpu_cull");
+
+        // Culling used its own program
+        shader.bind();
+        queue_stats.num_shader_binds++;
+
+        // The positions come from the draw_position_in attribute, so the model matrix only has to undo the vertex
+        // format's packing
+        const auto& groups = gpu_culling->get_groups();
+        for(std::size_t group = 0; group < groups.size(); group++) {
+            const auto& key = groups[group].key;
+            bind_queued_textures({key.color_texture, key.normalmap, key.data_texture});
+            upload_model_matrix(glm::vec3(0), key.vertex_format, shader);
+
+            profiler::start("drawcall");
+            gpu_culling->draw_group(group);
+            profiler::end("drawcall");
+        }
+
+        bound_vertex_array = 0;
+    }
+
+    void nova_renderer::draw_queued_batch(gl_shader_program& shader, render_object_bucket& geometry, std::size_t first,
+                                          std::size_t last) {
+        const auto& entries = draw_queue.get_entries();
+        const auto& meshes_to_draw = geometry.get_meshes();
+        const auto& positions = geometry.get_positions();
+        const auto& bounds = geometry.get_bounds();
+        const auto& object_textures = geometry.get_textures();
+        const auto& object_lods = geometry.get_lods();
+        const auto& object_facings = geometry.get_facing_ranges();
+
+        // The entries are already sorted by textures, pool page and depth, so each draw group comes out front to back
+        profiler::start("build_multi_draw");
+        multi_draws->begin();
+        for(std::size_t entry = first; entry < last; entry++) {
+            std::size_t i = entries[entry].object;
+            std::size_t level = entries[entry].lod_level;
+            gl_mesh* mesh = level == 0 ? meshes_to_draw[i] : object_lods[i].meshes[level - 1];
+
+            quad_run runs[NUM_FACING_RANGES];
+            const quad_run* visible_runs = nullptr;
+            std::size_t num_runs = 0;
+            if(level == 0 && use_facing_culling && object_facings[i].is_sorted() && mesh->get_quad_capacity() > 0) {
+                auto visible_facings = get_visible_facings(bounds.get(i), player_camera.position);
+                num_runs = get_visible_quad_runs(object_facings[i], visible_facings, runs, facing_stats);
+                visible_runs = runs;
+            }
+
+            // Anything outside the geometry pool has its own vertex array, so it's drawn on its own
+            if(!multi_draws->add(*mesh, object_textures[i], positions[i], visible_runs, num_runs)) {
+                draw_queued_object(shader, geometry, entries[entry]);
             }
         }
-        profiler::end("process_all");
+        multi_draws->submit();
+        profiler::end("build_multi_draw");
+
+        // Like with GPU culling, the model matrix only has to undo the vertex format's packing
+        const auto& groups = multi_draws->get_groups();
+        for(std::size_t group = 0; group < groups.size(); group++) {
+            const auto& key = groups[group].key;
+            bind_queued_textures({key.color_texture, key.normalmap, key.data_texture});
+            upload_model_matrix(glm::vec3(0), key.vertex_format, shader);
+
+            profiler::start("drawcall");
+            multi_draws->draw_group(group);
+            profiler::end("drawcall");
+
+            multi_draw_counts.num_commands += groups[group].num_commands;
+            multi_draw_counts.num_draw_calls++;
+        }
 
-        profiler::end(shader.get_name());
+        bound_vertex_array = 0;
     }
 
-    inline void nova_renderer::upload_model_matrix(render_object &geom, gl_shader_program &program) const {
-        glm::mat4 model_matrix = glm::translate(glm::mat4(1), geom.position);
+    void nova_renderer::draw_queued_object(gl_shader_program& shader, render_object_bucket& geometry,
+                                           const render_queue_entry& entry) {
+        std::size_t i = entry.object;
+        std::size_t level = entry.lod_level;
+        gl_mesh* mesh = level == 0 ? geometry.get_meshes()[i] : geometry.get_lods()[i].meshes[level - 1];
+
+        bind_queued_textures(geometry.get_textures()[i]);
+        upload_model_matrix(geometry.get_positions()[i], mesh->get_format(), shader);
+
+        profiler::start("drawcall");
+
+        // Everything in a page of the geometry pool shares a vertex array, and the queue keeps them together
+        const geometry_allocation* allocation = mesh->get_allocation();
+        if(allocation == nullptr || allocation->vertex_array != bound_vertex_array) {
+            mesh->set_active();
+            bound_vertex_array = allocation != nullptr ? allocation->vertex_array : 0;
+            queue_stats.num_vertex_array_binds++;
+        }
+
+        const auto& facings = geometry.get_facing_ranges()[i];
+        if(level == 0 && use_facing_culling && facings.is_sorted()) {
+            draw_facing_quads(*mesh, facings, geometry.get_bounds().get(i));
+        } else {
+            mesh->draw();
+        }
+        profiler::end("drawcall");
+    }
+
+    gl_mesh* nova_renderer::select_lod_mesh(render_object_bucket& bucket, std::size_t i, float distance,
+                                            std::size_t& level) {
+        level = 0;
+        const auto& lods = bucket.get_lods()[i];
+        if(lods.num_levels == 0) {
+            return bucket.get_meshes()[i];
+        }
 
-        auto model_matrix_location = program.get_uniform_location("gbufferModel");
+        auto& lod_levels = bucket.get_lod_levels();
+        level = select_lod_level(lod_levels[i], lods.num_levels, distance, meshes->get_lod_settings());
+        lod_levels[i] = static_cast<std::uint8_t>(level);
+        return level > 0 ? lods.meshes[level - 1] : bucket.get_meshes()[i];
+    }
+
+    void nova_renderer::draw_facing_quads(const gl_mesh& mesh, const quad_facing_ranges& ranges, const aabb& bounds) {
+        if(mesh.get_quad_capacity() == 0) {
+            mesh.draw();
+            return;
+        }
+
+        quad_run runs[NUM_FACING_RANGES];
+        auto visible_facings = get_visible_facings(bounds, player_camera.position);
+        std::size_t num_runs = get_visible_quad_runs(ranges, visible_facings, runs, facing_stats);
+        for(std::size_t run = 0; run < num_runs; run++) {
+            mesh.draw_quads(runs[run].first_quad, runs[run].num_quads);
+        }
+    }
+
+    void nova_renderer::bind_queued_textures(const render_object_textures& textures_to_bind) {
+        if(textures_to_bind.color == bound_textures.color && textures_to_bind.normalmap == bound_textures.normalmap &&
+           textures_to_bind.data == bound_textures.data) {
+            return;
+        }
+
+        bind_textures(textures_to_bind);
+        bound_textures = textures_to_bind;
+        queue_stats.num_texture_binds++;
+    }
+
+    void nova_renderer::bind_textures(const render_object_textures& textures_to_bind) {
+        if(textures_to_bind.color != NO_NAME) {
+            textures->get_texture(textures_to_bind.color).bind(0);
+        }
+
+        if(textures_to_bind.normalmap != NO_NAME) {
+            textures->get_texture(textures_to_bind.normalmap).bind(1);
+        }
+
+        if(textures_to_bind.data != NO_NAME) {
+            textures->get_texture(textures_to_bind.data).bind(2);
+        }
+    }
+
+    inline void nova_renderer::upload_model_matrix(const glm::vec3 &position, format vertex_format,
+                                                   gl_shader_program &program) const {
+        glm::mat4 model_matrix = glm::translate(glm::mat4(1), position);
+        if(vertex_format == format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT) {
+            // Compact positions are stored scaled up and biased so they fit in unsigned shorts
+            model_matrix = glm::translate(model_matrix, glm::vec3(-COMPACT_POSITION_BIAS));
+            model_matrix = glm::scale(model_matrix, glm::vec3(1.0f / COMPACT_POSITION_SCALE));
+        }
+
+        static const name_id model_matrix_name = intern_name("gbufferModel");
+        auto model_matrix_location = program.get_uniform_location(model_matrix_name);
         glUniformMatrix4fv(model_matrix_location, 1, GL_FALSE, &model_matrix[0][0]);
     }
 
@@ -394,7 +804,8 @@ namespace nova {
         gui_model = glm::scale(gui_model, glm::vec3(1.0 / view_width, 1.0 / view_height, 1.0));
         gui_model = glm::scale(gui_model, glm::vec3(1.0f, -1.0f, 1.0f));
 
-        auto model_matrix_location = program.get_uniform_location("gbufferModel");
+        static const name_id model_matrix_name = intern_name("gbufferModel");
+        auto model_matrix_location = program.get_uniform_location(model_matrix_name);
 
         glUniformMatrix4fv(model_matrix_location, 1, GL_FALSE, &gui_model[0][0]);
     }
@@ -415,6 +826,34 @@ namespace nova {
         return player_camera;
     }
 
+    frustum_cull_stats nova_renderer::get_frustum_cull_stats() const {
+        return cull_stats;
+    }
+
+    occlusion_cull_stats nova_renderer::get_occlusion_cull_stats() const {
+        return occlusion_stats;
+    }
+
+    section_visibility_stats nova_renderer::get_section_visibility_stats() const {
+        return visibility_stats;
+    }
+
+    multi_draw_stats nova_renderer::get_multi_draw_stats() const {
+        return multi_draw_counts;
+    }
+
+    render_queue_stats nova_renderer::get_render_queue_stats() const {
+        return queue_stats;
+    }
+
+    facing_cull_stats nova_renderer::get_facing_cull_stats() const {
+        return facing_stats;
+    }
+
+    gpu_cull_stats nova_renderer::get_gpu_cull_stats() const {
+        return gpu_culling ? gpu_culling->get_stats() : gpu_cull_stats{};
+    }
+
     std::shared_ptr<shaderpack> nova_renderer::get_shaders() {
         return loaded_shaderpack;
     }
@@ -15,6 +15,10 @@
 #include "../input/InputHandler.h"
 #include "objects/framebuffer.h"
 #include "objects/camera.h"
+#include "objects/occlusion_culler.h"
+#include "objects/gpu_culler.h"
+#include "objects/multi_draw_batcher.h"
+#include "objects/render_queue.h"
 
 namespace nova {
     /*!
@@ -87,6 +91,42 @@ namespace nova {
 
         camera& get_player_camera();
 
+        /*!
+         * \brief How many render_objects were frustum culled in the last frame
+         */
+        frustum_cull_stats get_frustum_cull_stats() const;
+
+        /*!
+         * \brief How many occluders were drawn and how many render_objects were hidden behind them in the last frame
+         */
+        occlusion_cull_stats get_occlusion_cull_stats() const;
+
+        /*!
+         * \brief How many chunk sections the last frame's visibility search went through, and how many render_objects
+         * it hid
+         */
+        section_visibility_stats get_section_visibility_stats() const;
+
+        /*!
+         * \brief How much the GPU culler is drawing, or all zeros if it's turned off
+         */
+        gpu_cull_stats get_gpu_cull_stats() const;
+
+        /*!
+         * \brief How many quads facing away from the camera were skipped in the last frame
+         */
+        facing_cull_stats get_facing_cull_stats() const;
+
+        /*!
+         * \brief How many draws were batched into multi-draw calls in the last frame
+         */
+        multi_draw_stats get_multi_draw_stats() const;
+
+        /*!
+         * \brief How many draws went through the render queue in the last frame, and how much state they changed
+         */
+        render_queue_stats get_render_queue_stats() const;
+
         std::shared_ptr<shaderpack> get_shaders();
 
         // Overrides from iconfig_listener
@@ -121,11 +161,94 @@ namespace nova {
 
         camera player_camera;
 
+        /*!
+         * \brief Which render_objects in the bucket being drawn are in the player's view. Kept around so it doesn't
+         * have to be reallocated for every shader
+         */
+        std::vector<std::uint8_t> visible_objects;
+        frustum_cull_stats cull_stats = {};
+
+        /*!
+         * \brief Skips chunk sections that the camera can't see through the sections in between. Each section's
+         * connectivity comes from the opaque blocks that RenderChunk sends when it rebuilds the section
+         */
+        bool use_cave_culling = true;
+        section_visibility_stats visibility_stats = {};
+
+        /*!
+         * \brief Draws the biggest solid faces of nearby terrain on the CPU, so that whatever is behind them can be
+         * skipped
+         */
+        std::unique_ptr<occlusion_culler> occlusion;
+        bool use_occlusion_culling = false;
+        occlusion_cull_stats occlusion_stats = {};
+
+        /*!
+         * \brief Indices of the terrain render_objects whose occluders get drawn this frame, nearest first
+         */
+        std::vector<std::pair<float, std::size_t>> occluder_sources;
+
+        /*!
+         * \brief Culls and draws pooled geometry without the CPU looking at it. Only made when GPU culling is turned on
+         */
+        std::unique_ptr<gpu_culler> gpu_culling;
+        bool use_gpu_culling = false;
+
+        /*!
+         * \brief Skips the quads of full detail chunk sections that face away from the camera
+         */
+        bool use_facing_culling = true;
+        facing_cull_stats facing_stats = {};
+
+        /*!
+         * \brief Draws the CPU-culled geometry of shaders that read draw_position_in with a multi-draw call for each
+         * draw group. Only made when multi-draw indirect is turned on
+         */
+        std::unique_ptr<multi_draw_batcher> multi_draws;
+        bool use_multi_draw = true;
+        multi_draw_stats multi_draw_counts = {};
+
+        /*!
+         * \brief A gbuffers shader of the loaded shaderpack
+         */
+        struct queued_shader {
+            gl_shader_program* program;
+
+            /*!
+             * \brief If the shader reads draw_position_in, so its opaque geometry can go through the multi-draw batcher
+             */
+            bool reads_draw_position;
+        };
+
+        /*!
+         * \brief The gbuffers shaders of the loaded shaderpack, in the order shaders.json lists them. A shader's index
+         * in here is its slot in the render queue's keys
+         */
+        std::vector<queued_shader> gbuffers_shaders;
+
+        /*!
+         * \brief Every draw of the gbuffers pass, sorted by pass, state and depth
+         */
+        render_queue draw_queue;
+        render_queue_stats queue_stats = {};
+
+        /*!
+         * \brief What the last queued draw left bound, so that draws sharing textures or a pool page don't bind them
+         * again. Reset whenever something outside the queue binds its own
+         */
+        render_object_textures bound_textures = {NO_NAME, NO_NAME, NO_NAME};
+        GLuint bound_vertex_array = 0;
+
         /*!
          * \brief Renders the GUI of Minecraft
          */
         void render_gui();
 
+        /*!
+         * \brief Fills the occlusion culler's depth buffer with the occluders of the terrain near the player
+         */
+        void update_occlusion_culling();
+
         void render_shadow_pass();
 
         void render_gbuffers();
@@ -143,15 +266,76 @@ namespace nova {
         void create_framebuffers_from_shaderpack();
 
         /*!
-         * \brief Renders all the geometry that uses the specified shader, setting up textures and whatnot
+         * \brief Fills gbuffers_shaders from the loaded shaderpack
+         */
+        void find_gbuffers_shaders();
+
+        /*!
+         * \brief Culls the geometry of a gbuffers shader and adds what's left to the render queue
+         *
+         * \param slot The shader's index in gbuffers_shaders
+         */
+        void queue_shader(std::uint16_t slot);
+
+        /*!
+         * \brief Draws one pass of the sorted render queue
+         *
+         * \param pass The pass to draw
+         * \param first The first entry of the pass
+         * \param last One past the last entry of the pass
+         */
+        void draw_queued_pass(render_pass pass, std::size_t first, std::size_t last);
+
+        /*!
+         * \brief Culls and draws an opaque shader's pooled geometry with the GPU culler
+         */
+        void draw_gpu_culled(gl_shader_program& shader);
+
+        /*!
+         * \brief Draws a run of queue entries that all use the same shader with the multi-draw batcher
+         */
+        void draw_queued_batch(gl_shader_program& shader, render_object_bucket& geometry, std::size_t first,
+                               std::size_t last);
+
+        /*!
+         * \brief Draws a single queue entry. Its shader must already be bound
+         */
+        void draw_queued_object(gl_shader_program& shader, render_object_bucket& geometry,
+                                const render_queue_entry& entry);
+
+        /*!
+         * \brief Picks the level of detail to draw a render_object at and returns its mesh
+         *
+         * \param bucket The bucket the render_object is in
+         * \param i The render_object's index in the bucket
+         * \param distance How far the render_object is from the camera
+         * \param level Gets the picked level. Zero is full detail
+         */
+        gl_mesh* select_lod_mesh(render_object_bucket& bucket, std::size_t i, float distance, std::size_t& level);
+
+        /*!
+         * \brief Binds whichever of the given textures there are to their texture units
+         */
+        void bind_textures(const render_object_textures& textures_to_bind);
+
+        /*!
+         * \brief Binds the given textures, unless they're what the last queued draw already bound
+         */
+        void bind_queued_textures(const render_object_textures& textures_to_bind);
+
+        /*!
+         * \brief Draws the quads of a mesh that's been sorted by facing, skipping the facings that point away from the
+         * camera
          *
-         * \param shader The shader to render things with
+         * \param mesh The mesh to draw. Must already be active
+         * \param ranges Where the quads facing each way are in the mesh
+         * \param bounds The bounds of the mesh's quads, in world space
          */
-        void render_shader(gl_shader_program& shader);
+        void draw_facing_quads(const gl_mesh& mesh, const quad_facing_ranges& ranges, const aabb& bounds);
 
         inline void upload_gui_model_matrix(gl_shader_program &program);
 
-        void upload_model_matrix(render_object &geom, gl_shader_program &program) const;
+        void upload_model_matrix(const glm::vec3 &position, format vertex_format, gl_shader_program &program) const;
 
         void update_gbuffer_ubos();
     };
@@ -125,36 +125,10 @@ namespace nova {
     }
 
     bool camera::has_object_in_frustum(aabb &bounding_box) {
-        float x = bounding_box.center.x;
-        float y = bounding_box.center.y;
-        float z = bounding_box.center.z;
-
-        float xSize = bounding_box.extents.x;
-        float ySize = bounding_box.extents.y;
-        float zSize = bounding_box.extents.z;
-
-        int p;
-
-        for( p = 0; p < 6; p++ )
-        {
-            if( frustum[p][0] * (x - xSize) + frustum[p][1] * (y - ySize) + frustum[p][2] * (z - zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x + xSize) + frustum[p][1] * (y - ySize) + frustum[p][2] * (z - zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x - xSize) + frustum[p][1] * (y + ySize) + frustum[p][2] * (z - zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x + xSize) + frustum[p][1] * (y + ySize) + frustum[p][2] * (z - zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x - xSize) + frustum[p][1] * (y - ySize) + frustum[p][2] * (z + zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x + xSize) + frustum[p][1] * (y - ySize) + frustum[p][2] * (z + zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x - xSize) + frustum[p][1] * (y + ySize) + frustum[p][2] * (z + zSize) + frustum[p][3] > 0 )
-                continue;
-            if( frustum[p][0] * (x + xSize) + frustum[p][1] * (y + ySize) + frustum[p][2] * (z + zSize) + frustum[p][3] > 0 )
-                continue;
-            return false;
-        }
-        return true;
+        return is_aabb_in_frustum(frustum, bounding_box);
+    }
+
+    const frustum_planes& camera::get_frustum_planes() const {
+        return frustum;
     }
 }
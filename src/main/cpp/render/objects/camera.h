@@ -8,6 +8,7 @@
 
 #include <glm/glm.hpp>
 #include "../../data_loading/physics/aabb.h"
+#include "frustum_culling.h"
 
 namespace nova {
     /*!
@@ -32,12 +33,17 @@ namespace nova {
 
         bool has_object_in_frustum(aabb& bounding_box);
 
+        /*!
+         * \brief The planes that recalculate_frustum last found, for culling lots of objects at once
+         */
+        const frustum_planes& get_frustum_planes() const;
+
     private:
-        bool projection_matrix_is_dirty;
+        bool projection_matrix_is_dirty = true;
 
         glm::mat4 projection_matrix;
 
-        float frustum[6][4];
+        frustum_planes frustum;
     };
 }
 
@@ -0,0 +1,190 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cmath>
+#include "frustum_culling.h"
+
+#if defined(__AVX__)
+#define NOVA_HAS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace nova {
+    void aabb_soa::push_back(const aabb& box) {
+        center_x.push_back(box.center.x);
+        center_y.push_back(box.center.y);
+        center_z.push_back(box.center.z);
+        extent_x.push_back(box.extents.x);
+        extent_y.push_back(box.extents.y);
+        extent_z.push_back(box.extents.z);
+    }
+
+    void aabb_soa::set(std::size_t index, const aabb& box) {
+        center_x[index] = box.center.x;
+        center_y[index] = box.center.y;
+        center_z[index] = box.center.z;
+        extent_x[index] = box.extents.x;
+        extent_y[index] = box.extents.y;
+        extent_z[index] = box.extents.z;
+    }
+
+    void aabb_soa::swap_remove(std::size_t index) {
+        std::size_t last_index = size() - 1;
+        if(index != last_index) {
+            set(index, get(last_index));
+        }
+
+        center_x.pop_back();
+        center_y.pop_back();
+        center_z.pop_back();
+        extent_x.pop_back();
+        extent_y.pop_back();
+        extent_z.pop_back();
+    }
+
+    aabb aabb_soa::get(std::size_t index) const {
+        return {{center_x[index], center_y[index], center_z[index]},
+                {extent_x[index], extent_y[index], extent_z[index]}};
+    }
+
+    std::size_t aabb_soa::size() const {
+        return center_x.size();
+    }
+
+    void aabb_soa::clear() {
+        center_x.clear();
+        center_y.clear();
+        center_z.clear();
+        extent_x.clear();
+        extent_y.clear();
+        extent_z.clear();
+    }
+
+    frustum_test_result test_aabb_against_frustum(const frustum_planes& planes, const aabb& box) {
+        auto result = INSIDE_FRUSTUM;
+        for(const auto& plane : planes) {
+            // Summed in the same order as the SIMD paths so that boxes touching a plane get the same answer
+            float distance = (plane[0] * box.center.x + plane[1] * box.center.y) + (plane[2] * box.center.z + plane[3]);
+            float radius = (std::abs(plane[0]) * box.extents.x + std::abs(plane[1]) * box.extents.y) +
+                           std::abs(plane[2]) * box.extents.z;
+
+            if(distance + radius <= 0) {
+                return OUTSIDE_FRUSTUM;
+            }
+            if(distance - radius <= 0) {
+                result = CROSSES_FRUSTUM;
+            }
+        }
+
+        return result;
+    }
+
+    bool is_aabb_in_frustum(const frustum_planes& planes, const aabb& box) {
+        return test_aabb_against_frustum(planes, box) != OUTSIDE_FRUSTUM;
+    }
+
+    void cull_aabbs_against_frustum(const frustum_planes& planes, const aabb_soa& boxes,
+                                    std::vector<std::uint8_t>& visible, frustum_cull_stats& stats) {
+        std::size_t num_boxes = boxes.size();
+        visible.resize(num_boxes);
+
+        std::size_t box = 0;
+        std::size_t num_visible = 0;
+
+#ifdef NOVA_HAS_AVX
+        __m256 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+        __m256 abs_x[6], abs_y[6], abs_z[6];
+        for(int p = 0; p < 6; p++) {
+            plane_x[p] = _mm256_set1_ps(planes[p][0]);
+            plane_y[p] = _mm256_set1_ps(planes[p][1]);
+            plane_z[p] = _mm256_set1_ps(planes[p][2]);
+            plane_w[p] = _mm256_set1_ps(planes[p][3]);
+            abs_x[p] = _mm256_set1_ps(std::abs(planes[p][0]));
+            abs_y[p] = _mm256_set1_ps(std::abs(planes[p][1]));
+            abs_z[p] = _mm256_set1_ps(std::abs(planes[p][2]));
+        }
+        const __m256 zero = _mm256_setzero_ps();
+
+        for(; box + 8 <= num_boxes; box += 8) {
+            __m256 cx = _mm256_loadu_ps(&boxes.center_x[box]);
+            __m256 cy = _mm256_loadu_ps(&boxes.center_y[box]);
+            __m256 cz = _mm256_loadu_ps(&boxes.center_z[box]);
+            __m256 ex = _mm256_loadu_ps(&boxes.extent_x[box]);
+            __m256 ey = _mm256_loadu_ps(&boxes.extent_y[box]);
+            __m256 ez = _mm256_loadu_ps(&boxes.extent_z[box]);
+
+            __m256 crosses = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            __m256 inside = crosses;
+            for(int p = 0; p < 6; p++) {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane_x[p], cx), _mm256_mul_ps(plane_y[p], cy)),
+                                                _mm256_add_ps(_mm256_mul_ps(plane_z[p], cz), plane_w[p]));
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(abs_x[p], ex), _mm256_mul_ps(abs_y[p], ey)),
+                                              _mm256_mul_ps(abs_z[p], ez));
+                crosses = _mm256_and_ps(crosses, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GT_OQ));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_sub_ps(distance, radius), zero, _CMP_GT_OQ));
+            }
+
+            int crosses_mask = _mm256_movemask_ps(crosses);
+            int inside_mask = _mm256_movemask_ps(inside);
+            for(int i = 0; i < 8; i++) {
+                visible[box + i] = static_cast<std::uint8_t>(((crosses_mask >> i) & 1) + ((inside_mask >> i) & 1));
+                num_visible += (crosses_mask >> i) & 1;
+            }
+        }
+#elif defined(NOVA_HAS_SSE2)
+        __m128 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+        __m128 abs_x[6], abs_y[6], abs_z[6];
+        for(int p = 0; p < 6; p++) {
+            plane_x[p] = _mm_set1_ps(planes[p][0]);
+            plane_y[p] = _mm_set1_ps(planes[p][1]);
+            plane_z[p] = _mm_set1_ps(planes[p][2]);
+            plane_w[p] = _mm_set1_ps(planes[p][3]);
+            abs_x[p] = _mm_set1_ps(std::abs(planes[p][0]));
+            abs_y[p] = _mm_set1_ps(std::abs(planes[p][1]));
+            abs_z[p] = _mm_set1_ps(std::abs(planes[p][2]));
+        }
+        const __m128 zero = _mm_setzero_ps();
+
+        for(; box + 4 <= num_boxes; box += 4) {
+            __m128 cx = _mm_loadu_ps(&boxes.center_x[box]);
+            __m128 cy = _mm_loadu_ps(&boxes.center_y[box]);
+            __m128 cz = _mm_loadu_ps(&boxes.center_z[box]);
+            __m128 ex = _mm_loadu_ps(&boxes.extent_x[box]);
+            __m128 ey = _mm_loadu_ps(&boxes.extent_y[box]);
+            __m128 ez = _mm_loadu_ps(&boxes.extent_z[box]);
+
+            __m128 crosses = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            __m128 inside = crosses;
+            for(int p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_x[p], cx), _mm_mul_ps(plane_y[p], cy)),
+                                             _mm_add_ps(_mm_mul_ps(plane_z[p], cz), plane_w[p]));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs_x[p], ex), _mm_mul_ps(abs_y[p], ey)),
+                                           _mm_mul_ps(abs_z[p], ez));
+                crosses = _mm_and_ps(crosses, _mm_cmpgt_ps(_mm_add_ps(distance, radius), zero));
+                inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_sub_ps(distance, radius), zero));
+            }
+
+            int crosses_mask = _mm_movemask_ps(crosses);
+            int inside_mask = _mm_movemask_ps(inside);
+            for(int i = 0; i < 4; i++) {
+                visible[box + i] = static_cast<std::uint8_t>(((crosses_mask >> i) & 1) + ((inside_mask >> i) & 1));
+                num_visible += (crosses_mask >> i) & 1;
+            }
+        }
+#endif
+
+        for(; box < num_boxes; box++) {
+            auto result = test_aabb_against_frustum(planes, boxes.get(box));
+            visible[box] = result;
+            num_visible += result != OUTSIDE_FRUSTUM;
+        }
+
+        stats.num_tested += num_boxes;
+        stats.num_rejected += num_boxes - num_visible;
+    }
+}
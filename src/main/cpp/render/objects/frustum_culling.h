@@ -0,0 +1,118 @@
+/*!
+ * \brief Tests lots of bounding boxes against a view frustum at once
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_FRUSTUM_CULLING_H
+#define RENDERER_FRUSTUM_CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../../data_loading/physics/aabb.h"
+
+namespace nova {
+    /*!
+     * \brief The six planes of a view frustum. Each plane is a normal that points into the frustum, then the distance
+     * along that normal
+     */
+    typedef float frustum_planes[6][4];
+
+    /*!
+     * \brief Bounding boxes stored as one array per component, so the culling kernel can load the same component of
+     * four or eight boxes with a single instruction
+     *
+     * Boxes are added, changed and removed by index. Like render_object_bucket, removing a box moves the last one into
+     * its place
+     */
+    class aabb_soa {
+    public:
+        void push_back(const aabb& box);
+
+        void set(std::size_t index, const aabb& box);
+
+        /*!
+         * \brief Removes the box at the given index by moving the last box into its place
+         */
+        void swap_remove(std::size_t index);
+
+        aabb get(std::size_t index) const;
+
+        std::size_t size() const;
+
+        void clear();
+
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> center_z;
+        std::vector<float> extent_x;
+        std::vector<float> extent_y;
+        std::vector<float> extent_z;
+    };
+
+    /*!
+     * \brief What culling found out about a box
+     */
+    enum frustum_test_result : std::uint8_t {
+        OUTSIDE_FRUSTUM = 0,
+        CROSSES_FRUSTUM = 1,
+        INSIDE_FRUSTUM = 2
+    };
+
+    /*!
+     * \brief How much work frustum culling did
+     */
+    struct frustum_cull_stats {
+        /*!
+         * \brief How many bounding boxes were tested, counting both render_objects and the regions they're grouped in
+         */
+        std::size_t num_tested;
+
+        /*!
+         * \brief How many render_objects were culled
+         */
+        std::size_t num_rejected;
+
+        /*!
+         * \brief How many of the culled render_objects were culled along with their whole region, without being
+         * tested themselves
+         */
+        std::size_t num_rejected_by_region;
+    };
+
+    /*!
+     * \brief Tests one bounding box against a frustum
+     *
+     * A box is outside if it's entirely behind any one of the planes. Rather than checking all eight corners, this
+     * checks the corner that's furthest along the plane's normal, which is the center's distance from the plane plus
+     * the extents projected onto the normal
+     *
+     * \return True if any part of the box might be inside the frustum
+     */
+    bool is_aabb_in_frustum(const frustum_planes& planes, const aabb& box);
+
+    /*!
+     * \brief Like is_aabb_in_frustum, but also tells whether the box is entirely inside the frustum, which is the case
+     * when the corner nearest each plane is in front of it
+     */
+    frustum_test_result test_aabb_against_frustum(const frustum_planes& planes, const aabb& box);
+
+    /*!
+     * \brief Tests every box against a frustum
+     *
+     * Boxes are tested eight at a time with AVX or four at a time with SSE, whichever the compiler was told it can use,
+     * with the leftovers tested one at a time. The answers are the same as test_aabb_against_frustum's
+     *
+     * \param planes The frustum to test against
+     * \param boxes The boxes to test
+     * \param visible Resized to the number of boxes. Each box gets a frustum_test_result, so it's 0 if the box is
+     * outside the frustum and nonzero if it might be visible
+     * \param stats The number of boxes tested and rejected are added to this
+     */
+    void cull_aabbs_against_frustum(const frustum_planes& planes, const aabb_soa& boxes,
+                                    std::vector<std::uint8_t>& visible, frustum_cull_stats& stats);
+}
+
+#endif //RENDERER_FRUSTUM_CULLING_H
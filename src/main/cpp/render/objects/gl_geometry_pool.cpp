@@ -0,0 +1,370 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <easylogging++.h>
+#include "gl_geometry_pool.h"
+#include "../windowing/glfw_gl_window.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    static std::size_t get_vertex_size(format vertex_format) {
+        switch(vertex_format) {
+            case format::POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT:
+                return EXPANDED_VERTEX_SIZE_INTS * sizeof(int);
+            case format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT:
+                return COMPACT_VERTEX_SIZE_INTS * sizeof(int);
+            default:
+                return 0;
+        }
+    }
+
+    gl_geometry_pool::page::page(format vertex_format, std::size_t vertex_size) :
+            vertex_format(vertex_format), vertex_size(vertex_size), vertices(VERTEX_PAGE_SIZE / vertex_size),
+            indices(INDEX_PAGE_SIZE / sizeof(GLuint)) {}
+
+    gl_geometry_pool::~gl_geometry_pool() {
+        for(auto& p : pages) {
+            destroy_page(*p);
+        }
+    }
+
+    bool gl_geometry_pool::supports_format(format vertex_format) {
+        return get_vertex_size(vertex_format) > 0;
+    }
+
+    std::unique_ptr<gl_mesh> gl_geometry_pool::create_mesh(const mesh_definition& definition, std::size_t num_quads,
+                                                          std::size_t reserved_quads) {
+        std::size_t vertex_size = get_vertex_size(definition.vertex_format);
+        std::size_t num_vertices = definition.vertex_data.size() * sizeof(int) / vertex_size;
+        if(num_vertices == 0 || num_vertices * vertex_size > VERTEX_PAGE_SIZE) {
+            return nullptr;
+        }
+
+        // Room for quads that aren't there yet. Nothing is drawn from it until it's written to, so it doesn't need to
+        // be cleared
+        std::size_t quad_capacity = num_quads > 0 ? std::max(num_quads, reserved_quads) : 0;
+        std::size_t num_allocated_vertices = std::max(num_vertices, quad_capacity * VERTICES_PER_QUAD);
+        if(num_allocated_vertices * vertex_size > VERTEX_PAGE_SIZE) {
+            quad_capacity = num_quads;
+            num_allocated_vertices = num_vertices;
+        }
+
+        // Work out how the indices will be stored before looking for a page, so we know how much room they need
+        std::vector<GLushort> short_indices;
+        std::size_t num_index_units = 0;
+        GLenum index_type = GL_UNSIGNED_INT;
+        const void* index_data = nullptr;
+
+        if(num_quads == 0) {
+            const auto& indices = definition.indices;
+            if(indices.empty()) {
+                return nullptr;
+            }
+
+            bool fits_in_shorts = std::all_of(indices.begin(), indices.end(), [](int index) {
+                return index >= 0 && index <= std::numeric_limits<GLushort>::max();
+            });
+            if(fits_in_shorts) {
+                short_indices.assign(indices.begin(), indices.end());
+                if(short_indices.size() % 2 != 0) {
+                    short_indices.push_back(0);
+                }
+                index_type = GL_UNSIGNED_SHORT;
+                index_data = short_indices.data();
+                num_index_units = short_indices.size() / 2;
+
+            } else {
+                index_data = indices.data();
+                num_index_units = indices.size();
+            }
+
+            if(num_index_units * sizeof(GLuint) > INDEX_PAGE_SIZE) {
+                return nullptr;
+            }
+        }
+
+        page* target_page = nullptr;
+        std::size_t page_idx = 0;
+        long first_vertex = -1;
+        long first_index_unit = -1;
+
+        for(; page_idx < pages.size(); page_idx++) {
+            auto& p = *pages[page_idx];
+            if(p.vertex_format != definition.vertex_format) {
+                continue;
+            }
+
+            first_vertex = p.vertices.allocate(num_allocated_vertices);
+            if(first_vertex < 0) {
+                continue;
+            }
+
+            if(num_index_units > 0) {
+                first_index_unit = p.indices.allocate(num_index_units);
+                if(first_index_unit < 0) {
+                    p.vertices.free(static_cast<std::size_t>(first_vertex));
+                    continue;
+                }
+            }
+
+            target_page = &p;
+            break;
+        }
+
+        if(target_page == nullptr) {
+            target_page = &create_page(definition.vertex_format);
+            page_idx = pages.size() - 1;
+            first_vertex = target_page->vertices.allocate(num_allocated_vertices);
+            if(num_index_units > 0) {
+                first_index_unit = target_page->indices.allocate(num_index_units);
+            }
+        }
+
+        glNamedBufferSubData(target_page->vertex_buffer, first_vertex * vertex_size, num_vertices * vertex_size,
+                             definition.vertex_data.data());
+
+        auto* allocation = new geometry_allocation();
+        allocation->base_vertex = static_cast<GLint>(first_vertex);
+        allocation->vertex_format = definition.vertex_format;
+        allocation->page = page_idx;
+        allocation->num_vertices = num_allocated_vertices;
+        allocation->first_index_unit = first_index_unit;
+        allocation->num_index_units = num_index_units;
+        allocation->quad_capacity = quad_capacity;
+
+        if(num_quads > 0) {
+            // Make sure the shared indices are long enough before anything draws with them, including anything that
+            // gets patched into the reserved room later
+            quad_indices.get_buffer(quad_capacity);
+
+            allocation->vertex_array = target_page->quad_vertex_array;
+            allocation->index_byte_offset = 0;
+            allocation->index_type = GL_UNSIGNED_INT;
+            allocation->num_indices = static_cast<unsigned int>(num_quads * INDICES_PER_QUAD);
+
+        } else {
+            glNamedBufferSubData(target_page->index_buffer, first_index_unit * sizeof(GLuint),
+                                 num_index_units * sizeof(GLuint), index_data);
+
+            allocation->vertex_array = target_page->indexed_vertex_array;
+            allocation->index_byte_offset = first_index_unit * sizeof(GLuint);
+            allocation->index_type = index_type;
+            allocation->num_indices = static_cast<unsigned int>(definition.indices.size());
+            target_page->index_owners[first_index_unit] = allocation;
+        }
+        target_page->vertex_owners[first_vertex] = allocation;
+        version++;
+
+        return std::make_unique<gl_mesh>(*this, allocation);
+    }
+
+    bool gl_geometry_pool::write_vertices(geometry_allocation& allocation, std::size_t first_vertex, const void* data,
+                                          std::size_t num_vertices) {
+        if(first_vertex > allocation.num_vertices || num_vertices > allocation.num_vertices - first_vertex) {
+            return false;
+        }
+
+        auto& p = *pages[allocation.page];
+        glNamedBufferSubData(p.vertex_buffer, (allocation.base_vertex + first_vertex) * p.vertex_size,
+                             num_vertices * p.vertex_size, data);
+        return true;
+    }
+
+    void gl_geometry_pool::set_num_quads(geometry_allocation& allocation, std::size_t num_quads) {
+        num_quads = std::min(num_quads, allocation.quad_capacity);
+        allocation.num_indices = static_cast<unsigned int>(num_quads * INDICES_PER_QUAD);
+        version++;
+    }
+
+    void gl_geometry_pool::free(geometry_allocation* allocation) {
+        auto& p = *pages[allocation->page];
+
+        p.vertices.free(static_cast<std::size_t>(allocation->base_vertex));
+        p.vertex_owners.erase(static_cast<std::size_t>(allocation->base_vertex));
+
+        if(allocation->first_index_unit >= 0) {
+            p.indices.free(static_cast<std::size_t>(allocation->first_index_unit));
+            p.index_owners.erase(static_cast<std::size_t>(allocation->first_index_unit));
+        }
+
+        delete allocation;
+        version++;
+    }
+
+    std::size_t gl_geometry_pool::defragment(std::size_t max_bytes) {
+        std::size_t bytes_moved = 0;
+
+        for(auto& p : pages) {
+            if(bytes_moved >= max_bytes) {
+                break;
+            }
+
+            if(p->vertices.get_stats().fragmentation > DEFRAGMENT_THRESHOLD) {
+                bytes_moved += compact(p->vertices, p->vertex_owners, p->vertex_buffer, p->vertex_size,
+                                       max_bytes - bytes_moved, [](geometry_allocation& allocation, std::size_t offset) {
+                    allocation.base_vertex = static_cast<GLint>(offset);
+                });
+            }
+
+            if(bytes_moved < max_bytes && p->indices.get_stats().fragmentation > DEFRAGMENT_THRESHOLD) {
+                bytes_moved += compact(p->indices, p->index_owners, p->index_buffer, sizeof(GLuint),
+                                       max_bytes - bytes_moved, [](geometry_allocation& allocation, std::size_t offset) {
+                    allocation.first_index_unit = static_cast<long>(offset);
+                    allocation.index_byte_offset = offset * sizeof(GLuint);
+                });
+            }
+        }
+
+        bytes_moved_last_defragment = bytes_moved;
+        total_bytes_moved += bytes_moved;
+
+        return bytes_moved;
+    }
+
+    std::size_t gl_geometry_pool::compact(range_allocator& allocator,
+                                          std::unordered_map<std::size_t, geometry_allocation*>& owners, GLuint buffer,
+                                          std::size_t unit_size, std::size_t max_bytes,
+                                          std::function<void(geometry_allocation&, std::size_t)> on_moved) {
+        std::size_t bytes_moved = 0;
+
+        // Walk down from the highest allocation, moving each one into the lowest hole it fits in. Once we reach the
+        // lowest hole, everything below it is already packed
+        const auto& allocations = allocator.get_allocations();
+        auto upper_limit = std::numeric_limits<std::size_t>::max();
+
+        while(true) {
+            auto candidate = allocations.lower_bound(upper_limit);
+            if(candidate == allocations.begin()) {
+                break;
+            }
+            --candidate;
+
+            std::size_t offset = candidate->first;
+            std::size_t size = candidate->second;
+            upper_limit = offset;
+
+            long destination = allocator.find_free_range(size);
+            if(destination < 0) {
+                continue;
+            }
+
+            if(static_cast<std::size_t>(destination) > offset) {
+                // Nothing below this one has room for it. If there's no room below it at all, we're done
+                if(allocator.find_free_range(1) > static_cast<long>(offset)) {
+                    break;
+                }
+                continue;
+            }
+
+            std::size_t num_bytes = size * unit_size;
+            if(bytes_moved > 0 && bytes_moved + num_bytes > max_bytes) {
+                break;
+            }
+
+            allocator.allocate(size);
+            glCopyNamedBufferSubData(buffer, buffer, offset * unit_size, destination * unit_size, num_bytes);
+            allocator.free(offset);
+
+            auto* owner = owners[offset];
+            owners.erase(offset);
+            owners[destination] = owner;
+            on_moved(*owner, static_cast<std::size_t>(destination));
+            version++;
+
+            bytes_moved += num_bytes;
+        }
+
+        return bytes_moved;
+    }
+
+    static void add_allocator_stats(range_allocator_stats& total, const range_allocator_stats& page_stats,
+                                    std::size_t unit_size) {
+        total.capacity += page_stats.capacity * unit_size;
+        total.num_allocated += page_stats.num_allocated * unit_size;
+        total.num_allocations += page_stats.num_allocations;
+        total.num_free_ranges += page_stats.num_free_ranges;
+        total.largest_free_range = std::max(total.largest_free_range, page_stats.largest_free_range * unit_size);
+    }
+
+    static void finish_allocator_stats(range_allocator_stats& total) {
+        std::size_t num_free = total.capacity - total.num_allocated;
+        total.fragmentation = num_free > 0 ? 1.0f - static_cast<float>(total.largest_free_range) / num_free : 0.0f;
+    }
+
+    geometry_pool_stats gl_geometry_pool::get_stats() const {
+        geometry_pool_stats stats = {};
+        stats.num_pages = pages.size();
+        stats.bytes_moved_last_defragment = bytes_moved_last_defragment;
+        stats.total_bytes_moved = total_bytes_moved;
+
+        for(const auto& p : pages) {
+            add_allocator_stats(stats.vertices, p->vertices.get_stats(), p->vertex_size);
+            add_allocator_stats(stats.indices, p->indices.get_stats(), sizeof(GLuint));
+        }
+        finish_allocator_stats(stats.vertices);
+        finish_allocator_stats(stats.indices);
+
+        return stats;
+    }
+
+    std::uint64_t gl_geometry_pool::get_version() const {
+        return version;
+    }
+
+    gl_quad_index_buffer& gl_geometry_pool::get_quad_indices() {
+        return quad_indices;
+    }
+
+    gl_geometry_pool::page& gl_geometry_pool::create_page(format vertex_format) {
+        pages.push_back(std::make_unique<page>(vertex_format, get_vertex_size(vertex_format)));
+        auto& p = *pages.back();
+
+        glCreateBuffers(1, &p.vertex_buffer);
+        glNamedBufferStorage(p.vertex_buffer, VERTEX_PAGE_SIZE, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        glCreateBuffers(1, &p.index_buffer);
+        glNamedBufferStorage(p.index_buffer, INDEX_PAGE_SIZE, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+        GLuint shared_quad_buffer = quad_indices.get_buffer(gl_quad_index_buffer::DEFAULT_NUM_QUADS);
+
+        glGenVertexArrays(1, &p.indexed_vertex_array);
+        glBindVertexArray(p.indexed_vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, p.vertex_buffer);
+        gl_mesh::enable_vertex_attributes(vertex_format);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p.index_buffer);
+
+        glGenVertexArrays(1, &p.quad_vertex_array);
+        glBindVertexArray(p.quad_vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, p.vertex_buffer);
+        gl_mesh::enable_vertex_attributes(vertex_format);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shared_quad_buffer);
+
+        glBindVertexArray(0);
+
+        LOG(DEBUG) << "Created geometry pool page " << pages.size() - 1 << " for " << vertex_format.to_string()
+                   << " vertices";
+
+        return p;
+    }
+
+    void gl_geometry_pool::destroy_page(page& p) {
+        for(auto& owner : p.vertex_owners) {
+            delete owner.second;
+        }
+        p.vertex_owners.clear();
+        p.index_owners.clear();
+
+        if(glfwGetCurrentContext() == nullptr) {
+            return;
+        }
+
+        glDeleteVertexArrays(1, &p.indexed_vertex_array);
+        glDeleteVertexArrays(1, &p.quad_vertex_array);
+        glDeleteBuffers(1, &p.vertex_buffer);
+        glDeleteBuffers(1, &p.index_buffer);
+    }
+}
@@ -0,0 +1,237 @@
+/*!
+ * \brief Packs lots of small meshes into a few big GPU buffers
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_GL_GEOMETRY_POOL_H
+#define RENDERER_GL_GEOMETRY_POOL_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "gl_mesh.h"
+#include "gl_quad_index_buffer.h"
+#include "../../utils/range_allocator.h"
+
+namespace nova {
+    /*!
+     * \brief Where one mesh's data lives in a gl_geometry_pool, and everything needed to draw it
+     *
+     * Owned by the pool. The offsets change when the pool moves the mesh's data around during defragmentation, so read
+     * them when drawing rather than holding on to them
+     */
+    struct geometry_allocation {
+        /*!
+         * \brief The vertex array to bind before drawing. Either the page's own index buffer or the shared quad index
+         * buffer is bound to it
+         */
+        GLuint vertex_array;
+        GLint base_vertex;
+        std::size_t index_byte_offset;
+        GLenum index_type;
+        unsigned int num_indices;
+        format vertex_format;
+
+        std::size_t page;
+        std::size_t num_vertices;
+
+        /*!
+         * \brief Where the mesh's indices are in the page's index allocator, or -1 if the mesh uses the shared quad
+         * indices
+         */
+        long first_index_unit;
+        std::size_t num_index_units;
+
+        /*!
+         * \brief How many quads the allocation has room for, if the mesh is drawn with the shared quad indices. Can be
+         * more than it's drawing, so that it can be patched without moving
+         */
+        std::size_t quad_capacity;
+    };
+
+    /*!
+     * \brief Counters that describe how full and how fragmented a gl_geometry_pool is
+     *
+     * All the allocator numbers are in bytes and are totals across every page
+     */
+    struct geometry_pool_stats {
+        std::size_t num_pages;
+        range_allocator_stats vertices;
+        range_allocator_stats indices;
+        std::size_t bytes_moved_last_defragment;
+        std::size_t total_bytes_moved;
+    };
+
+    /*!
+     * \brief Sub-allocates vertex and index ranges out of a few large, fixed-size GPU buffers
+     *
+     * Creating a separate vertex array and buffers for every chunk section means thousands of tiny GL objects at high
+     * render distances. Instead, the pool keeps pages of one big vertex buffer and one big index buffer each, and hands
+     * out ranges of them. Each page only holds one vertex format, so a mesh's place in the page can be described with
+     * a base vertex and every mesh in a page can share the page's vertex arrays.
+     *
+     * Meshes that are nothing but a list of quads don't get an index range at all. They're drawn with the pool's
+     * shared quad index buffer instead.
+     *
+     * Freeing a mesh leaves a hole in its page. #defragment fills those holes by moving the highest meshes down into
+     * them a little bit at a time, so the free space ends up in one piece at the end of the page.
+     *
+     * Everything here must be called from the render thread
+     */
+    class gl_geometry_pool {
+    public:
+        /*!
+         * \brief The size of each page's vertex buffer
+         */
+        static const std::size_t VERTEX_PAGE_SIZE = 64 * 1024 * 1024;
+
+        /*!
+         * \brief The size of each page's index buffer. Most chunks use the shared quad indices, so this can be small
+         */
+        static const std::size_t INDEX_PAGE_SIZE = 8 * 1024 * 1024;
+
+        /*!
+         * \brief Pages that are more fragmented than this get defragmented. See range_allocator_stats::fragmentation
+         */
+        const float DEFRAGMENT_THRESHOLD = 0.25f;
+
+        gl_geometry_pool() = default;
+
+        ~gl_geometry_pool();
+
+        gl_geometry_pool(const gl_geometry_pool&) = delete;
+        gl_geometry_pool& operator=(const gl_geometry_pool&) = delete;
+
+        /*!
+         * \brief Checks if meshes with the given vertex format can go in the pool
+         */
+        static bool supports_format(format vertex_format);
+
+        /*!
+         * \brief Copies the given geometry into the pool and makes a mesh that draws it
+         *
+         * \param definition The geometry to copy. Its vertex format must be one that supports_format accepts
+         * \param num_quads If this isn't zero, the geometry is a plain list of this many quads and its indices are
+         * ignored
+         * \param reserved_quads For a plain list of quads, how many quads to make room for. The room past num_quads
+         * isn't drawn until something is written there with write_vertices
+         * \return The new mesh, or nullptr if the geometry is too big for a page
+         */
+        std::unique_ptr<gl_mesh> create_mesh(const mesh_definition& definition, std::size_t num_quads,
+                                             std::size_t reserved_quads = 0);
+
+        /*!
+         * \brief Overwrites some of an allocation's vertices
+         *
+         * \param allocation The allocation to write to
+         * \param first_vertex The first vertex to write, counting from the start of the allocation
+         * \param data The vertex data, in the allocation's vertex format
+         * \param num_vertices How many vertices to write. Writes that would go past the end of the allocation are
+         * ignored
+         * \return True if the vertices were written
+         */
+        bool write_vertices(geometry_allocation& allocation, std::size_t first_vertex, const void* data,
+                            std::size_t num_vertices);
+
+        /*!
+         * \brief Changes how many of a quad allocation's quads are drawn. Clamped to the allocation's quad_capacity
+         */
+        void set_num_quads(geometry_allocation& allocation, std::size_t num_quads);
+
+        /*!
+         * \brief Gives the allocation's ranges back to the pool. Called by gl_mesh when a pooled mesh is destroyed
+         */
+        void free(geometry_allocation* allocation);
+
+        /*!
+         * \brief Moves some meshes down into the holes that freed meshes left behind
+         *
+         * \param max_bytes About how many bytes of geometry to move. At least one mesh is moved if there's anything to
+         * move, even if that mesh is bigger than this
+         * \return The number of bytes that were moved
+         */
+        std::size_t defragment(std::size_t max_bytes);
+
+        geometry_pool_stats get_stats() const;
+
+        /*!
+         * \brief Goes up whenever a mesh is added, freed, moved, or changes how much it draws, so anything that copies
+         * allocations' offsets can tell when its copy is stale
+         */
+        std::uint64_t get_version() const;
+
+        /*!
+         * \brief Returns the shared quad index buffer, for meshes that don't fit in the pool
+         */
+        gl_quad_index_buffer& get_quad_indices();
+
+    private:
+        struct page {
+            format vertex_format;
+            std::size_t vertex_size;
+
+            GLuint vertex_buffer;
+            GLuint index_buffer;
+
+            /*!
+             * \brief Vertex array with the page's index buffer bound
+             */
+            GLuint indexed_vertex_array;
+
+            /*!
+             * \brief Vertex array with the shared quad index buffer bound
+             */
+            GLuint quad_vertex_array;
+
+            /*!
+             * \brief Hands out ranges of vertex_buffer, in vertices
+             */
+            range_allocator vertices;
+
+            /*!
+             * \brief Hands out ranges of index_buffer, in four-byte units so that indices stored as unsigned shorts and
+             * indices stored as unsigned ints can share the buffer
+             */
+            range_allocator indices;
+
+            std::unordered_map<std::size_t, geometry_allocation*> vertex_owners;
+            std::unordered_map<std::size_t, geometry_allocation*> index_owners;
+
+            page(format vertex_format, std::size_t vertex_size);
+        };
+
+        std::vector<std::unique_ptr<page>> pages;
+
+        gl_quad_index_buffer quad_indices;
+
+        std::size_t bytes_moved_last_defragment = 0;
+        std::size_t total_bytes_moved = 0;
+        std::uint64_t version = 0;
+
+        page& create_page(format vertex_format);
+
+        void destroy_page(page& p);
+
+        /*!
+         * \brief Moves allocations from the top of one of a page's allocators down into lower free ranges
+         *
+         * \param allocator The allocator to compact
+         * \param owners The allocations that own each range in the allocator
+         * \param buffer The GPU buffer that the allocator hands out ranges of
+         * \param unit_size The size in bytes of one unit of the allocator
+         * \param max_bytes About how many bytes to move
+         * \param on_moved Updates an allocation after its range has moved to the given offset
+         * \return How many bytes were moved
+         */
+        std::size_t compact(range_allocator& allocator, std::unordered_map<std::size_t, geometry_allocation*>& owners,
+                            GLuint buffer, std::size_t unit_size, std::size_t max_bytes,
+                            std::function<void(geometry_allocation&, std::size_t)> on_moved);
+    };
+}
+
+#endif //RENDERER_GL_GEOMETRY_POOL_H
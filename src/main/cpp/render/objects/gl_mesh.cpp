@@ -4,12 +4,16 @@
  */
 
 #include <stdexcept>
+#include <algorithm>
+#include <limits>
 #include <easylogging++.h>
 #include "gl_mesh.h"
+#include "gl_geometry_pool.h"
+#include "../../geometry_cache/vertex_kernels.h"
 #include "../windowing/glfw_gl_window.h"
 
 namespace nova {
-    gl_mesh::gl_mesh() : vertex_array(0), vertex_buffer(0), indices(0), num_indices(0) {
+    gl_mesh::gl_mesh() : vertex_buffer(0), indices(0), vertex_array(0), num_indices(0) {
         create();
     }
 
@@ -19,6 +23,10 @@ namespace nova {
         set_index_array(definition.indices, usage::static_draw);
     }
 
+    gl_mesh::gl_mesh(gl_geometry_pool& pool, geometry_allocation* allocation) :
+            data_format(allocation->vertex_format), vertex_buffer(0), indices(0), pool(&pool), allocation(allocation),
+            vertex_array(0), num_indices(allocation->num_indices) {}
+
     gl_mesh::~gl_mesh() {
         destroy();
     }
@@ -31,6 +39,14 @@ namespace nova {
     }
 
     void gl_mesh::destroy() {
+        if(pool != nullptr) {
+            pool->free(allocation);
+            pool = nullptr;
+            allocation = nullptr;
+            num_indices = 0;
+            return;
+        }
+
         if(vertex_buffer != 0) {
             if(glfwGetCurrentContext() != nullptr) {
                 glDeleteBuffers(1, &vertex_buffer);
@@ -39,7 +55,7 @@ namespace nova {
         }
 
         if(indices != 0) {
-            if(glfwGetCurrentContext() != nullptr) {
+            if(owns_indices && glfwGetCurrentContext() != nullptr) {
                 glDeleteBuffers(1, &indices);
             }
             indices = 0;
@@ -47,6 +63,10 @@ namespace nova {
     }
 
     void gl_mesh::set_data(std::vector<int> data, format data_format, usage data_usage) {
+        if(pool != nullptr) {
+            throw std::runtime_error("Can't change the data of a mesh that lives in a geometry pool");
+        }
+
         this->data_format = data_format;
 
         glBindVertexArray(vertex_array);
@@ -67,22 +87,114 @@ namespace nova {
     }
 
     void gl_mesh::set_active() const {
+        if(allocation != nullptr) {
+            glBindVertexArray(allocation->vertex_array);
+            return;
+        }
+
         glBindVertexArray(vertex_array);
         glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
     }
 
     void gl_mesh::set_index_array(std::vector<int> data, usage data_usage) {
+        if(pool != nullptr) {
+            throw std::runtime_error("Can't change the indices of a mesh that lives in a geometry pool");
+        }
+
+        if(!owns_indices) {
+            glGenBuffers(1, &indices);
+            owns_indices = true;
+        }
+
         glBindVertexArray(vertex_array);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
         GLenum buffer_usage = translate_usage(data_usage);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size() * sizeof(unsigned int), data.data(), buffer_usage);
+
+        bool fits_in_shorts = std::all_of(data.begin(), data.end(), [](int index) {
+            return index >= 0 && index <= std::numeric_limits<GLushort>::max();
+        });
+        if(fits_in_shorts) {
+            std::vector<GLushort> short_data(data.begin(), data.end());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, short_data.size() * sizeof(GLushort), short_data.data(), buffer_usage);
+            index_type = GL_UNSIGNED_SHORT;
+
+        } else {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size() * sizeof(unsigned int), data.data(), buffer_usage);
+            index_type = GL_UNSIGNED_INT;
+        }
 
         num_indices = (unsigned int) data.size();
     }
 
+    void gl_mesh::set_shared_index_array(GLuint buffer, unsigned int num_indices) {
+        if(pool != nullptr) {
+            throw std::runtime_error("Can't change the indices of a mesh that lives in a geometry pool");
+        }
+
+        if(owns_indices && indices != 0) {
+            glDeleteBuffers(1, &indices);
+        }
+        indices = buffer;
+        owns_indices = false;
+
+        glBindVertexArray(vertex_array);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices);
+
+        index_type = GL_UNSIGNED_INT;
+        this->num_indices = num_indices;
+    }
+
+    bool gl_mesh::write_quads(std::size_t first_quad, const int* data, std::size_t num_quads) {
+        if(get_quad_capacity() == 0) {
+            return false;
+        }
+
+        return pool->write_vertices(*allocation, first_quad * VERTICES_PER_QUAD, data, num_quads * VERTICES_PER_QUAD);
+    }
+
+    void gl_mesh::set_num_quads(std::size_t num_quads) {
+        if(get_quad_capacity() == 0) {
+            return;
+        }
+
+        pool->set_num_quads(*allocation, num_quads);
+        this->num_indices = allocation->num_indices;
+    }
+
+    std::size_t gl_mesh::get_quad_capacity() const {
+        if(allocation == nullptr) {
+            return 0;
+        }
+
+        return allocation->quad_capacity;
+    }
+
     void gl_mesh::draw() const {
-        glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_INT, nullptr);
+        if(allocation != nullptr) {
+            glDrawElementsBaseVertex(GL_TRIANGLES, num_indices, allocation->index_type,
+                                     (void *) allocation->index_byte_offset, allocation->base_vertex);
+            return;
+        }
+
+        glDrawElements(GL_TRIANGLES, num_indices, index_type, nullptr);
+    }
+
+    bool gl_mesh::draw_quads(std::size_t first_quad, std::size_t num_quads) const {
+        if(get_quad_capacity() == 0) {
+            return false;
+        }
+
+        // Every quad uses the same six indices, so moving the base vertex moves the draw along the quads
+        std::size_t num_drawn_quads = num_indices / INDICES_PER_QUAD;
+        first_quad = std::min(first_quad, num_drawn_quads);
+        num_quads = std::min(num_quads, num_drawn_quads - first_quad);
+        if(num_quads > 0) {
+            auto base_vertex = allocation->base_vertex + static_cast<GLint>(first_quad * VERTICES_PER_QUAD);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(num_quads * INDICES_PER_QUAD),
+                                     allocation->index_type, (void *) allocation->index_byte_offset, base_vertex);
+        }
+        return true;
     }
 
     void gl_mesh::enable_vertex_attributes(format data_format) {
@@ -142,6 +254,36 @@ namespace nova {
                 // tangent
                 glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 13 * sizeof(GLfloat), (void *) (44 * sizeof(GLbyte)));
 
+                break;
+
+            case format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT:
+                // See vertex_kernels.h for the layout. Positions are scaled and biased, so the model matrix has to
+                // undo that
+                glEnableVertexAttribArray(0);   // Position
+                glEnableVertexAttribArray(1);   // Texture UV
+                glEnableVertexAttribArray(2);   // Lightmap UV
+                glEnableVertexAttribArray(3);   // Normal
+                glEnableVertexAttribArray(4);   // Tile repeat data
+                glEnableVertexAttribArray(5);   // Color
+
+                // position
+                glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE, 24, nullptr);
+
+                // lightmap UV
+                glVertexAttribPointer(2, 2, GL_UNSIGNED_BYTE, GL_FALSE, 24, (void *) (6 * sizeof(GLbyte)));
+
+                // color
+                glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_FALSE, 24, (void *) (8 * sizeof(GLbyte)));
+
+                // texture UV
+                glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, 24, (void *) (12 * sizeof(GLbyte)));
+
+                // normal
+                glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, 24, (void *) (16 * sizeof(GLbyte)));
+
+                // tile repeat data, in the tangent's slot
+                glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_FALSE, 24, (void *) (20 * sizeof(GLbyte)));
+
                 break;
         }
     }
@@ -153,4 +295,8 @@ namespace nova {
     bool gl_mesh::has_data() const {
         return num_indices > 0;
     }
+
+    const geometry_allocation* gl_mesh::get_allocation() const {
+        return allocation;
+    }
 }
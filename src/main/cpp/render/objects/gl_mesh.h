@@ -12,6 +12,9 @@
 #include "../../data_loading/physics/aabb.h"
 
 namespace nova {
+    class gl_geometry_pool;
+    struct geometry_allocation;
+
     /*!
      * \brief Specifies how the data in thie buffer will be used
      */
@@ -31,7 +34,8 @@ namespace nova {
      * \brief Represents a buffer which holds vertex information
      *
      * Buffers of this type can hold positions, positions and texture coordinates, or positions, texture coordinates,
-     * lightmap coordinates, normals, and tangents.
+     * lightmap coordinates, normals, and tangents. The compact chunk format has no tangents, see
+     * COMPACT_VERTEX_SIZE_INTS
      */
     class gl_mesh {
     public:
@@ -39,6 +43,17 @@ namespace nova {
 
         explicit gl_mesh(const mesh_definition &definition);
 
+        /*!
+         * \brief Makes a mesh that draws geometry living in a gl_geometry_pool
+         *
+         * Pooled meshes don't have any GL objects of their own, and their data can't be changed. Use
+         * gl_geometry_pool::create_mesh rather than calling this directly
+         *
+         * \param pool The pool that the geometry lives in
+         * \param allocation Where in the pool the geometry is. The mesh gives it back to the pool when destroyed
+         */
+        gl_mesh(gl_geometry_pool& pool, geometry_allocation* allocation);
+
         ~gl_mesh();
 
         void create();
@@ -53,12 +68,59 @@ namespace nova {
          */
         void set_data(std::vector<int> data, format data_format, usage data_usage);
 
+        /*!
+         * \brief Uploads the given indices into this mesh's own index buffer
+         *
+         * If every index fits in an unsigned short, the indices are stored as unsigned shorts to save memory
+         *
+         * \param data The indices
+         * \param data_usage How often the indices will change
+         */
         void set_index_array(std::vector<int> data, usage data_usage);
 
+        /*!
+         * \brief Draws this mesh with someone else's index buffer instead of its own
+         *
+         * The mesh doesn't take ownership of the buffer, so whoever owns it needs to keep it alive for as long as this
+         * mesh is drawn. Calling #set_index_array afterwards gives the mesh its own index buffer again
+         *
+         * \param buffer The index buffer to use. Must hold at least num_indices unsigned ints
+         * \param num_indices How many indices to draw
+         */
+        void set_shared_index_array(GLuint buffer, unsigned int num_indices);
+
+        /*!
+         * \brief Overwrites some of the quads of a pooled mesh that's drawn with the shared quad indices
+         *
+         * \param first_quad The first quad to overwrite
+         * \param data The new vertex data, in the mesh's format
+         * \param num_quads How many quads are in data
+         * \return False if the mesh doesn't have room for the quads, or isn't a pooled list of quads
+         */
+        bool write_quads(std::size_t first_quad, const int* data, std::size_t num_quads);
+
+        /*!
+         * \brief Changes how many quads a pooled list of quads draws. Does nothing to other meshes
+         */
+        void set_num_quads(std::size_t num_quads);
+
+        /*!
+         * \brief Returns how many quads a pooled list of quads has room for, or 0 if this mesh can't have quads written
+         * to it
+         */
+        std::size_t get_quad_capacity() const;
+
         void set_active() const;
 
         void draw() const;
 
+        /*!
+         * \brief Draws a run of a pooled list of quads
+         *
+         * \return False if the mesh isn't a pooled list of quads, so nothing was drawn
+         */
+        bool draw_quads(std::size_t first_quad, std::size_t num_quads) const;
+
         /*!
          * \brief Returns the format of this vertex buffer
          *
@@ -68,20 +130,42 @@ namespace nova {
 
         bool has_data() const;
 
+        /*!
+         * \brief Returns where a pooled mesh's geometry lives, or nullptr if the mesh has its own buffers
+         */
+        const geometry_allocation* get_allocation() const;
+
+        /*!
+         * \brief Enables all the proper OpenGL vertex attributes for the given format
+         *
+         * Enables the proper vertex attribute array bind points and the vertex attribute pointers for whatever vertex
+         * array and array buffer are bound
+         */
+        static void enable_vertex_attributes(format data_format);
+
     private:
         format data_format;
 
         GLuint vertex_buffer;
         GLuint indices;
 
-        GLenum translate_usage(usage data_usage) const;
+        /*!
+         * \brief GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, depending on how the indices are stored
+         */
+        GLenum index_type = GL_UNSIGNED_INT;
 
         /*!
-         * \brief Enables all the proper OpenGL vertex attributes for the given format
-         *
-         * Enables the proper vertex attribute array bind points and the vertex attribute pointers
+         * \brief False if `indices` is a shared buffer that someone else will delete
          */
-        void enable_vertex_attributes(format data_format);
+        bool owns_indices = true;
+
+        /*!
+         * \brief The pool that this mesh's data lives in, or nullptr if the mesh has its own buffers
+         */
+        gl_geometry_pool* pool = nullptr;
+        geometry_allocation* allocation = nullptr;
+
+        GLenum translate_usage(usage data_usage) const;
 
         unsigned int vertex_array;
         unsigned int num_indices;
@@ -0,0 +1,49 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <vector>
+#include <easylogging++.h>
+#include "gl_quad_index_buffer.h"
+#include "../windowing/glfw_gl_window.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    gl_quad_index_buffer::~gl_quad_index_buffer() {
+        if(buffer != 0 && glfwGetCurrentContext() != nullptr) {
+            glDeleteBuffers(1, &buffer);
+        }
+    }
+
+    GLuint gl_quad_index_buffer::get_buffer(std::size_t num_quads_needed) {
+        if(num_quads_needed <= num_quads) {
+            return buffer;
+        }
+
+        std::size_t new_num_quads = num_quads == 0 ? DEFAULT_NUM_QUADS : num_quads;
+        while(new_num_quads < num_quads_needed) {
+            new_num_quads *= 2;
+        }
+
+        if(buffer == 0) {
+            glGenBuffers(1, &buffer);
+        }
+
+        auto indices = make_quad_indices(new_num_quads);
+
+        // Binding to GL_COPY_WRITE_BUFFER so we don't disturb whatever vertex array is bound right now
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        LOG(DEBUG) << "Grew the shared quad index buffer from " << num_quads << " to " << new_num_quads << " quads";
+        num_quads = new_num_quads;
+
+        return buffer;
+    }
+
+    std::size_t gl_quad_index_buffer::get_num_quads() const {
+        return num_quads;
+    }
+}
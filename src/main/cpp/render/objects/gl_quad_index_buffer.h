@@ -0,0 +1,60 @@
+/*!
+ * \brief An index buffer that every quad-list mesh can share
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_GL_QUAD_INDEX_BUFFER_H
+#define RENDERER_GL_QUAD_INDEX_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace nova {
+    /*!
+     * \brief Holds the indices for a long list of quads, so meshes made of quads don't need their own index buffer
+     *
+     * Minecraft's terrain is always quads, and the indices for quad N are always 4N, 4N+1, 4N+2, 4N, 4N+2, 4N+3. That
+     * means every chunk's indices are the start of the same list, so we upload that list once and let every chunk
+     * mesh bind it and draw as much of it as it needs.
+     *
+     * The buffer grows when a mesh needs more quads than it has. The buffer's name never changes, so meshes that
+     * already use it keep working
+     */
+    class gl_quad_index_buffer {
+    public:
+        /*!
+         * \brief Enough quads for a chunk section that's half full of exposed faces
+         */
+        static const std::size_t DEFAULT_NUM_QUADS = 16384;
+
+        gl_quad_index_buffer() = default;
+
+        ~gl_quad_index_buffer();
+
+        gl_quad_index_buffer(const gl_quad_index_buffer&) = delete;
+        gl_quad_index_buffer& operator=(const gl_quad_index_buffer&) = delete;
+
+        /*!
+         * \brief Makes sure the buffer has indices for at least the given number of quads, and returns the buffer
+         *
+         * Must be called from the render thread
+         *
+         * \param num_quads The number of quads that someone wants to draw
+         * \return The OpenGL name of the index buffer
+         */
+        GLuint get_buffer(std::size_t num_quads);
+
+        /*!
+         * \brief Returns how many quads the buffer has indices for right now
+         */
+        std::size_t get_num_quads() const;
+
+    private:
+        GLuint buffer = 0;
+        std::size_t num_quads = 0;
+    };
+}
+
+#endif //RENDERER_GL_QUAD_INDEX_BUFFER_H
@@ -0,0 +1,619 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <string>
+#include <easylogging++.h>
+#include "gpu_culler.h"
+#include "gl_geometry_pool.h"
+#include "shaders/gl_shader_program.h"
+#include "../windowing/glfw_gl_window.h"
+
+namespace nova {
+    /*!
+     * \brief The size of a DrawElementsIndirectCommand: count, instanceCount, firstIndex, baseVertex, baseInstance
+     */
+    static const std::size_t COMMAND_SIZE = 5 * sizeof(GLuint);
+    static const std::size_t DRAW_POSITION_SIZE = 4 * sizeof(float);
+
+    /*!
+     * \brief The renderer binds textures to units 0 through 3, so the compute shaders read from the one after them
+     */
+    static const GLuint SOURCE_TEXTURE_UNIT = 4;
+
+    static const GLuint CULL_GROUP_SIZE = 64;
+    static const GLuint REDUCE_GROUP_SIZE = 8;
+
+    /*!
+     * \brief Makes each texel of the destination the farthest depth of the source texels under it
+     *
+     * Sizes are rounded down at each level, so when the source has an odd size, the last row or column of the
+     * destination also covers the source's last row or column
+     */
+    static const char* REDUCE_SHADER_SOURCE = R"(#version 450
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 4) uniform sampler2D source;
+layout(r32f, binding = 0) uniform writeonly image2D destination;
+
+uniform int source_level;
+uniform ivec2 source_size;
+uniform int scale;
+
+void main() {
+    ivec2 destination_size = imageSize(destination);
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if(texel.x >= destination_size.x || texel.y >= destination_size.y) {
+        return;
+    }
+
+    ivec2 first = texel * scale;
+    ivec2 last = first + ivec2(scale - 1);
+    if(texel.x == destination_size.x - 1) {
+        last.x = source_size.x - 1;
+    }
+    if(texel.y == destination_size.y - 1) {
+        last.y = source_size.y - 1;
+    }
+
+    float farthest = 0.0;
+    for(int y = first.y; y <= last.y; y++) {
+        for(int x = first.x; x <= last.x; x++) {
+            farthest = max(farthest, texelFetch(source, ivec2(x, y), source_level).r);
+        }
+    }
+
+    imageStore(destination, texel, vec4(farthest));
+}
+)";
+
+    /*!
+     * \brief Culls one record per invocation and appends a draw command for it if it survives
+     *
+     * MAX_DRAW_LEVELS is defined in front of this
+     */
+    static const char* CULL_SHADER_SOURCE = R"(
+layout(local_size_x = 64) in;
+
+struct draw_record {
+    vec4 center_and_num_lods;
+    vec4 extent;
+    vec4 position;
+    uvec4 levels[MAX_DRAW_LEVELS];
+};
+
+layout(std430, binding = 0) readonly buffer records_buffer {
+    draw_record records[];
+};
+
+layout(std430, binding = 1) readonly buffer groups_buffer {
+    uint group_first_command[];
+};
+
+layout(std430, binding = 2) writeonly buffer commands_buffer {
+    uint commands[];
+};
+
+layout(std430, binding = 3) buffer counts_buffer {
+    uint counts[];
+};
+
+layout(std430, binding = 4) writeonly buffer positions_buffer {
+    vec4 draw_positions[];
+};
+
+layout(std430, binding = 5) buffer lod_levels_buffer {
+    uint lod_levels[];
+};
+
+layout(binding = 4) uniform sampler2D hi_z;
+
+uniform uint num_records;
+uniform vec4 frustum[6];
+uniform vec3 camera_position;
+uniform float lod_base_distance;
+uniform float lod_hysteresis;
+
+uniform bool use_hi_z;
+uniform mat4 hi_z_view_projection;
+uniform ivec2 hi_z_size;
+uniform int hi_z_levels;
+
+bool is_in_frustum(vec3 center, vec3 extent) {
+    for(int i = 0; i < 6; i++) {
+        float distance = dot(frustum[i].xyz, center) + frustum[i].w;
+        float radius = dot(abs(frustum[i].xyz), extent);
+        if(distance + radius <= 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_hidden(vec3 box_min, vec3 box_max) {
+    vec2 screen_min = vec2(1.0);
+    vec2 screen_max = vec2(0.0);
+    float nearest = 1.0;
+
+    for(int corner = 0; corner < 8; corner++) {
+        vec3 point = vec3((corner & 1) != 0 ? box_max.x : box_min.x, (corner & 2) != 0 ? box_max.y : box_min.y,
+                          (corner & 4) != 0 ? box_max.z : box_min.z);
+        vec4 clip = hi_z_view_projection * vec4(point, 1.0);
+        if(clip.w <= 0.0) {
+            // Reaches behind the camera
+            return false;
+        }
+
+        vec3 window = clip.xyz / clip.w * 0.5 + 0.5;
+        screen_min = min(screen_min, window.xy);
+        screen_max = max(screen_max, window.xy);
+        nearest = min(nearest, window.z);
+    }
+
+    screen_min = clamp(screen_min, 0.0, 1.0);
+    screen_max = clamp(screen_max, 0.0, 1.0);
+    if(screen_min.x >= screen_max.x || screen_min.y >= screen_max.y) {
+        // Off the screen last frame, so there's nothing to test against
+        return false;
+    }
+
+    ivec2 first_pixel = min(ivec2(screen_min * vec2(hi_z_size)), hi_z_size - 1);
+    ivec2 last_pixel = min(ivec2(screen_max * vec2(hi_z_size)), hi_z_size - 1);
+
+    // The level where the box covers at most two texels each way, so four texels cover all of it
+    int size = max(last_pixel.x - first_pixel.x, last_pixel.y - first_pixel.y) + 1;
+    int level = size <= 1 ? 0 : findMSB(size - 1) + 1;
+    level = min(level, hi_z_levels - 1);
+
+    ivec2 level_size = textureSize(hi_z, level);
+    ivec2 first = min(first_pixel >> level, level_size - 1);
+    ivec2 last = min(last_pixel >> level, level_size - 1);
+
+    float farthest = max(max(texelFetch(hi_z, first, level).r, texelFetch(hi_z, ivec2(last.x, first.y), level).r),
+                         max(texelFetch(hi_z, ivec2(first.x, last.y), level).r, texelFetch(hi_z, last, level).r));
+    return nearest > farthest;
+}
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if(index >= num_records) {
+        return;
+    }
+
+    vec3 center = records[index].center_and_num_lods.xyz;
+    vec3 extent = records[index].extent.xyz;
+    if(!is_in_frustum(center, extent)) {
+        return;
+    }
+
+    if(use_hi_z && is_hidden(center - extent, center + extent)) {
+        return;
+    }
+
+    // Like select_lod_level, level N starts at lod_base_distance * 2^(N - 1), and the level only changes once the
+    // distance is past that by the hysteresis
+    uint num_lods = uint(records[index].center_and_num_lods.w);
+    float distance = length(center - camera_position);
+    uint level = min(lod_levels[index], num_lods);
+    while(level < num_lods && distance > lod_base_distance * exp2(float(level)) * (1.0 + lod_hysteresis)) {
+        level++;
+    }
+    while(level > 0u && distance < lod_base_distance * exp2(float(level) - 1.0) * (1.0 - lod_hysteresis)) {
+        level--;
+    }
+    lod_levels[index] = level;
+
+    uvec4 draw = records[index].levels[level];
+    if(draw.x == 0u) {
+        return;
+    }
+
+    uint group = draw.w;
+    uint slot = group_first_command[group] + atomicAdd(counts[group], 1u);
+    commands[slot * 5u] = draw.x;
+    commands[slot * 5u + 1u] = 1u;
+    commands[slot * 5u + 2u] = draw.y;
+    commands[slot * 5u + 3u] = draw.z;
+    commands[slot * 5u + 4u] = slot;
+    draw_positions[slot] = vec4(records[index].position.xyz, 0.0);
+}
+)";
+
+    static GLuint compile_compute_program(const std::string& name, const std::string& source) {
+        GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        const char* source_chars = source.c_str();
+        glShaderSource(shader, 1, &source_chars, nullptr);
+        glCompileShader(shader);
+
+        GLint success = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if(success == GL_FALSE) {
+            GLint log_size = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_size);
+            std::vector<GLchar> error_log(static_cast<std::size_t>(log_size) + 1);
+            glGetShaderInfoLog(shader, log_size, nullptr, error_log.data());
+            glDeleteShader(shader);
+
+            LOG(ERROR) << "Error compiling " << name << ":\n" << error_log.data();
+            throw program_linking_failure(name);
+        }
+
+        GLuint program = glCreateProgram();
+        glObjectLabel(GL_PROGRAM, program, static_cast<GLsizei>(name.length()), name.c_str());
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if(success == GL_FALSE) {
+            GLint log_size = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_size);
+            std::vector<GLchar> error_log(static_cast<std::size_t>(log_size) + 1);
+            glGetProgramInfoLog(program, log_size, nullptr, error_log.data());
+            glDeleteProgram(program);
+
+            LOG(ERROR) << "Error linking program " << name << ":\n" << error_log.data();
+            throw program_linking_failure(name);
+        }
+
+        return program;
+    }
+
+    /*!
+     * \brief Makes sure the buffer can hold at least size bytes. Whatever was in it is lost if it has to grow
+     */
+    static void reserve_buffer(GLuint& buffer, std::size_t& capacity, std::size_t size) {
+        if(buffer != 0 && size <= capacity) {
+            return;
+        }
+
+        if(buffer != 0) {
+            glDeleteBuffers(1, &buffer);
+        }
+
+        // Buffers can't be empty, and growing by doubling keeps a slowly growing world from reallocating every frame
+        capacity = std::max(size, std::max(capacity * 2, static_cast<std::size_t>(256)));
+        glCreateBuffers(1, &buffer);
+        glNamedBufferData(buffer, capacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    /*!
+     * \brief Fills in how to draw the given mesh
+     *
+     * \return False if the mesh isn't in the geometry pool, so the culler can't draw it
+     */
+    static bool describe_mesh(const gl_mesh* mesh, const render_object_textures& textures, gpu_draw_level& level) {
+        const geometry_allocation* allocation = mesh == nullptr ? nullptr : mesh->get_allocation();
+        if(allocation == nullptr) {
+            return false;
+        }
+
+        std::size_t index_size = allocation->index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        level.count = allocation->num_indices;
+        level.first_index = static_cast<std::uint32_t>(allocation->index_byte_offset / index_size);
+        level.base_vertex = allocation->base_vertex;
+        level.group = {allocation->vertex_array, allocation->index_type, allocation->vertex_format, textures.color,
+                       textures.normalmap, textures.data};
+        return true;
+    }
+
+    bool gpu_culler::is_supported() {
+        // Compute shaders and storage buffers came in 4.3, and everything else in here uses direct state access. The
+        // draws need their counts from a buffer, which is core in 4.6
+        return GLAD_GL_VERSION_4_5 && (GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_indirect_parameters);
+    }
+
+    gpu_culler::gpu_culler() {
+        reduce_program = compile_compute_program("hi_z_reduce", REDUCE_SHADER_SOURCE);
+        cull_program = compile_compute_program("gpu_cull", "#version 450\n#define MAX_DRAW_LEVELS " +
+                                                           std::to_string(MAX_GPU_DRAW_LEVELS) + "\n" +
+                                                           CULL_SHADER_SOURCE);
+
+        LOG(INFO) << "GPU culling is ready";
+    }
+
+    gpu_culler::~gpu_culler() {
+        batches.clear();
+
+        if(glfwGetCurrentContext() == nullptr) {
+            return;
+        }
+
+        glDeleteProgram(cull_program);
+        glDeleteProgram(reduce_program);
+        glDeleteTextures(1, &depth_texture);
+        glDeleteTextures(1, &hi_z_texture);
+    }
+
+    gpu_culler::draw_batch::~draw_batch() {
+        if(glfwGetCurrentContext() == nullptr) {
+            return;
+        }
+
+        GLuint buffers[] = {records_buffer, groups_buffer, commands_buffer, counts_buffer, positions_buffer,
+                            lod_levels_buffer};
+        glDeleteBuffers(6, buffers);
+    }
+
+    void gpu_culler::resize_hi_z(int width, int height) {
+        glDeleteTextures(1, &depth_texture);
+        glDeleteTextures(1, &hi_z_texture);
+
+        hi_z_width = width;
+        hi_z_height = height;
+        hi_z_levels = 1;
+        while((std::max(width, height) >> hi_z_levels) > 0) {
+            hi_z_levels++;
+        }
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &depth_texture);
+        glTextureStorage2D(depth_texture, 1, GL_DEPTH_COMPONENT24, width, height);
+        glTextureParameteri(depth_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(depth_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &hi_z_texture);
+        glTextureStorage2D(hi_z_texture, hi_z_levels, GL_R32F, width, height);
+        glTextureParameteri(hi_z_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTextureParameteri(hi_z_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        LOG(DEBUG) << "Resized the hierarchical depth buffer to " << width << "x" << height << " with " << hi_z_levels
+                   << " levels";
+    }
+
+    void gpu_culler::capture_depth(const glm::mat4& view_projection) {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        if(viewport[2] <= 0 || viewport[3] <= 0) {
+            has_depth = false;
+            return;
+        }
+
+        if(viewport[2] != hi_z_width || viewport[3] != hi_z_height) {
+            resize_hi_z(viewport[2], viewport[3]);
+        }
+
+        glCopyTextureSubImage2D(depth_texture, 0, 0, 0, viewport[0], viewport[1], hi_z_width, hi_z_height);
+
+        glUseProgram(reduce_program);
+        GLint source_level_location = glGetUniformLocation(reduce_program, "source_level");
+        GLint source_size_location = glGetUniformLocation(reduce_program, "source_size");
+        GLint scale_location = glGetUniformLocation(reduce_program, "scale");
+
+        // Level 0 is a straight copy of the depth buffer, and every level after it halves the one before it
+        for(int level = 0; level < hi_z_levels; level++) {
+            int source_level = std::max(level - 1, 0);
+            int source_width = std::max(hi_z_width >> source_level, 1);
+            int source_height = std::max(hi_z_height >> source_level, 1);
+
+            if(level == 0) {
+                glBindTextureUnit(SOURCE_TEXTURE_UNIT, depth_texture);
+            } else {
+                glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+                glBindTextureUnit(SOURCE_TEXTURE_UNIT, hi_z_texture);
+            }
+
+            glUniform1i(source_level_location, source_level);
+            glUniform2i(source_size_location, source_width, source_height);
+            glUniform1i(scale_location, level == 0 ? 1 : 2);
+            glBindImageTexture(0, hi_z_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            auto width = static_cast<GLuint>(std::max(hi_z_width >> level, 1));
+            auto height = static_cast<GLuint>(std::max(hi_z_height >> level, 1));
+            glDispatchCompute((width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE,
+                              (height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1);
+        }
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glUseProgram(0);
+
+        depth_view_projection = view_projection;
+        has_depth = true;
+    }
+
+    void gpu_culler::prepare(name_id shader_name, render_object_bucket& bucket, std::uint64_t geometry_version) {
+        auto& batch = batches[shader_name];
+        if(!batch) {
+            batch = std::make_unique<draw_batch>();
+        }
+        current_batch = batch.get();
+
+        if(!batch->is_built || batch->bucket_version != bucket.get_version() ||
+           batch->geometry_version != geometry_version) {
+            rebuild(*batch, bucket);
+            batch->bucket_version = bucket.get_version();
+            batch->geometry_version = geometry_version;
+            batch->is_built = true;
+        }
+    }
+
+    bool gpu_culler::select(name_id shader_name) {
+        auto batch_itr = batches.find(shader_name);
+        if(batch_itr == batches.end() || !batch_itr->second->is_built) {
+            return false;
+        }
+
+        current_batch = batch_itr->second.get();
+        return true;
+    }
+
+    void gpu_culler::rebuild(draw_batch& batch, render_object_bucket& bucket) {
+        auto& lod_levels = bucket.get_lod_levels();
+
+        // The render_objects may have moved since the records were built, so the levels go back by handle
+        if(!batch.record_handles.empty()) {
+            std::vector<GLuint> old_levels(batch.record_handles.size());
+            glGetNamedBufferSubData(batch.lod_levels_buffer, 0, old_levels.size() * sizeof(GLuint), old_levels.data());
+
+            for(std::size_t record = 0; record < batch.record_handles.size(); record++) {
+                const auto& handle = batch.record_handles[record];
+                if(bucket.get(handle) != nullptr) {
+                    std::size_t i = bucket.index_of(handle);
+                    auto num_levels = static_cast<GLuint>(bucket.get_lods()[i].num_levels);
+                    lod_levels[i] = static_cast<std::uint8_t>(std::min(old_levels[record], num_levels));
+                }
+            }
+        }
+
+        batch.draws.clear();
+        batch.cpu_objects.clear();
+        batch.record_handles.clear();
+
+        const auto& meshes = bucket.get_meshes();
+        const auto& positions = bucket.get_positions();
+        const auto& bounds = bucket.get_bounds();
+        const auto& textures = bucket.get_textures();
+        const auto& lods = bucket.get_lods();
+
+        std::vector<GLuint> record_lod_levels;
+
+        gpu_draw_level levels[MAX_GPU_DRAW_LEVELS];
+        for(std::size_t i = 0; i < meshes.size(); i++) {
+            const auto& object_lods = lods[i];
+
+            bool is_pooled = describe_mesh(meshes[i], textures[i], levels[0]);
+            for(std::size_t level = 0; level < object_lods.num_levels && is_pooled; level++) {
+                is_pooled = describe_mesh(object_lods.meshes[level], textures[i], levels[level + 1]);
+            }
+
+            if(!is_pooled) {
+                batch.cpu_objects.push_back(i);
+                continue;
+            }
+
+            batch.draws.add(bounds.get(i), positions[i], levels, object_lods.num_levels + 1);
+            batch.record_handles.push_back(bucket.get_handle(i));
+            record_lod_levels.push_back(lod_levels[i]);
+        }
+        batch.draws.finish();
+
+        const auto& records = batch.draws.get_records();
+        const auto& groups = batch.draws.get_groups();
+        std::size_t num_commands = batch.draws.get_num_commands();
+
+        std::vector<GLuint> group_first_commands;
+        group_first_commands.reserve(groups.size());
+        for(const auto& group : groups) {
+            group_first_commands.push_back(group.first_command);
+        }
+
+        reserve_buffer(batch.records_buffer, batch.records_capacity, records.size() * sizeof(gpu_draw_record));
+        reserve_buffer(batch.groups_buffer, batch.groups_capacity, groups.size() * sizeof(GLuint));
+        reserve_buffer(batch.counts_buffer, batch.counts_capacity, groups.size() * sizeof(GLuint));
+        reserve_buffer(batch.commands_buffer, batch.commands_capacity, num_commands * COMMAND_SIZE);
+        reserve_buffer(batch.positions_buffer, batch.positions_capacity, num_commands * DRAW_POSITION_SIZE);
+        reserve_buffer(batch.lod_levels_buffer, batch.lod_levels_capacity, records.size() * sizeof(GLuint));
+
+        glNamedBufferSubData(batch.records_buffer, 0, records.size() * sizeof(gpu_draw_record), records.data());
+        glNamedBufferSubData(batch.groups_buffer, 0, group_first_commands.size() * sizeof(GLuint),
+                             group_first_commands.data());
+        glNamedBufferSubData(batch.lod_levels_buffer, 0, record_lod_levels.size() * sizeof(GLuint),
+                             record_lod_levels.data());
+
+        num_rebuilds++;
+    }
+
+    void gpu_culler::cull(const frustum_planes& planes, const glm::vec3& camera_position, const lod_settings& lods) {
+        if(current_batch == nullptr || current_batch->draws.get_records().empty()) {
+            return;
+        }
+
+        auto& batch = *current_batch;
+        auto num_records = static_cast<GLuint>(batch.draws.get_records().size());
+
+        glClearNamedBufferSubData(batch.counts_buffer, GL_R32UI, 0, batch.draws.get_groups().size() * sizeof(GLuint),
+                                  GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+        glUseProgram(cull_program);
+        glUniform1ui(glGetUniformLocation(cull_program, "num_records"), num_records);
+        glUniform4fv(glGetUniformLocation(cull_program, "frustum"), 6, &planes[0][0]);
+        glUniform3f(glGetUniformLocation(cull_program, "camera_position"), camera_position.x, camera_position.y,
+                    camera_position.z);
+        glUniform1f(glGetUniformLocation(cull_program, "lod_base_distance"), lods.base_distance);
+        glUniform1f(glGetUniformLocation(cull_program, "lod_hysteresis"), lods.hysteresis);
+
+        glUniform1i(glGetUniformLocation(cull_program, "use_hi_z"), has_depth ? 1 : 0);
+        if(has_depth) {
+            glUniformMatrix4fv(glGetUniformLocation(cull_program, "hi_z_view_projection"), 1, GL_FALSE,
+                               &depth_view_projection[0][0]);
+            glUniform2i(glGetUniformLocation(cull_program, "hi_z_size"), hi_z_width, hi_z_height);
+            glUniform1i(glGetUniformLocation(cull_program, "hi_z_levels"), hi_z_levels);
+            glBindTextureUnit(SOURCE_TEXTURE_UNIT, hi_z_texture);
+        }
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, batch.records_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.groups_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch.commands_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, batch.counts_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, batch.positions_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, batch.lod_levels_buffer);
+
+        glDispatchCompute((num_records + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+        // The commands and their counts are read by the draws, and the positions as vertex attributes
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    const std::vector<gpu_draw_group>& gpu_culler::get_groups() const {
+        static const std::vector<gpu_draw_group> no_groups;
+        return current_batch == nullptr ? no_groups : current_batch->draws.get_groups();
+    }
+
+    void gpu_culler::draw_group(std::size_t group_index) {
+        const auto& batch = *current_batch;
+        const auto& group = batch.draws.get_groups()[group_index];
+        if(group.capacity == 0) {
+            return;
+        }
+
+        // The position attribute is only turned on for these draws, so everything else that uses the page's vertex
+        // arrays reads it as zero
+        GLuint vertex_array = group.key.vertex_array;
+        glVertexArrayAttribFormat(vertex_array, DRAW_POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(vertex_array, DRAW_POSITION_ATTRIBUTE, DRAW_POSITION_ATTRIBUTE);
+        glVertexArrayVertexBuffer(vertex_array, DRAW_POSITION_ATTRIBUTE, batch.positions_buffer, 0,
+                                  static_cast<GLsizei>(DRAW_POSITION_SIZE));
+        glVertexArrayBindingDivisor(vertex_array, DRAW_POSITION_ATTRIBUTE, 1);
+        glEnableVertexArrayAttrib(vertex_array, DRAW_POSITION_ATTRIBUTE);
+
+        glBindVertexArray(vertex_array);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.commands_buffer);
+
+        auto* first_command = reinterpret_cast<const void*>(group.first_command * COMMAND_SIZE);
+        auto max_draws = static_cast<GLsizei>(group.capacity);
+        auto stride = static_cast<GLsizei>(COMMAND_SIZE);
+
+        glBindBuffer(GL_PARAMETER_BUFFER, batch.counts_buffer);
+        auto count_offset = static_cast<GLintptr>(group_index * sizeof(GLuint));
+        if(GLAD_GL_VERSION_4_6) {
+            glMultiDrawElementsIndirectCount(GL_TRIANGLES, group.key.index_type, first_command, count_offset,
+                                             max_draws, stride);
+        } else {
+            glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, group.key.index_type, first_command, count_offset,
+                                                max_draws, stride);
+        }
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glDisableVertexArrayAttrib(vertex_array, DRAW_POSITION_ATTRIBUTE);
+    }
+
+    const std::vector<std::size_t>& gpu_culler::get_cpu_objects() const {
+        static const std::vector<std::size_t> no_objects;
+        return current_batch == nullptr ? no_objects : current_batch->cpu_objects;
+    }
+
+    gpu_cull_stats gpu_culler::get_stats() const {
+        gpu_cull_stats stats = {};
+        for(const auto& batch : batches) {
+            stats.num_records += batch.second->draws.get_records().size();
+            stats.num_groups += batch.second->draws.get_groups().size();
+            stats.num_cpu_objects += batch.second->cpu_objects.size();
+        }
+        stats.num_rebuilds = num_rebuilds;
+        return stats;
+    }
+}
@@ -0,0 +1,215 @@
+/*!
+ * \brief Culls render_objects in a compute shader and draws whatever survives with indirect multi-draws
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_GPU_CULLER_H
+#define RENDERER_GPU_CULLER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gpu_draw_list.h"
+#include "render_object_bucket.h"
+
+namespace nova {
+    /*!
+     * \brief What the GPU culler has to work with
+     */
+    struct gpu_cull_stats {
+        /*!
+         * \brief How many render_objects the compute shader tests, over every shader
+         */
+        std::size_t num_records;
+
+        /*!
+         * \brief How many multi-draw calls the surviving render_objects were drawn with
+         */
+        std::size_t num_groups;
+
+        /*!
+         * \brief How many render_objects weren't in the geometry pool, so had to be culled and drawn on the CPU
+         */
+        std::size_t num_cpu_objects;
+
+        /*!
+         * \brief How many times a shader's records have been rebuilt since the culler was made
+         */
+        std::size_t num_rebuilds;
+    };
+
+    /*!
+     * \brief Moves culling and draw submission for pooled geometry onto the GPU
+     *
+     * For each shader, the culler keeps a buffer with one record per render_object: its bounding box, its position,
+     * and where each of its levels of detail is in the geometry pool. The records are only rebuilt when the
+     * render_object_bucket or the geometry pool changes, so on most frames the CPU doesn't look at a single
+     * render_object.
+     *
+     * Every frame, a compute shader tests each record against the frustum, then against a hierarchical depth buffer
+     * built from the last frame's depth. The level of detail for the survivors is picked by distance, and a
+     * DrawElementsIndirectCommand is appended for them to the command range of the draw group that level is in. The
+     * count of commands for each group goes into a parameter buffer, so each group is drawn with one
+     * glMultiDrawElementsIndirectCount call without the CPU ever reading anything back. That needs
+     * ARB_indirect_parameters, which Mesa's llvmpipe has. Contexts without it cull on the CPU instead.
+     *
+     * The section positions that gbufferModel would normally carry go into an instanced vertex attribute instead, at
+     * location 6. Each command's baseInstance points at its own entry. Shaders have to add draw_position_in to their
+     * positions for this path to draw anything in the right place. When the attribute isn't enabled, like on the CPU
+     * path, it reads as zero.
+     *
+     * The depth test runs against the last frame's depth with the last frame's camera, so something that the camera
+     * turns towards can be missing for a frame.
+     *
+     * The compute shader keeps the level of detail it last picked for each record in a buffer, and only switches levels
+     * once the distance is past the hysteresis band that select_lod_level uses. Rebuilding a shader's records copies
+     * those levels back into the render_object_bucket first, so a rebuild doesn't make anything switch. That copy waits
+     * for the last cull to finish, but rebuilds only happen when the world changes.
+     *
+     * Everything here must be called from the render thread
+     */
+    class gpu_culler {
+    public:
+        /*!
+         * \brief The vertex attribute that holds each draw's position
+         */
+        static const GLuint DRAW_POSITION_ATTRIBUTE = 6;
+
+        /*!
+         * \brief Checks if the context has compute shaders, ARB_indirect_parameters, and everything else the culler
+         * needs
+         */
+        static bool is_supported();
+
+        /*!
+         * \brief Compiles the culler's compute shaders
+         *
+         * \throws program_linking_failure if a compute shader doesn't compile or link
+         */
+        gpu_culler();
+
+        ~gpu_culler();
+
+        gpu_culler(const gpu_culler&) = delete;
+        gpu_culler& operator=(const gpu_culler&) = delete;
+
+        /*!
+         * \brief Builds the hierarchical depth buffer from the depth buffer that's currently bound for reading
+         *
+         * Call after drawing the geometry that should hide things, and before anything clears the depth buffer
+         *
+         * \param view_projection The camera that the depth was drawn with
+         */
+        void capture_depth(const glm::mat4& view_projection);
+
+        /*!
+         * \brief Makes the given shader's render_objects the ones that #cull and #draw_group work with, rebuilding
+         * their records if anything changed since they were last built
+         *
+         * \param shader_name The shader that the bucket belongs to
+         * \param bucket The shader's render_objects
+         * \param geometry_version mesh_store::get_geometry_version
+         */
+        void prepare(name_id shader_name, render_object_bucket& bucket, std::uint64_t geometry_version);
+
+        /*!
+         * \brief Makes a shader that's already been through #prepare the one that #cull and #draw_group work with,
+         * without checking whether its records are up to date
+         *
+         * \param shader_name The shader that was prepared
+         * \return False if the shader has never been prepared
+         */
+        bool select(name_id shader_name);
+
+        /*!
+         * \brief Runs the culling compute shader over the prepared render_objects. Leaves no program bound
+         *
+         * \param planes The camera's frustum
+         * \param camera_position Where the camera is, for picking levels of detail
+         * \param lods When render_objects switch to their simplified meshes
+         */
+        void cull(const frustum_planes& planes, const glm::vec3& camera_position, const lod_settings& lods);
+
+        /*!
+         * \brief The draw groups of the prepared render_objects. Each one's textures and vertex format need to be set up
+         * before it's drawn
+         */
+        const std::vector<gpu_draw_group>& get_groups() const;
+
+        /*!
+         * \brief Draws everything in a group that survived the last #cull
+         */
+        void draw_group(std::size_t group);
+
+        /*!
+         * \brief The indices of the prepared render_objects that the culler can't draw, because their geometry isn't
+         * in the pool
+         */
+        const std::vector<std::size_t>& get_cpu_objects() const;
+
+        gpu_cull_stats get_stats() const;
+
+    private:
+        /*!
+         * \brief A shader's records, and the buffers the compute shader reads them from and writes commands to
+         */
+        struct draw_batch {
+            std::uint64_t bucket_version = 0;
+            std::uint64_t geometry_version = 0;
+            bool is_built = false;
+
+            gpu_draw_list draws;
+            std::vector<std::size_t> cpu_objects;
+
+            /*!
+             * \brief The render_object each record is for, so that the levels of detail the GPU picked can be copied
+             * back to the right render_objects
+             */
+            std::vector<slot_handle> record_handles;
+
+            GLuint records_buffer = 0;
+            GLuint groups_buffer = 0;
+            GLuint commands_buffer = 0;
+            GLuint counts_buffer = 0;
+            GLuint positions_buffer = 0;
+            GLuint lod_levels_buffer = 0;
+
+            // In bytes
+            std::size_t records_capacity = 0;
+            std::size_t groups_capacity = 0;
+            std::size_t commands_capacity = 0;
+            std::size_t counts_capacity = 0;
+            std::size_t positions_capacity = 0;
+            std::size_t lod_levels_capacity = 0;
+
+            ~draw_batch();
+        };
+
+        std::unordered_map<name_id, std::unique_ptr<draw_batch>> batches;
+        draw_batch* current_batch = nullptr;
+
+        GLuint cull_program = 0;
+        GLuint reduce_program = 0;
+
+        GLuint depth_texture = 0;
+        GLuint hi_z_texture = 0;
+        int hi_z_width = 0;
+        int hi_z_height = 0;
+        int hi_z_levels = 0;
+        bool has_depth = false;
+        glm::mat4 depth_view_projection;
+
+        std::size_t num_rebuilds = 0;
+
+        void rebuild(draw_batch& batch, render_object_bucket& bucket);
+
+        void resize_hi_z(int width, int height);
+    };
+}
+
+#endif //RENDERER_GPU_CULLER_H
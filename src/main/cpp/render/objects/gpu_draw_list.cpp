@@ -0,0 +1,97 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include "gpu_draw_list.h"
+
+namespace nova {
+    static_assert(sizeof(gpu_draw_record) == 12 * sizeof(float) + MAX_GPU_DRAW_LEVELS * 4 * sizeof(std::uint32_t),
+                  "gpu_draw_record must match the compute shader's layout");
+
+    bool draw_group_key::operator==(const draw_group_key& other) const {
+        return vertex_array == other.vertex_array && index_type == other.index_type &&
+               vertex_format == other.vertex_format && color_texture == other.color_texture &&
+               normalmap == other.normalmap && data_texture == other.data_texture;
+    }
+
+    void gpu_draw_list::clear() {
+        records.clear();
+        groups.clear();
+        num_commands = 0;
+    }
+
+    void gpu_draw_list::add(const aabb& bounds, const glm::vec3& position, const gpu_draw_level* levels,
+                            std::size_t num_levels) {
+        num_levels = std::min(num_levels, MAX_GPU_DRAW_LEVELS);
+
+        gpu_draw_record record = {};
+        record.center_and_num_lods[0] = bounds.center.x;
+        record.center_and_num_lods[1] = bounds.center.y;
+        record.center_and_num_lods[2] = bounds.center.z;
+        record.center_and_num_lods[3] = num_levels > 0 ? static_cast<float>(num_levels - 1) : 0;
+        record.extent[0] = bounds.extents.x;
+        record.extent[1] = bounds.extents.y;
+        record.extent[2] = bounds.extents.z;
+        record.position[0] = position.x;
+        record.position[1] = position.y;
+        record.position[2] = position.z;
+
+        // Only count the render_object once for each group, even if several of its levels are in the group
+        std::uint32_t groups_used[MAX_GPU_DRAW_LEVELS];
+        std::size_t num_groups_used = 0;
+
+        for(std::size_t level = 0; level < num_levels; level++) {
+            const auto& draw = levels[level];
+            if(draw.count == 0) {
+                continue;
+            }
+
+            std::uint32_t group = find_group(draw.group);
+            record.levels[level][0] = draw.count;
+            record.levels[level][1] = draw.first_index;
+            record.levels[level][2] = static_cast<std::uint32_t>(draw.base_vertex);
+            record.levels[level][3] = group;
+
+            auto* groups_end = groups_used + num_groups_used;
+            if(std::find(groups_used, groups_end, group) == groups_end) {
+                groups_used[num_groups_used++] = group;
+                groups[group].capacity++;
+            }
+        }
+
+        records.push_back(record);
+    }
+
+    void gpu_draw_list::finish() {
+        num_commands = 0;
+        for(auto& group : groups) {
+            group.first_command = static_cast<std::uint32_t>(num_commands);
+            num_commands += group.capacity;
+        }
+    }
+
+    const std::vector<gpu_draw_record>& gpu_draw_list::get_records() const {
+        return records;
+    }
+
+    const std::vector<gpu_draw_group>& gpu_draw_list::get_groups() const {
+        return groups;
+    }
+
+    std::size_t gpu_draw_list::get_num_commands() const {
+        return num_commands;
+    }
+
+    std::uint32_t gpu_draw_list::find_group(const draw_group_key& key) {
+        for(std::size_t i = 0; i < groups.size(); i++) {
+            if(groups[i].key == key) {
+                return static_cast<std::uint32_t>(i);
+            }
+        }
+
+        groups.push_back({key, 0, 0});
+        return static_cast<std::uint32_t>(groups.size() - 1);
+    }
+}
@@ -0,0 +1,140 @@
+/*!
+ * \brief Lays out a shader's render_objects the way the GPU culling compute shader reads them
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_GPU_DRAW_LIST_H
+#define RENDERER_GPU_DRAW_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../../data_loading/physics/aabb.h"
+#include "../../geometry_cache/lod_builder.h"
+#include "../../geometry_cache/mesh_definition.h"
+#include "../../utils/name_table.h"
+
+namespace nova {
+    /*!
+     * \brief A render_object's full detail mesh, then each of its simplified meshes
+     */
+    const std::size_t MAX_GPU_DRAW_LEVELS = MAX_CHUNK_LOD_LEVELS + 1;
+
+    /*!
+     * \brief Everything that has to be the same for draws to go in the same multi-draw call
+     */
+    struct draw_group_key {
+        std::uint32_t vertex_array;
+        std::uint32_t index_type;
+        format vertex_format;
+        name_id color_texture;
+        name_id normalmap;
+        name_id data_texture;
+
+        bool operator==(const draw_group_key& other) const;
+    };
+
+    /*!
+     * \brief How to draw one level of detail of a render_object, in the terms of a DrawElementsIndirectCommand
+     */
+    struct gpu_draw_level {
+        std::uint32_t count;
+
+        /*!
+         * \brief The first index to draw, counted in indices of the group's index type rather than in bytes
+         */
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        draw_group_key group;
+    };
+
+    /*!
+     * \brief One render_object, exactly as the compute shader's std430 buffer lays it out
+     */
+    struct gpu_draw_record {
+        /*!
+         * \brief The center of the bounding box. The last element is how many simplified meshes the render_object has
+         */
+        float center_and_num_lods[4];
+        float extent[4];
+
+        /*!
+         * \brief Where the render_object is drawn. Ends up in the vertex shader's draw_position_in attribute
+         */
+        float position[4];
+
+        /*!
+         * \brief For each level: count, first index, base vertex and group. A count of 0 means the level has nothing
+         * to draw
+         */
+        std::uint32_t levels[MAX_GPU_DRAW_LEVELS][4];
+    };
+
+    /*!
+     * \brief The draws that share a draw_group_key, and where their commands go in the command buffer
+     */
+    struct gpu_draw_group {
+        draw_group_key key;
+
+        /*!
+         * \brief The index of the group's first command in the command buffer
+         */
+        std::uint32_t first_command;
+
+        /*!
+         * \brief How many render_objects have a level in the group. No more commands than this are ever written for it
+         */
+        std::uint32_t capacity;
+    };
+
+    /*!
+     * \brief Builds the records and draw groups for a shader's render_objects
+     *
+     * Each render_object can draw at most one level of detail a frame, so a group needs one command slot for each
+     * render_object that has any level in it. The slots for each group are next to each other in the command buffer,
+     * so a group can be drawn with a single multi-draw call no matter which render_objects the compute shader keeps.
+     *
+     * There are only ever a handful of groups, one for each geometry pool page and set of textures, so they're found
+     * with a linear search
+     */
+    class gpu_draw_list {
+    public:
+        void clear();
+
+        /*!
+         * \brief Adds a render_object
+         *
+         * \param bounds The render_object's bounding box in world space
+         * \param position Where the render_object is drawn
+         * \param levels The full detail mesh, then each simplified mesh, coarsest last
+         * \param num_levels How many entries of levels there are. At most MAX_GPU_DRAW_LEVELS
+         */
+        void add(const aabb& bounds, const glm::vec3& position, const gpu_draw_level* levels, std::size_t num_levels);
+
+        /*!
+         * \brief Works out where each group's commands go. Call after adding everything and before reading the groups
+         */
+        void finish();
+
+        const std::vector<gpu_draw_record>& get_records() const;
+
+        const std::vector<gpu_draw_group>& get_groups() const;
+
+        /*!
+         * \brief How many command slots all the groups need together
+         */
+        std::size_t get_num_commands() const;
+
+    private:
+        std::vector<gpu_draw_record> records;
+        std::vector<gpu_draw_group> groups;
+        std::size_t num_commands = 0;
+
+        std::uint32_t find_group(const draw_group_key& key);
+    };
+}
+
+#endif //RENDERER_GPU_DRAW_LIST_H
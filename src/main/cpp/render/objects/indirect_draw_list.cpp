@@ -0,0 +1,83 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include "indirect_draw_list.h"
+
+namespace nova {
+    static_assert(sizeof(draw_elements_indirect_command) == 5 * sizeof(std::uint32_t),
+                  "draw_elements_indirect_command must match DrawElementsIndirectCommand");
+
+    void indirect_draw_list::clear() {
+        pending_draws.clear();
+        groups.clear();
+        commands.clear();
+        positions.clear();
+        last_group = 0;
+    }
+
+    void indirect_draw_list::add(const gpu_draw_level& draw, const glm::vec3& position) {
+        if(draw.count == 0) {
+            return;
+        }
+
+        std::uint32_t group = find_group(draw.group);
+        groups[group].num_commands++;
+        pending_draws.push_back({{draw.count, 1, draw.first_index, draw.base_vertex, 0}, position, group});
+    }
+
+    void indirect_draw_list::finish() {
+        std::uint32_t num_commands = 0;
+        for(auto& group : groups) {
+            group.first_command = num_commands;
+            num_commands += group.num_commands;
+        }
+
+        commands.resize(num_commands);
+        positions.resize(num_commands);
+
+        // Reuses num_commands as each group's write cursor, and puts it back once every draw is in place
+        for(auto& group : groups) {
+            group.num_commands = 0;
+        }
+
+        for(const auto& draw : pending_draws) {
+            auto& group = groups[draw.group];
+            std::uint32_t slot = group.first_command + group.num_commands++;
+
+            commands[slot] = draw.command;
+            commands[slot].base_instance = slot;
+            positions[slot] = glm::vec4(draw.position, 0);
+        }
+    }
+
+    const std::vector<draw_elements_indirect_command>& indirect_draw_list::get_commands() const {
+        return commands;
+    }
+
+    const std::vector<glm::vec4>& indirect_draw_list::get_positions() const {
+        return positions;
+    }
+
+    const std::vector<indirect_draw_group>& indirect_draw_list::get_groups() const {
+        return groups;
+    }
+
+    std::uint32_t indirect_draw_list::find_group(const draw_group_key& key) {
+        if(last_group < groups.size() && groups[last_group].key == key) {
+            return last_group;
+        }
+
+        for(std::size_t i = 0; i < groups.size(); i++) {
+            if(groups[i].key == key) {
+                last_group = static_cast<std::uint32_t>(i);
+                return last_group;
+            }
+        }
+
+        groups.push_back({key, 0, 0});
+        last_group = static_cast<std::uint32_t>(groups.size() - 1);
+        return last_group;
+    }
+}
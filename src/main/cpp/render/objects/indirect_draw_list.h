@@ -0,0 +1,111 @@
+/*!
+ * \brief Gathers the draws the CPU has decided to make into indirect commands, grouped so that each group is one
+ * multi-draw call
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_INDIRECT_DRAW_LIST_H
+#define RENDERER_INDIRECT_DRAW_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gpu_draw_list.h"
+
+namespace nova {
+    /*!
+     * \brief A DrawElementsIndirectCommand, exactly as OpenGL reads it from the indirect buffer
+     */
+    struct draw_elements_indirect_command {
+        std::uint32_t count;
+        std::uint32_t instance_count;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+
+        /*!
+         * \brief Which entry of the position buffer the draw reads its draw_position_in from
+         */
+        std::uint32_t base_instance;
+    };
+
+    /*!
+     * \brief The commands that share a draw_group_key. They're next to each other in the command buffer
+     */
+    struct indirect_draw_group {
+        draw_group_key key;
+        std::uint32_t first_command;
+        std::uint32_t num_commands;
+    };
+
+    /*!
+     * \brief How many draws went out through multi-draw calls in the last frame
+     */
+    struct multi_draw_stats {
+        /*!
+         * \brief How many indirect commands were written
+         */
+        std::size_t num_commands;
+
+        /*!
+         * \brief How many multi-draw calls they were drawn with
+         */
+        std::size_t num_draw_calls;
+    };
+
+    /*!
+     * \brief Builds the command buffer and the position buffer for one multi-draw pass
+     *
+     * Draws can be added in any order. #finish puts the commands of each group next to each other, keeping the order
+     * they were added in within the group, and points each command's base_instance at its own position
+     *
+     * There are only ever a handful of groups, and neighboring render_objects are usually in the same one, so the last
+     * group that was used is checked before searching the rest
+     */
+    class indirect_draw_list {
+    public:
+        void clear();
+
+        /*!
+         * \brief Adds a draw
+         *
+         * \param draw What to draw, and which group it goes in
+         * \param position Where the draw goes. Ends up in the vertex shader's draw_position_in attribute
+         */
+        void add(const gpu_draw_level& draw, const glm::vec3& position);
+
+        /*!
+         * \brief Lays out the commands and positions by group. Call after adding everything and before reading
+         * anything
+         */
+        void finish();
+
+        const std::vector<draw_elements_indirect_command>& get_commands() const;
+
+        /*!
+         * \brief The position of each command, padded to four floats
+         */
+        const std::vector<glm::vec4>& get_positions() const;
+
+        const std::vector<indirect_draw_group>& get_groups() const;
+
+    private:
+        struct pending_draw {
+            draw_elements_indirect_command command;
+            glm::vec3 position;
+            std::uint32_t group;
+        };
+
+        std::vector<pending_draw> pending_draws;
+        std::vector<indirect_draw_group> groups;
+        std::vector<draw_elements_indirect_command> commands;
+        std::vector<glm::vec4> positions;
+        std::uint32_t last_group = 0;
+
+        std::uint32_t find_group(const draw_group_key& key);
+    };
+}
+
+#endif //RENDERER_INDIRECT_DRAW_LIST_H
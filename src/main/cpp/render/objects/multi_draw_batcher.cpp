@@ -0,0 +1,116 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include "multi_draw_batcher.h"
+#include "gl_geometry_pool.h"
+#include "gpu_culler.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    bool multi_draw_batcher::is_supported() {
+        // glMultiDrawElementsIndirect came in 4.3, and baseInstance offsetting instanced attributes in 4.2
+        return GLAD_GL_VERSION_4_3 != 0;
+    }
+
+    multi_draw_batcher::multi_draw_batcher() {
+        glGenBuffers(1, &commands_buffer);
+        glGenBuffers(1, &positions_buffer);
+    }
+
+    multi_draw_batcher::~multi_draw_batcher() {
+        glDeleteBuffers(1, &commands_buffer);
+        glDeleteBuffers(1, &positions_buffer);
+    }
+
+    void multi_draw_batcher::begin() {
+        draws.clear();
+    }
+
+    bool multi_draw_batcher::add(const gl_mesh& mesh, const render_object_textures& textures,
+                                 const glm::vec3& position, const quad_run* runs, std::size_t num_runs) {
+        const geometry_allocation* allocation = mesh.get_allocation();
+        if(allocation == nullptr) {
+            return false;
+        }
+
+        std::size_t index_size = allocation->index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+
+        gpu_draw_level draw = {};
+        draw.count = allocation->num_indices;
+        draw.first_index = static_cast<std::uint32_t>(allocation->index_byte_offset / index_size);
+        draw.base_vertex = allocation->base_vertex;
+        draw.group = {allocation->vertex_array, allocation->index_type, allocation->vertex_format, textures.color,
+                      textures.normalmap, textures.data};
+
+        if(runs == nullptr || allocation->quad_capacity == 0) {
+            draws.add(draw, position);
+            return true;
+        }
+
+        // Like gl_mesh::draw_quads, every quad uses the same six indices, so each run only moves the base vertex
+        std::size_t num_drawn_quads = allocation->num_indices / INDICES_PER_QUAD;
+        for(std::size_t run = 0; run < num_runs; run++) {
+            std::size_t first_quad = std::min<std::size_t>(runs[run].first_quad, num_drawn_quads);
+            std::size_t num_quads = std::min<std::size_t>(runs[run].num_quads, num_drawn_quads - first_quad);
+
+            gpu_draw_level run_draw = draw;
+            run_draw.count = static_cast<std::uint32_t>(num_quads * INDICES_PER_QUAD);
+            run_draw.base_vertex = allocation->base_vertex + static_cast<std::int32_t>(first_quad * VERTICES_PER_QUAD);
+            draws.add(run_draw, position);
+        }
+
+        return true;
+    }
+
+    void multi_draw_batcher::submit() {
+        draws.finish();
+
+        const auto& commands = draws.get_commands();
+        const auto& positions = draws.get_positions();
+        if(commands.empty()) {
+            return;
+        }
+
+        // Orphaning the buffers lets the driver hand out new storage instead of waiting for the last frame's draws
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(draw_elements_indirect_command),
+                     commands.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, positions_buffer);
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec4), positions.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    const std::vector<indirect_draw_group>& multi_draw_batcher::get_groups() const {
+        return draws.get_groups();
+    }
+
+    void multi_draw_batcher::draw_group(std::size_t group_index) {
+        const auto& group = draws.get_groups()[group_index];
+        if(group.num_commands == 0) {
+            return;
+        }
+
+        // Like with the GPU culler, the position attribute is only turned on for these draws
+        const GLuint attribute = gpu_culler::DRAW_POSITION_ATTRIBUTE;
+        glBindVertexArray(group.key.vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, positions_buffer);
+        glVertexAttribPointer(attribute, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), nullptr);
+        glVertexAttribDivisor(attribute, 1);
+        glEnableVertexAttribArray(attribute);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_buffer);
+        auto* first_command = reinterpret_cast<const void*>(group.first_command *
+                                                            sizeof(draw_elements_indirect_command));
+        glMultiDrawElementsIndirect(GL_TRIANGLES, group.key.index_type, first_command,
+                                    static_cast<GLsizei>(group.num_commands), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glDisableVertexAttribArray(attribute);
+    }
+}
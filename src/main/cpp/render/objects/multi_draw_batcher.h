@@ -0,0 +1,88 @@
+/*!
+ * \brief Draws the render_objects that the CPU has culled with one multi-draw call per draw group
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_MULTI_DRAW_BATCHER_H
+#define RENDERER_MULTI_DRAW_BATCHER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "indirect_draw_list.h"
+#include "render_object_bucket.h"
+
+namespace nova {
+    /*!
+     * \brief Turns a shader's visible render_objects into indirect commands, then draws each group of them with a
+     * single glMultiDrawElementsIndirect
+     *
+     * Drawing render_objects one at a time costs a vertex array bind, a model matrix upload and a draw call each, and
+     * at high render distances that's where most of the CPU's frame goes. Everything in the geometry pool that shares
+     * a page and a set of textures can be drawn together instead, since the only thing that's different between them
+     * is where they go. The positions go into a buffer that's read as the instanced draw_position_in attribute, the
+     * same way the GPU culler does it, and each command's baseInstance points at its own position.
+     *
+     * The commands and positions are streamed into fresh buffers every time the batch is drawn. Render_objects that
+     * aren't in the geometry pool can't be batched, and have to be drawn the usual way.
+     *
+     * Everything here must be called from the render thread
+     */
+    class multi_draw_batcher {
+    public:
+        /*!
+         * \brief Checks if the context has indirect multi-draws and instanced attributes that start at baseInstance
+         */
+        static bool is_supported();
+
+        multi_draw_batcher();
+
+        ~multi_draw_batcher();
+
+        multi_draw_batcher(const multi_draw_batcher&) = delete;
+        multi_draw_batcher& operator=(const multi_draw_batcher&) = delete;
+
+        /*!
+         * \brief Throws away the draws of the last batch
+         */
+        void begin();
+
+        /*!
+         * \brief Adds a mesh to the batch
+         *
+         * \param mesh The mesh to draw
+         * \param textures The textures the mesh is drawn with
+         * \param position Where the mesh goes
+         * \param runs The runs of quads to draw, or nullptr to draw the whole mesh
+         * \param num_runs How many runs there are
+         * \return False if the mesh isn't in the geometry pool, so it has to be drawn on its own
+         */
+        bool add(const gl_mesh& mesh, const render_object_textures& textures, const glm::vec3& position,
+                 const quad_run* runs = nullptr, std::size_t num_runs = 0);
+
+        /*!
+         * \brief Uploads the batch's commands and positions. Call after adding everything and before drawing
+         */
+        void submit();
+
+        /*!
+         * \brief The groups of the submitted batch. Each one's textures and vertex format need to be set up before it's
+         * drawn
+         */
+        const std::vector<indirect_draw_group>& get_groups() const;
+
+        /*!
+         * \brief Draws one group of the submitted batch
+         */
+        void draw_group(std::size_t group);
+
+    private:
+        indirect_draw_list draws;
+
+        GLuint commands_buffer = 0;
+        GLuint positions_buffer = 0;
+    };
+}
+
+#endif //RENDERER_MULTI_DRAW_BATCHER_H
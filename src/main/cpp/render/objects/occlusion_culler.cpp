@@ -0,0 +1,329 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "occlusion_culler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace nova {
+    /*!
+     * \brief Points closer to the camera than this, in clip space w, aren't projected. Occluders that reach this close
+     * are skipped and boxes that reach this close are always visible
+     */
+    static const float MIN_PROJECTED_W = 0.05f;
+
+    /*!
+     * \brief How much nearer than a box an occluder has to be to hide it, as a fraction of the box's depth. Keeps a
+     * section's own occluders from hiding it when rounding puts them a hair in front of its bounding box
+     */
+    static const float DEPTH_BIAS = 1.0f / 1024;
+
+    occlusion_culler::occlusion_culler(int width, int height, std::size_t num_workers) :
+            width((std::max(width, 4) + 3) & ~3), height(std::max(height, 1)),
+            workers(std::max<std::size_t>(num_workers, 1)) {
+        depth_buffer.resize(static_cast<std::size_t>(this->width) * this->height, 0.0f);
+    }
+
+    void occlusion_culler::begin_frame(const glm::mat4& view_projection) {
+        this->view_projection = view_projection;
+        std::fill(depth_buffer.begin(), depth_buffer.end(), 0.0f);
+        quads.clear();
+        num_occluders = 0;
+    }
+
+    bool occlusion_culler::project(const glm::vec3& point, glm::vec3& screen) const {
+        const auto& m = view_projection;
+        float clip_x = m[0][0] * point.x + m[1][0] * point.y + m[2][0] * point.z + m[3][0];
+        float clip_y = m[0][1] * point.x + m[1][1] * point.y + m[2][1] * point.z + m[3][1];
+        float clip_w = m[0][3] * point.x + m[1][3] * point.y + m[2][3] * point.z + m[3][3];
+        if(clip_w < MIN_PROJECTED_W) {
+            return false;
+        }
+
+        float inv_w = 1.0f / clip_w;
+        screen.x = (clip_x * inv_w * 0.5f + 0.5f) * width;
+        screen.y = (clip_y * inv_w * 0.5f + 0.5f) * height;
+        screen.z = inv_w;
+        return true;
+    }
+
+    void occlusion_culler::add_occluder(const aabb& rect) {
+        num_occluders++;
+
+        // The occluder is flat along whichever axis it has no extent on
+        int flat_axis = 0;
+        for(int axis = 1; axis < 3; axis++) {
+            if(rect.extents[axis] < rect.extents[flat_axis]) {
+                flat_axis = axis;
+            }
+        }
+        int u_axis = (flat_axis + 1) % 3;
+
+        glm::vec3 min = rect.get_min();
+        glm::vec3 max = rect.get_max();
+        glm::vec3 corners[4] = {min, min, max, max};
+        corners[1][u_axis] = max[u_axis];
+        corners[3][u_axis] = min[u_axis];
+        for(auto& corner : corners) {
+            corner[flat_axis] = rect.center[flat_axis];
+        }
+
+        glm::vec3 screen[4];
+        float farthest = 0;
+        for(int i = 0; i < 4; i++) {
+            if(!project(corners[i], screen[i])) {
+                return;
+            }
+            farthest = i == 0 ? screen[i].z : std::min(farthest, screen[i].z);
+        }
+
+        // Twice the signed area. The edge functions below expect counterclockwise corners
+        float area = 0;
+        for(int i = 0; i < 4; i++) {
+            const auto& a = screen[i];
+            const auto& b = screen[(i + 1) % 4];
+            area += a.x * b.y - b.x * a.y;
+        }
+        if(std::abs(area) < 1.0f) {
+            // Seen edge-on or too small to fill a whole pixel
+            return;
+        }
+        if(area < 0) {
+            std::swap(screen[1], screen[3]);
+        }
+
+        screen_quad quad;
+        float min_x = screen[0].x, max_x = screen[0].x, min_y = screen[0].y, max_y = screen[0].y;
+        for(int i = 0; i < 4; i++) {
+            const auto& a = screen[i];
+            const auto& b = screen[(i + 1) % 4];
+            quad.edge_x[i] = a.y - b.y;
+            quad.edge_y[i] = b.x - a.x;
+
+            // Pushed in by half a pixel's reach, so only pixels that are entirely inside the edge pass
+            float reach = 0.5f * (std::abs(quad.edge_x[i]) + std::abs(quad.edge_y[i]));
+            quad.edge_offset[i] = (b.y - a.y) * a.x - (b.x - a.x) * a.y - reach;
+
+            min_x = std::min(min_x, a.x);
+            max_x = std::max(max_x, a.x);
+            min_y = std::min(min_y, a.y);
+            max_y = std::max(max_y, a.y);
+        }
+
+        quad.min_x = std::max(0, static_cast<int>(std::floor(min_x)));
+        quad.min_y = std::max(0, static_cast<int>(std::floor(min_y)));
+        quad.max_x = std::min(width, static_cast<int>(std::ceil(max_x)));
+        quad.max_y = std::min(height, static_cast<int>(std::ceil(max_y)));
+        quad.depth = farthest;
+
+        if(quad.min_x < quad.max_x && quad.min_y < quad.max_y) {
+            quads.push_back(quad);
+        }
+    }
+
+    void occlusion_culler::rasterize() {
+        if(quads.empty()) {
+            return;
+        }
+
+        // Each worker gets its own band of rows, so they never write the same pixel
+        int num_bands = static_cast<int>(workers.get_num_workers());
+        int band_height = (height + num_bands - 1) / num_bands;
+        for(int band = 0; band < num_bands; band++) {
+            int first_row = band * band_height;
+            int end_row = std::min(height, first_row + band_height);
+            if(first_row < end_row) {
+                workers.submit(static_cast<std::size_t>(band), [=]() { rasterize_rows(first_row, end_row); });
+            }
+        }
+        workers.wait_idle();
+    }
+
+    void occlusion_culler::rasterize_rows(int first_row, int end_row) {
+        for(const auto& quad : quads) {
+            int row_begin = std::max(quad.min_y, first_row);
+            int row_end = std::min(quad.max_y, end_row);
+
+            for(int y = row_begin; y < row_end; y++) {
+                float* row = &depth_buffer[static_cast<std::size_t>(y) * width];
+                float center_y = y + 0.5f;
+                int x = quad.min_x & ~3;
+
+#ifdef NOVA_HAS_SSE2
+                const __m128 lane_offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 quad_depth = _mm_set1_ps(quad.depth);
+
+                __m128 edges[4];
+                __m128 edge_steps[4];
+                for(int i = 0; i < 4; i++) {
+                    __m128 edge_x = _mm_set1_ps(quad.edge_x[i]);
+                    __m128 center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_offsets);
+                    edges[i] = _mm_add_ps(_mm_mul_ps(edge_x, center_x),
+                                          _mm_set1_ps(quad.edge_y[i] * center_y + quad.edge_offset[i]));
+                    edge_steps[i] = _mm_mul_ps(edge_x, _mm_set1_ps(4.0f));
+                }
+
+                for(; x < quad.max_x; x += 4) {
+                    __m128 covered = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edges[0], zero), _mm_cmpge_ps(edges[1], zero)),
+                                                _mm_and_ps(_mm_cmpge_ps(edges[2], zero), _mm_cmpge_ps(edges[3], zero)));
+                    if(_mm_movemask_ps(covered) != 0) {
+                        __m128 depth = _mm_loadu_ps(row + x);
+                        __m128 nearer = _mm_max_ps(depth, quad_depth);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(covered, nearer), _mm_andnot_ps(covered, depth)));
+                    }
+
+                    for(int i = 0; i < 4; i++) {
+                        edges[i] = _mm_add_ps(edges[i], edge_steps[i]);
+                    }
+                }
+#endif
+
+                for(; x < quad.max_x; x++) {
+                    float center_x = x + 0.5f;
+                    bool covered = true;
+                    for(int i = 0; i < 4; i++) {
+                        covered &= quad.edge_x[i] * center_x + (quad.edge_y[i] * center_y + quad.edge_offset[i]) >= 0;
+                    }
+                    if(covered) {
+                        row[x] = std::max(row[x], quad.depth);
+                    }
+                }
+            }
+        }
+    }
+
+    bool occlusion_culler::is_box_visible(const aabb& box) const {
+        glm::vec3 min = box.get_min();
+        glm::vec3 max = box.get_max();
+
+        float min_x = 0, max_x = 0, min_y = 0, max_y = 0, nearest = 0;
+        for(int corner = 0; corner < 8; corner++) {
+            glm::vec3 point((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+            glm::vec3 screen;
+            if(!project(point, screen)) {
+                return true;
+            }
+
+            if(corner == 0) {
+                min_x = max_x = screen.x;
+                min_y = max_y = screen.y;
+                nearest = screen.z;
+            } else {
+                min_x = std::min(min_x, screen.x);
+                max_x = std::max(max_x, screen.x);
+                min_y = std::min(min_y, screen.y);
+                max_y = std::max(max_y, screen.y);
+                nearest = std::max(nearest, screen.z);
+            }
+        }
+
+        int first_x = std::max(0, static_cast<int>(std::floor(min_x)));
+        int first_y = std::max(0, static_cast<int>(std::floor(min_y)));
+        int end_x = std::min(width, static_cast<int>(std::ceil(max_x)));
+        int end_y = std::min(height, static_cast<int>(std::ceil(max_y)));
+        if(first_x >= end_x || first_y >= end_y) {
+            // Off the screen entirely, which is for the frustum test to decide
+            return true;
+        }
+
+        // Any pixel where nothing is clearly in front of the box means the box might be seen through it
+        float threshold = nearest * (1 + DEPTH_BIAS);
+        for(int y = first_y; y < end_y; y++) {
+            const float* row = &depth_buffer[static_cast<std::size_t>(y) * width];
+            int x = first_x & ~3;
+
+#ifdef NOVA_HAS_SSE2
+            const __m128 lanes = _mm_set_ps(3, 2, 1, 0);
+            const __m128 first = _mm_set1_ps(static_cast<float>(first_x));
+            const __m128 end = _mm_set1_ps(static_cast<float>(end_x));
+            const __m128 depth_threshold = _mm_set1_ps(threshold);
+            for(; x < end_x; x += 4) {
+                __m128 pixel_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes);
+                __m128 in_box = _mm_and_ps(_mm_cmpge_ps(pixel_x, first), _mm_cmplt_ps(pixel_x, end));
+                __m128 not_hidden = _mm_cmple_ps(_mm_loadu_ps(row + x), depth_threshold);
+                if(_mm_movemask_ps(_mm_and_ps(in_box, not_hidden)) != 0) {
+                    return true;
+                }
+            }
+#endif
+
+            for(x = std::max(x, first_x); x < end_x; x++) {
+                if(row[x] <= threshold) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void occlusion_culler::cull(const aabb_soa& boxes, std::vector<std::uint8_t>& visible,
+                                occlusion_cull_stats& stats) {
+        std::vector<std::size_t> to_test;
+        for(std::size_t i = 0; i < visible.size(); i++) {
+            if(visible[i] != 0) {
+                to_test.push_back(i);
+            }
+        }
+        stats.num_tested += to_test.size();
+
+        if(quads.empty() || to_test.empty()) {
+            return;
+        }
+
+        // Each worker tests its own share of the boxes. They write different entries of visible, so there's no need
+        // to lock anything
+        std::size_t num_shares = workers.get_num_workers();
+        std::size_t share_size = (to_test.size() + num_shares - 1) / num_shares;
+        std::vector<std::size_t> num_occluded(num_shares, 0);
+        for(std::size_t share = 0; share < num_shares; share++) {
+            std::size_t first = share * share_size;
+            std::size_t end = std::min(to_test.size(), first + share_size);
+            if(first >= end) {
+                break;
+            }
+
+            workers.submit(share, [&, share, first, end]() {
+                for(std::size_t i = first; i < end; i++) {
+                    std::size_t box = to_test[i];
+                    if(!is_box_visible(boxes.get(box))) {
+                        visible[box] = 0;
+                        num_occluded[share]++;
+                    }
+                }
+            });
+        }
+        workers.wait_idle();
+
+        for(auto count : num_occluded) {
+            stats.num_occluded += count;
+        }
+    }
+
+    occlusion_cull_stats occlusion_culler::get_occluder_stats() const {
+        occlusion_cull_stats stats = {};
+        stats.num_occluders = num_occluders;
+        stats.num_occluders_drawn = quads.size();
+        return stats;
+    }
+
+    int occlusion_culler::get_width() const {
+        return width;
+    }
+
+    int occlusion_culler::get_height() const {
+        return height;
+    }
+
+    float occlusion_culler::get_depth(int x, int y) const {
+        return depth_buffer[static_cast<std::size_t>(y) * width + x];
+    }
+}
@@ -0,0 +1,144 @@
+/*!
+ * \brief Hides chunk sections that are behind other chunk sections, without asking the GPU
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_OCCLUSION_CULLER_H
+#define RENDERER_OCCLUSION_CULLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "frustum_culling.h"
+#include "../../utils/worker_pool.h"
+
+namespace nova {
+    /*!
+     * \brief How much work occlusion culling did in one frame
+     */
+    struct occlusion_cull_stats {
+        std::size_t num_occluders;
+
+        /*!
+         * \brief How many occluders were in front of the camera and big enough on screen to be drawn
+         */
+        std::size_t num_occluders_drawn;
+
+        std::size_t num_tested;
+        std::size_t num_occluded;
+    };
+
+    /*!
+     * \brief A software occlusion culler
+     *
+     * Each frame, the occluders near the camera are drawn into a small depth buffer on the CPU, then bounding boxes
+     * are tested against that depth buffer. A box is culled if every pixel it covers has an occluder in front of it.
+     *
+     * Both steps are conservative. An occluder only fills the pixels it covers completely, and it fills them with the
+     * depth of its farthest corner. A box is tested against every pixel it touches at all, using the depth of its
+     * nearest corner. Boxes that reach behind the camera are never culled. So the culler can miss things that are
+     * hidden, but it never hides things that aren't.
+     *
+     * Depths are stored as 1/w, which is what perspective projection makes linear across the screen, so bigger is
+     * nearer and an empty pixel is 0. Rows of pixels are filled and tested four at a time with SSE2 where it's
+     * available. Both steps are split across a few worker threads of the culler's own, and the calling thread waits for
+     * them, so nothing waits on the GPU
+     */
+    class occlusion_culler {
+    public:
+        /*!
+         * \param width How many pixels wide the depth buffer is. Rounded up to a multiple of four
+         * \param height How many pixels tall the depth buffer is
+         * \param num_workers How many threads to draw and test with
+         */
+        occlusion_culler(int width, int height, std::size_t num_workers);
+
+        /*!
+         * \brief Clears the depth buffer and the occluders
+         *
+         * \param view_projection Transforms world space positions into clip space
+         */
+        void begin_frame(const glm::mat4& view_projection);
+
+        /*!
+         * \brief Adds an occluder for this frame
+         *
+         * \param rect A rectangle in world space, as a box that has no thickness along one axis
+         */
+        void add_occluder(const aabb& rect);
+
+        /*!
+         * \brief Draws all the occluders that have been added since begin_frame into the depth buffer
+         */
+        void rasterize();
+
+        /*!
+         * \brief Culls the boxes that are hidden behind the occluders
+         *
+         * \param boxes The boxes to test, in world space
+         * \param visible One entry per box. Only boxes whose entry isn't 0 are tested, and hidden ones are set to 0
+         * \param stats How many boxes were tested and culled are added to this
+         */
+        void cull(const aabb_soa& boxes, std::vector<std::uint8_t>& visible, occlusion_cull_stats& stats);
+
+        /*!
+         * \brief Returns how many occluders the current frame has and how many of them were drawn
+         */
+        occlusion_cull_stats get_occluder_stats() const;
+
+        int get_width() const;
+
+        int get_height() const;
+
+        /*!
+         * \brief Returns the depth buffer's value at the given pixel, as 1/w. 0 means nothing was drawn there
+         */
+        float get_depth(int x, int y) const;
+
+        /*!
+         * \brief Checks one box against the depth buffer
+         */
+        bool is_box_visible(const aabb& box) const;
+
+    private:
+        /*!
+         * \brief An occluder that's been projected onto the screen
+         *
+         * Each edge is an edge function that's at least 0 at the center of every pixel that's entirely on the inside
+         * of that edge
+         */
+        struct screen_quad {
+            float edge_x[4];
+            float edge_y[4];
+            float edge_offset[4];
+            float depth;
+            int min_x, min_y, max_x, max_y;
+        };
+
+        int width;
+        int height;
+        glm::mat4 view_projection;
+
+        std::vector<float> depth_buffer;
+        std::vector<screen_quad> quads;
+        std::size_t num_occluders = 0;
+
+        worker_pool workers;
+
+        /*!
+         * \brief Transforms a world space point onto the screen. Returns false if it's too close to or behind the
+         * camera
+         *
+         * \param point The point in world space
+         * \param screen Gets the pixel position in x and y, and 1/w in z
+         */
+        bool project(const glm::vec3& point, glm::vec3& screen) const;
+
+        void rasterize_rows(int first_row, int end_row);
+    };
+}
+
+#endif //RENDERER_OCCLUSION_CULLER_H
@@ -0,0 +1,158 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cmath>
+#include "region_grid.h"
+
+namespace nova {
+    void region_grid::insert(std::size_t index, const aabb& box) {
+        locations.resize(index + 1);
+        add_to_region(index, box);
+    }
+
+    void region_grid::update(std::size_t index, const aabb& box) {
+        auto& location = locations[index];
+        auto& cur_region = regions[location.region];
+        if(cur_region.key != get_region_key(box)) {
+            remove_from_region(index);
+            add_to_region(index, box);
+            return;
+        }
+
+        // The box might have shrunk, and a region's box can only be shrunk by looking at all its members
+        cur_region.bounds_need_refresh = true;
+    }
+
+    void region_grid::swap_remove(std::size_t index) {
+        remove_from_region(index);
+
+        std::size_t last_index = locations.size() - 1;
+        if(index != last_index) {
+            locations[index] = locations[last_index];
+            regions[locations[index].region].members[locations[index].member] = index;
+        }
+        locations.pop_back();
+    }
+
+    void region_grid::cull(const frustum_planes& planes, const aabb_soa& boxes, std::vector<std::uint8_t>& visible,
+                           frustum_cull_stats& stats) {
+        for(std::size_t i = 0; i < regions.size(); i++) {
+            if(regions[i].bounds_need_refresh) {
+                refresh_region_bounds(i, boxes);
+            }
+        }
+
+        visible.assign(boxes.size(), OUTSIDE_FRUSTUM);
+
+        frustum_cull_stats region_stats = {};
+        cull_aabbs_against_frustum(planes, region_bounds, region_visibility, region_stats);
+        stats.num_tested += region_stats.num_tested;
+
+        boxes_to_test.clear();
+        bounds_to_test.clear();
+        for(std::size_t i = 0; i < regions.size(); i++) {
+            const auto& members = regions[i].members;
+            switch(region_visibility[i]) {
+                case OUTSIDE_FRUSTUM:
+                    stats.num_rejected += members.size();
+                    stats.num_rejected_by_region += members.size();
+                    break;
+
+                case INSIDE_FRUSTUM:
+                    for(auto member : members) {
+                        visible[member] = INSIDE_FRUSTUM;
+                    }
+                    break;
+
+                default:
+                    for(auto member : members) {
+                        boxes_to_test.push_back(member);
+                        bounds_to_test.push_back(boxes.get(member));
+                    }
+                    break;
+            }
+        }
+
+        cull_aabbs_against_frustum(planes, bounds_to_test, tested_visibility, stats);
+        for(std::size_t i = 0; i < boxes_to_test.size(); i++) {
+            visible[boxes_to_test[i]] = tested_visibility[i];
+        }
+    }
+
+    std::size_t region_grid::get_num_regions() const {
+        return regions.size();
+    }
+
+    std::int64_t region_grid::get_region_key(const aabb& box) {
+        auto x = static_cast<std::int32_t>(std::floor(box.center.x / REGION_SIZE));
+        auto z = static_cast<std::int32_t>(std::floor(box.center.z / REGION_SIZE));
+        return (static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(z);
+    }
+
+    void region_grid::add_to_region(std::size_t index, const aabb& box) {
+        auto key = get_region_key(box);
+
+        std::size_t region_index;
+        auto existing = region_indices.find(key);
+        if(existing == region_indices.end()) {
+            region_index = regions.size();
+            regions.push_back({key, {}, false});
+            region_bounds.push_back(box);
+            region_indices[key] = region_index;
+
+        } else {
+            region_index = existing->second;
+            if(!regions[region_index].bounds_need_refresh) {
+                auto bounds = region_bounds.get(region_index);
+                bounds.expand_to_include(box);
+                region_bounds.set(region_index, bounds);
+            }
+        }
+
+        auto& members = regions[region_index].members;
+        locations[index] = {region_index, members.size()};
+        members.push_back(index);
+    }
+
+    void region_grid::remove_from_region(std::size_t index) {
+        auto location = locations[index];
+        auto& members = regions[location.region].members;
+
+        std::size_t moved = members.back();
+        members[location.member] = moved;
+        locations[moved].member = location.member;
+        members.pop_back();
+
+        if(!members.empty()) {
+            regions[location.region].bounds_need_refresh = true;
+            return;
+        }
+
+        // Nothing's left in the region, so it goes away. The last region takes its place
+        std::size_t last_region = regions.size() - 1;
+        region_indices.erase(regions[location.region].key);
+        if(location.region != last_region) {
+            regions[location.region] = std::move(regions[last_region]);
+            region_indices[regions[location.region].key] = location.region;
+            for(auto member : regions[location.region].members) {
+                locations[member].region = location.region;
+            }
+        }
+        regions.pop_back();
+        region_bounds.swap_remove(location.region);
+    }
+
+    void region_grid::refresh_region_bounds(std::size_t region_index, const aabb_soa& boxes) {
+        auto& cur_region = regions[region_index];
+
+        auto bounds = boxes.get(cur_region.members[0]);
+        for(std::size_t i = 1; i < cur_region.members.size(); i++) {
+            bounds.expand_to_include(boxes.get(cur_region.members[i]));
+        }
+
+        region_bounds.set(region_index, bounds);
+        cur_region.bounds_need_refresh = false;
+    }
+}
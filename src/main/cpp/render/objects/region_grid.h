@@ -0,0 +1,113 @@
+/*!
+ * \brief Groups render_objects into regions of nearby chunks so that culling can reject a whole region at once
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_REGION_GRID_H
+#define RENDERER_REGION_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "frustum_culling.h"
+
+namespace nova {
+    /*!
+     * \brief A loose grid over a set of bounding boxes, for culling them against any frustum
+     *
+     * The grid is made of columns that are REGION_SIZE blocks wide on x and z and reach all the way up and down. Each
+     * box goes into the column its center is in. Boxes that stick out of their column are fine, since a region's
+     * bounding box is the union of its members' boxes rather than the column itself. Only columns that have something in
+     * them exist.
+     *
+     * Boxes are referred to by their index in the caller's arrays, and removing one moves the last one into its place,
+     * the same way render_object_bucket does it.
+     *
+     * Culling tests the regions' boxes first. A region that's outside the frustum has all its members culled without
+     * testing them, and a region that's entirely inside has all its members drawn without testing them. Only the
+     * members of regions that cross the frustum's edge are tested one by one
+     */
+    class region_grid {
+    public:
+        /*!
+         * \brief How wide a region is, in blocks. This is 8x8 chunks
+         */
+        static const int REGION_SIZE = 128;
+
+        /*!
+         * \brief Adds a box. Its index has to be the number of boxes already in the grid
+         */
+        void insert(std::size_t index, const aabb& box);
+
+        /*!
+         * \brief Tells the grid that a box has changed, which might move it into a different region
+         */
+        void update(std::size_t index, const aabb& box);
+
+        /*!
+         * \brief Removes the box at the given index, then moves the last box into its place
+         */
+        void swap_remove(std::size_t index);
+
+        /*!
+         * \brief Finds which boxes might be visible from a frustum
+         *
+         * Doesn't change which boxes are in the grid, so any number of frusta can be tested, one after another
+         *
+         * \param planes The frustum to test against
+         * \param boxes The boxes that were put into the grid, in the same order
+         * \param visible Resized to the number of boxes. Each one is 0 if the box is culled and nonzero if it might be
+         * visible
+         * \param stats How many boxes and regions were tested and how many boxes were rejected are added to this
+         */
+        void cull(const frustum_planes& planes, const aabb_soa& boxes, std::vector<std::uint8_t>& visible,
+                  frustum_cull_stats& stats);
+
+        std::size_t get_num_regions() const;
+
+    private:
+        struct region {
+            std::int64_t key;
+            std::vector<std::size_t> members;
+
+            /*!
+             * \brief Set when a member shrinks or leaves, since the region's box can't be shrunk without looking at
+             * every member again. Such regions are fixed up at the start of the next cull
+             */
+            bool bounds_need_refresh;
+        };
+
+        /*!
+         * \brief Where a box is in the grid
+         */
+        struct box_location {
+            std::size_t region;
+            std::size_t member;
+        };
+
+        std::vector<region> regions;
+        aabb_soa region_bounds;
+        std::unordered_map<std::int64_t, std::size_t> region_indices;
+
+        std::vector<box_location> locations;
+
+        // Scratch space for cull, kept around so it isn't reallocated every frame
+        std::vector<std::uint8_t> region_visibility;
+        std::vector<std::size_t> boxes_to_test;
+        aabb_soa bounds_to_test;
+        std::vector<std::uint8_t> tested_visibility;
+
+        static std::int64_t get_region_key(const aabb& box);
+
+        void add_to_region(std::size_t index, const aabb& box);
+
+        void remove_from_region(std::size_t index);
+
+        void refresh_region_bounds(std::size_t region_index, const aabb_soa& boxes);
+    };
+}
+
+#endif //RENDERER_REGION_GRID_H
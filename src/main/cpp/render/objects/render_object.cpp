@@ -8,16 +8,22 @@ namespace nova {
     render_object::render_object(render_object &&other) noexcept {
         parent_id = other.parent_id;
         type = other.type;
+        name = std::move(other.name);
         geometry = std::move(other.geometry);
+        lod_geometry = std::move(other.lod_geometry);
         color_texture = std::move(other.color_texture);
         normalmap = std::move(other.normalmap);
         data_texture = std::move(other.data_texture);
         bounding_box = std::move(other.bounding_box);
-        needs_deletion=std::move(other.needs_deletion);
+        occluders = std::move(other.occluders);
+        facing_ranges = other.facing_ranges;
         position = other.position;
 
         other.parent_id = 0;
         other.geometry.reset();
+        other.lod_geometry.clear();
+        other.occluders.clear();
+        other.facing_ranges = {};
         other.normalmap = std::experimental::optional<std::string>();
         other.data_texture = std::experimental::optional<std::string>();
         other.position = {0, 0, 0};
@@ -26,16 +32,22 @@ namespace nova {
     render_object &render_object::operator=(render_object && other) noexcept {
         parent_id = other.parent_id;
         type = other.type;
+        name = std::move(other.name);
         geometry = std::move(other.geometry);
+        lod_geometry = std::move(other.lod_geometry);
         color_texture = std::move(other.color_texture);
         normalmap = std::move(other.normalmap);
         data_texture = std::move(other.data_texture);
         bounding_box = std::move(other.bounding_box);
+        occluders = std::move(other.occluders);
+        facing_ranges = other.facing_ranges;
         position = other.position;
-        needs_deletion=std::move(other.needs_deletion);
 
         other.parent_id = 0;
         other.geometry.reset();
+        other.lod_geometry.clear();
+        other.occluders.clear();
+        other.facing_ranges = {};
         other.normalmap = std::experimental::optional<std::string>();
         other.data_texture = std::experimental::optional<std::string>();
         other.position = {0, 0, 0};
@@ -10,9 +10,11 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include <optional.hpp>
 
 #include "gl_mesh.h"
+#include "../../geometry_cache/quad_facing.h"
 #include "../../utils/smart_enum.h"
 #include "textures/texture_manager.h"
 
@@ -72,6 +74,12 @@ namespace nova {
 
         std::unique_ptr<gl_mesh> geometry;
 
+        /*!
+         * \brief Simplified versions of the geometry for drawing from far away, coarsest last. Most render_objects don't
+         * have any
+         */
+        std::vector<std::unique_ptr<gl_mesh>> lod_geometry;
+
         std::string color_texture;
         std::experimental::optional<std::string> normalmap;
         std::experimental::optional<std::string> data_texture;
@@ -80,7 +88,17 @@ namespace nova {
 
         aabb bounding_box;
 
-        bool needs_deletion;
+        /*!
+         * \brief Rectangles of this render_object's geometry that hide whatever is behind them, in world space. Only
+         * chunk sections have any
+         */
+        std::vector<aabb> occluders;
+
+        /*!
+         * \brief Where the quads facing each way are in the full detail geometry, if they've been sorted by facing.
+         * Only chunk sections are sorted
+         */
+        quad_facing_ranges facing_ranges = {};
 
         render_object() = default;
         render_object(render_object&& other) noexcept;
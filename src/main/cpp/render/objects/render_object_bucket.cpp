@@ -0,0 +1,191 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include "render_object_bucket.h"
+
+namespace nova {
+    slot_handle render_object_bucket::insert(render_object&& obj) {
+        bounds.push_back(obj.bounding_box);
+        positions.emplace_back();
+        meshes.emplace_back();
+        textures.emplace_back();
+        lods.emplace_back();
+        lod_levels.emplace_back(0);
+        facing_ranges.emplace_back();
+        write_hot_data(meshes.size() - 1, obj);
+        regions.insert(meshes.size() - 1, obj.bounding_box);
+        version++;
+
+        return objects.insert(std::move(obj));
+    }
+
+    bool render_object_bucket::replace(const slot_handle& handle, render_object&& obj) {
+        auto* old_obj = objects.get(handle);
+        if(old_obj == nullptr) {
+            return false;
+        }
+
+        std::size_t index = objects.index_of(handle);
+        write_hot_data(index, obj);
+        regions.update(index, obj.bounding_box);
+        *old_obj = std::move(obj);
+        version++;
+
+        return true;
+    }
+
+    bool render_object_bucket::erase(const slot_handle& handle) {
+        if(!objects.contains(handle)) {
+            return false;
+        }
+
+        // slot_map moves its last value into the hole, so do the same thing with the hot arrays
+        std::size_t index = objects.index_of(handle);
+        objects.erase(handle);
+
+        std::size_t last_index = positions.size() - 1;
+        bounds.swap_remove(index);
+        regions.swap_remove(index);
+        if(index != last_index) {
+            positions[index] = positions[last_index];
+            meshes[index] = meshes[last_index];
+            textures[index] = textures[last_index];
+            lods[index] = lods[last_index];
+            lod_levels[index] = lod_levels[last_index];
+            facing_ranges[index] = facing_ranges[last_index];
+        }
+        positions.pop_back();
+        meshes.pop_back();
+        textures.pop_back();
+        lods.pop_back();
+        lod_levels.pop_back();
+        facing_ranges.pop_back();
+        version++;
+
+        return true;
+    }
+
+    bool render_object_bucket::set_bounds(const slot_handle& handle, const aabb& new_bounds) {
+        auto* obj = objects.get(handle);
+        if(obj == nullptr) {
+            return false;
+        }
+
+        obj->bounding_box = new_bounds;
+        std::size_t index = objects.index_of(handle);
+        bounds.set(index, new_bounds);
+        regions.update(index, new_bounds);
+        version++;
+        return true;
+    }
+
+    bool render_object_bucket::set_facing_ranges(const slot_handle& handle, const quad_facing_ranges& new_ranges) {
+        auto* obj = objects.get(handle);
+        if(obj == nullptr) {
+            return false;
+        }
+
+        obj->facing_ranges = new_ranges;
+        facing_ranges[objects.index_of(handle)] = new_ranges;
+        version++;
+        return true;
+    }
+
+    void render_object_bucket::cull(const frustum_planes& planes, std::vector<std::uint8_t>& visible,
+                                    frustum_cull_stats& stats) {
+        regions.cull(planes, bounds, visible, stats);
+    }
+
+    std::size_t render_object_bucket::get_num_regions() const {
+        return regions.get_num_regions();
+    }
+
+    render_object* render_object_bucket::get(const slot_handle& handle) {
+        return objects.get(handle);
+    }
+
+    slot_handle render_object_bucket::get_handle(std::size_t index) const {
+        return objects.get_handle(index);
+    }
+
+    std::size_t render_object_bucket::index_of(const slot_handle& handle) const {
+        return objects.index_of(handle);
+    }
+
+    render_object& render_object_bucket::operator[](std::size_t index) {
+        return objects[index];
+    }
+
+    std::size_t render_object_bucket::size() const {
+        return objects.size();
+    }
+
+    bool render_object_bucket::empty() const {
+        return objects.empty();
+    }
+
+    std::vector<render_object>::iterator render_object_bucket::begin() {
+        return objects.begin();
+    }
+
+    std::vector<render_object>::iterator render_object_bucket::end() {
+        return objects.end();
+    }
+
+    const aabb_soa& render_object_bucket::get_bounds() const {
+        return bounds;
+    }
+
+    const std::vector<glm::vec3>& render_object_bucket::get_positions() const {
+        return positions;
+    }
+
+    const std::vector<gl_mesh*>& render_object_bucket::get_meshes() const {
+        return meshes;
+    }
+
+    const std::vector<render_object_textures>& render_object_bucket::get_textures() const {
+        return textures;
+    }
+
+    const std::vector<render_object_lods>& render_object_bucket::get_lods() const {
+        return lods;
+    }
+
+    const std::vector<quad_facing_ranges>& render_object_bucket::get_facing_ranges() const {
+        return facing_ranges;
+    }
+
+    std::vector<std::uint8_t>& render_object_bucket::get_lod_levels() {
+        return lod_levels;
+    }
+
+    std::uint64_t render_object_bucket::get_version() const {
+        return version;
+    }
+
+    void render_object_bucket::write_hot_data(std::size_t index, const render_object& obj) {
+        bounds.set(index, obj.bounding_box);
+        positions[index] = obj.position;
+        meshes[index] = obj.geometry.get();
+
+        textures[index].color = obj.color_texture.empty() ? NO_NAME : intern_name(obj.color_texture);
+        textures[index].normalmap = obj.normalmap ? intern_name(*obj.normalmap) : NO_NAME;
+        textures[index].data = obj.data_texture ? intern_name(*obj.data_texture) : NO_NAME;
+
+        auto& object_lods = lods[index];
+        object_lods.num_levels = std::min(obj.lod_geometry.size(), MAX_CHUNK_LOD_LEVELS);
+        for(std::size_t level = 0; level < MAX_CHUNK_LOD_LEVELS; level++) {
+            object_lods.meshes[level] = level < object_lods.num_levels ? obj.lod_geometry[level].get() : nullptr;
+        }
+
+        facing_ranges[index] = obj.facing_ranges;
+
+        if(lod_levels[index] > object_lods.num_levels) {
+            lod_levels[index] = static_cast<std::uint8_t>(object_lods.num_levels);
+        }
+    }
+}
@@ -0,0 +1,187 @@
+/*!
+ * \brief All the render_objects for one shader, split into the data that's read every frame and the data that isn't
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_RENDER_OBJECT_BUCKET_H
+#define RENDERER_RENDER_OBJECT_BUCKET_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "render_object.h"
+#include "../../utils/slot_map.h"
+#include "../../utils/name_table.h"
+#include "frustum_culling.h"
+#include "region_grid.h"
+#include "../../geometry_cache/lod_builder.h"
+
+namespace nova {
+    /*!
+     * \brief The interned names of the textures a render_object uses. Textures it doesn't have are NO_NAME
+     */
+    struct render_object_textures {
+        name_id color;
+        name_id normalmap;
+        name_id data;
+    };
+
+    /*!
+     * \brief The simplified meshes a render_object has, coarsest last
+     */
+    struct render_object_lods {
+        std::array<gl_mesh*, MAX_CHUNK_LOD_LEVELS> meshes;
+        std::size_t num_levels;
+    };
+
+    /*!
+     * \brief Stores render_objects as parallel arrays so that culling and drawing only touch what they need
+     *
+     * A render_object is a couple hundred bytes, mostly strings that the draw loop never reads. Walking an array of them
+     * to check bounding boxes drags all of that through the cache. Instead, the bounding box, position, and mesh of each
+     * render_object, along with its interned texture names, are copied into their own tightly packed arrays when the
+     * render_object is added, and the full render_objects are kept off to the side.
+     *
+     * All the arrays are in the same order, so index i in any of them refers to the same render_object. Like a
+     * slot_map, removing a render_object moves the last one into its place, and render_objects are otherwise referred
+     * to by handle.
+     *
+     * The hot arrays are snapshots. If you change a render_object's position, bounds or mesh, #replace it so that the
+     * hot arrays see the change
+     */
+    class render_object_bucket {
+    public:
+        /*!
+         * \brief Adds a render_object to the bucket
+         *
+         * \return A handle to the new render_object
+         */
+        slot_handle insert(render_object&& obj);
+
+        /*!
+         * \brief Swaps out the render_object that the given handle refers to, keeping its handle
+         *
+         * \return True if the render_object was replaced, false if the handle was stale
+         */
+        bool replace(const slot_handle& handle, render_object&& obj);
+
+        /*!
+         * \brief Removes the render_object that the given handle refers to
+         *
+         * \return True if the render_object was removed, false if the handle was stale
+         */
+        bool erase(const slot_handle& handle);
+
+        /*!
+         * \brief Changes a render_object's bounding box, keeping the hot copy of it up to date
+         *
+         * \return False if the handle is stale
+         */
+        bool set_bounds(const slot_handle& handle, const aabb& new_bounds);
+
+        /*!
+         * \brief Changes where a render_object's quads facing each way are, keeping the hot copy up to date
+         *
+         * \return False if the handle is stale
+         */
+        bool set_facing_ranges(const slot_handle& handle, const quad_facing_ranges& new_ranges);
+
+        /*!
+         * \brief Finds which render_objects might be visible from the given frustum
+         *
+         * The render_objects are grouped into regions of 8x8 chunks, so most of them are accepted or rejected along
+         * with their whole region. Any pass can call this with its own frustum
+         *
+         * \param planes The frustum to test against
+         * \param visible Resized to the number of render_objects. Each one is nonzero if that render_object might be
+         * visible
+         * \param stats Counts of what was tested and rejected are added to this
+         */
+        void cull(const frustum_planes& planes, std::vector<std::uint8_t>& visible, frustum_cull_stats& stats);
+
+        std::size_t get_num_regions() const;
+
+        /*!
+         * \brief Returns the render_object that the given handle refers to, or nullptr if the handle is stale
+         */
+        render_object* get(const slot_handle& handle);
+
+        slot_handle get_handle(std::size_t index) const;
+
+        /*!
+         * \brief Returns where the render_object that the given handle refers to is in the arrays. The handle must not
+         * be stale
+         */
+        std::size_t index_of(const slot_handle& handle) const;
+
+        /*!
+         * \brief Accesses the full render_objects by their index in the arrays
+         */
+        render_object& operator[](std::size_t index);
+
+        std::size_t size() const;
+
+        bool empty() const;
+
+        /*!
+         * \brief Iterates over the full render_objects
+         */
+        std::vector<render_object>::iterator begin();
+        std::vector<render_object>::iterator end();
+
+        // The hot arrays
+
+        /*!
+         * \brief The bounding boxes, one array per component so that they can be culled in batches
+         */
+        const aabb_soa& get_bounds() const;
+
+        const std::vector<glm::vec3>& get_positions() const;
+
+        const std::vector<gl_mesh*>& get_meshes() const;
+
+        const std::vector<render_object_textures>& get_textures() const;
+
+        const std::vector<render_object_lods>& get_lods() const;
+
+        const std::vector<quad_facing_ranges>& get_facing_ranges() const;
+
+        /*!
+         * \brief The level of detail each render_object was last drawn with. 0 is full detail
+         *
+         * The draw loop keeps these up to date so that it can tell which way a render_object is switching. Replacing a
+         * render_object keeps its level, as long as the new render_object has that many levels
+         */
+        std::vector<std::uint8_t>& get_lod_levels();
+
+        /*!
+         * \brief Goes up whenever a render_object is added, replaced or removed, or has its bounds or facing ranges
+         * changed, so anything built from the hot arrays can tell when it needs rebuilding
+         */
+        std::uint64_t get_version() const;
+
+    private:
+        slot_map<render_object> objects;
+
+        aabb_soa bounds;
+        std::vector<glm::vec3> positions;
+        std::vector<gl_mesh*> meshes;
+        std::vector<render_object_textures> textures;
+        std::vector<render_object_lods> lods;
+        std::vector<std::uint8_t> lod_levels;
+        std::vector<quad_facing_ranges> facing_ranges;
+        std::uint64_t version = 0;
+
+        /*!
+         * \brief Kept in step with the hot arrays, so that culling doesn't have to look at every bounding box
+         */
+        region_grid regions;
+
+        void write_hot_data(std::size_t index, const render_object& obj);
+    };
+}
+
+#endif //RENDERER_RENDER_OBJECT_BUCKET_H
@@ -0,0 +1,112 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <array>
+#include "render_queue.h"
+
+namespace nova {
+    static const int PASS_SHIFT = 60;
+
+    std::uint32_t quantize_sort_depth(float distance, float max_distance) {
+        if(!(distance > 0) || !(max_distance > 0)) {
+            return 0;
+        }
+
+        float normalized = std::min(distance / max_distance, 1.0f);
+        return static_cast<std::uint32_t>(normalized * static_cast<float>(MAX_SORT_DEPTH));
+    }
+
+    std::uint16_t hash_texture_set(name_id color, name_id normalmap, name_id data) {
+        std::uint32_t hash = color;
+        hash ^= normalmap + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= data + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return static_cast<std::uint16_t>(hash ^ (hash >> 16));
+    }
+
+    std::uint64_t make_sort_key(render_pass pass, std::uint32_t shader, std::uint16_t texture_set,
+                                std::uint32_t pool_page, std::uint32_t depth) {
+        auto key = static_cast<std::uint64_t>(pass) << PASS_SHIFT;
+        auto shader_bits = static_cast<std::uint64_t>(shader & 0xFF);
+        auto texture_bits = static_cast<std::uint64_t>(texture_set);
+        auto pool_bits = static_cast<std::uint64_t>(std::min(pool_page, NO_POOL_PAGE));
+        auto depth_bits = static_cast<std::uint64_t>(std::min(depth, MAX_SORT_DEPTH));
+
+        if(pass == render_pass::translucent) {
+            return key | ((MAX_SORT_DEPTH - depth_bits) << 36) | (shader_bits << 28) | (texture_bits << 12) |
+                   pool_bits;
+        }
+
+        return key | (shader_bits << 52) | (texture_bits << 36) | (pool_bits << 24) | depth_bits;
+    }
+
+    render_pass get_sort_key_pass(std::uint64_t key) {
+        return static_cast<render_pass>(key >> PASS_SHIFT);
+    }
+
+    void render_queue::clear() {
+        entries.clear();
+    }
+
+    void render_queue::add(std::uint64_t key, std::uint32_t object, std::uint16_t shader, std::uint8_t lod_level) {
+        entries.push_back({key, object, shader, lod_level});
+    }
+
+    void render_queue::sort() {
+        num_sort_passes = 0;
+        if(entries.size() < 2) {
+            return;
+        }
+
+        std::array<std::array<std::uint32_t, 256>, 8> counts = {};
+        for(const auto& entry : entries) {
+            for(std::size_t digit = 0; digit < 8; digit++) {
+                counts[digit][(entry.key >> (digit * 8)) & 0xFF]++;
+            }
+        }
+
+        scratch.resize(entries.size());
+        for(std::size_t digit = 0; digit < 8; digit++) {
+            auto& digit_counts = counts[digit];
+
+            // Every key has the same byte here, so this pass wouldn't move anything
+            auto first_byte = static_cast<std::uint8_t>((entries[0].key >> (digit * 8)) & 0xFF);
+            if(digit_counts[first_byte] == entries.size()) {
+                continue;
+            }
+
+            std::uint32_t offset = 0;
+            for(auto& count : digit_counts) {
+                std::uint32_t bucket_size = count;
+                count = offset;
+                offset += bucket_size;
+            }
+
+            for(const auto& entry : entries) {
+                scratch[digit_counts[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+            }
+
+            entries.swap(scratch);
+            num_sort_passes++;
+        }
+    }
+
+    const std::vector<render_queue_entry>& render_queue::get_entries() const {
+        return entries;
+    }
+
+    std::size_t render_queue::find_pass_start(render_pass pass) const {
+        auto first_key = static_cast<std::uint64_t>(pass) << PASS_SHIFT;
+        auto start = std::lower_bound(entries.begin(), entries.end(), first_key,
+                                      [](const render_queue_entry& entry, std::uint64_t key) {
+                                          return entry.key < key;
+                                      });
+        return static_cast<std::size_t>(start - entries.begin());
+    }
+
+    std::size_t render_queue::get_num_sort_passes() const {
+        return num_sort_passes;
+    }
+}
@@ -0,0 +1,162 @@
+/*!
+ * \brief Orders a frame's draws by a single sort key, so that state changes are grouped together and depth is in the
+ * right order for each pass
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_RENDER_QUEUE_H
+#define RENDERER_RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../../utils/name_table.h"
+
+namespace nova {
+    /*!
+     * \brief The passes of the gbuffers, in the order they're drawn
+     */
+    enum class render_pass : std::uint8_t {
+        /*!
+         * \brief Geometry that writes depth and doesn't blend. Drawn front to back so the depth test throws away as
+         * much as it can
+         */
+        opaque = 0,
+
+        /*!
+         * \brief Geometry that blends with what's behind it. Drawn back to front after everything opaque
+         */
+        translucent = 1,
+    };
+
+    /*!
+     * \brief How many shaders a frame's keys can tell apart
+     */
+    const std::size_t MAX_QUEUED_SHADERS = 256;
+
+    /*!
+     * \brief The biggest depth that fits in a key
+     */
+    const std::uint32_t MAX_SORT_DEPTH = (1u << 24) - 1;
+
+    /*!
+     * \brief The pool page of meshes that aren't in the geometry pool. They each have their own vertex array, so they
+     * go after everything that shares one
+     */
+    const std::uint32_t NO_POOL_PAGE = (1u << 12) - 1;
+
+    /*!
+     * \brief Turns a distance from the camera into the depth bits of a key
+     *
+     * \param distance How far away the thing being drawn is
+     * \param max_distance The distance that maps to MAX_SORT_DEPTH. Anything further away is clamped to it
+     */
+    std::uint32_t quantize_sort_depth(float distance, float max_distance);
+
+    /*!
+     * \brief Folds the three textures of a render_object into the texture bits of a key
+     *
+     * Two different sets can end up with the same bits. That only costs some sorting quality, since the draw loop
+     * still compares the real textures before binding anything
+     */
+    std::uint16_t hash_texture_set(name_id color, name_id normalmap, name_id data);
+
+    /*!
+     * \brief Packs everything that decides where a draw goes in the queue into 64 bits
+     *
+     * The pass always goes in the top four bits. Opaque keys then sort by shader, textures, pool page, and finally
+     * depth, so the things that are expensive to change change the least. Translucent keys have to be drawn back to
+     * front no matter what that costs, so the inverted depth comes right after the pass and the state only breaks ties
+     *
+     * \param pass Which pass the draw is in
+     * \param shader The shader's slot in the frame's list of shaders. Less than MAX_QUEUED_SHADERS
+     * \param texture_set hash_texture_set of the draw's textures
+     * \param pool_page Which page of the geometry pool the mesh is in, or NO_POOL_PAGE
+     * \param depth quantize_sort_depth of the draw's distance from the camera
+     */
+    std::uint64_t make_sort_key(render_pass pass, std::uint32_t shader, std::uint16_t texture_set,
+                                std::uint32_t pool_page, std::uint32_t depth);
+
+    render_pass get_sort_key_pass(std::uint64_t key);
+
+    /*!
+     * \brief A render_object that's going to be drawn this frame
+     */
+    struct render_queue_entry {
+        std::uint64_t key;
+
+        /*!
+         * \brief The render_object's index in its shader's bucket
+         */
+        std::uint32_t object;
+
+        /*!
+         * \brief The shader's slot in the frame's list of shaders
+         */
+        std::uint16_t shader;
+
+        /*!
+         * \brief The level of detail that was picked when the render_object was queued
+         */
+        std::uint8_t lod_level;
+    };
+
+    /*!
+     * \brief What the render queue did in the last frame
+     */
+    struct render_queue_stats {
+        std::size_t num_entries;
+
+        /*!
+         * \brief How many of the radix sort's eight passes actually moved entries around
+         */
+        std::size_t num_sort_passes;
+
+        std::size_t num_shader_binds;
+        std::size_t num_texture_binds;
+        std::size_t num_vertex_array_binds;
+    };
+
+    /*!
+     * \brief The draws of one frame, sorted by key
+     *
+     * Every visible render_object of every gbuffers shader goes in here, rather than each shader drawing its own bucket
+     * in bucket order. After sorting, draws that share a shader, textures and vertex array are next to each other no
+     * matter which bucket they came from, and each pass is in the depth order it wants.
+     *
+     * The sort is a least significant digit radix sort over the key's eight bytes. All eight histograms are counted in
+     * one pass over the entries, and a byte that's the same in every key is skipped, which is most of them when the
+     * queue only has a couple of shaders in it. The sort is stable, so entries with equal keys stay in the order they
+     * were added in. The scratch space is kept between frames
+     */
+    class render_queue {
+    public:
+        void clear();
+
+        void add(std::uint64_t key, std::uint32_t object, std::uint16_t shader, std::uint8_t lod_level);
+
+        void sort();
+
+        const std::vector<render_queue_entry>& get_entries() const;
+
+        /*!
+         * \brief The index of the first entry in the given pass, or the number of entries if no entry is in a pass
+         * that late. Only valid after sorting
+         */
+        std::size_t find_pass_start(render_pass pass) const;
+
+        /*!
+         * \brief How many bytes the last sort had to move entries for
+         */
+        std::size_t get_num_sort_passes() const;
+
+    private:
+        std::vector<render_queue_entry> entries;
+        std::vector<render_queue_entry> scratch;
+        std::size_t num_sort_passes = 0;
+    };
+}
+
+#endif //RENDERER_RENDER_QUEUE_H
@@ -0,0 +1,159 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "section_visibility.h"
+#include "../../mc_interface/mc_objects.h"
+
+namespace nova {
+    static const int NUM_SECTIONS_TALL = CHUNK_HEIGHT / CHUNK_SECTION_HEIGHT;
+
+    static const glm::ivec3 FACE_DIRECTIONS[NUM_SECTION_FACES] = {
+            {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}, {-1, 0, 0}, {1, 0, 0}
+    };
+
+    /*!
+     * \brief The search hasn't come in through any face of the camera's section
+     */
+    static const int NO_FACE = -1;
+
+    static glm::ivec3 get_section(const glm::vec3& position) {
+        return {
+                static_cast<int>(std::floor(position.x / CHUNK_WIDTH)),
+                static_cast<int>(std::floor(position.y / CHUNK_SECTION_HEIGHT)),
+                static_cast<int>(std::floor(position.z / CHUNK_DEPTH))
+        };
+    }
+
+    std::size_t section_position_hash::operator()(const glm::ivec3& section) const {
+        // The same primes as chunk_section_key_hash
+        std::size_t hash = static_cast<std::size_t>(section.x) * 73856093u;
+        hash ^= static_cast<std::size_t>(section.y) * 19349663u;
+        hash ^= static_cast<std::size_t>(section.z) * 83492791u;
+        return hash;
+    }
+
+    void section_visibility_graph::set_connectivity(const glm::ivec3& section, section_connectivity new_connectivity) {
+        // Sections that are see-through everywhere are the same as sections nothing is known about
+        if(new_connectivity == ALL_FACES_CONNECTED) {
+            connectivity.erase(section);
+        } else {
+            connectivity[section] = new_connectivity;
+        }
+    }
+
+    void section_visibility_graph::clear() {
+        connectivity.clear();
+    }
+
+    section_connectivity section_visibility_graph::get_connectivity(const glm::ivec3& section) const {
+        auto itr = connectivity.find(section);
+        return itr == connectivity.end() ? ALL_FACES_CONNECTED : itr->second;
+    }
+
+    int section_visibility_graph::get_window_index(const glm::ivec3& section) const {
+        glm::ivec3 offset = section - window_min;
+        if(offset.x < 0 || offset.x >= window_width || offset.y < 0 || offset.y >= window_height || offset.z < 0 ||
+           offset.z >= window_width) {
+            return -1;
+        }
+        return (offset.y * window_width + offset.z) * window_width + offset.x;
+    }
+
+    void section_visibility_graph::find_visible_sections(const glm::vec3& camera_position, const frustum_planes& planes) {
+        num_visited = 0;
+
+        glm::ivec3 camera_section = get_section(camera_position);
+        has_window = camera_section.y >= 0 && camera_section.y < NUM_SECTIONS_TALL;
+        if(!has_window) {
+            return;
+        }
+
+        window_width = MAX_TRAVERSAL_DISTANCE * 2 + 1;
+        window_height = NUM_SECTIONS_TALL;
+        window_min = {camera_section.x - MAX_TRAVERSAL_DISTANCE, 0, camera_section.z - MAX_TRAVERSAL_DISTANCE};
+        reached.assign(static_cast<std::size_t>(window_width) * window_width * window_height, 0);
+
+        const glm::vec3 section_size(CHUNK_WIDTH, CHUNK_SECTION_HEIGHT, CHUNK_DEPTH);
+
+        to_visit.clear();
+        to_visit.push_back({camera_section, NO_FACE, 0});
+        reached[get_window_index(camera_section)] = 1;
+
+        for(std::size_t next = 0; next < to_visit.size(); next++) {
+            // Copied, since pushing onto to_visit can move it
+            traversal_step step = to_visit[next];
+            num_visited++;
+
+            section_connectivity step_connectivity = get_connectivity(step.section);
+
+            for(int face = 0; face < NUM_SECTION_FACES; face++) {
+                auto exit_face = static_cast<section_face>(face);
+
+                // Going back the way we came can only find sections that are behind something we've already seen
+                // past
+                if((step.directions >> get_opposite_face(exit_face)) & 1) {
+                    continue;
+                }
+
+                if(step.entered_through != NO_FACE &&
+                   !faces_connect(step_connectivity, static_cast<section_face>(step.entered_through), exit_face)) {
+                    continue;
+                }
+
+                glm::ivec3 neighbor = step.section + FACE_DIRECTIONS[face];
+                int index = get_window_index(neighbor);
+                if(index < 0 || reached[index]) {
+                    continue;
+                }
+
+                glm::vec3 neighbor_min = glm::vec3(neighbor) * section_size;
+                if(!is_aabb_in_frustum(planes, aabb::from_min_max(neighbor_min, neighbor_min + section_size))) {
+                    continue;
+                }
+
+                reached[index] = 1;
+                to_visit.push_back({neighbor, get_opposite_face(exit_face),
+                                    static_cast<std::uint8_t>(step.directions | (1 << face))});
+            }
+        }
+    }
+
+    bool section_visibility_graph::is_visible(const glm::vec3& position) const {
+        if(!has_window) {
+            return true;
+        }
+
+        int index = get_window_index(get_section(position));
+        return index < 0 || reached[index] != 0;
+    }
+
+    void section_visibility_graph::cull(const aabb_soa& boxes, std::vector<std::uint8_t>& visible,
+                                        section_visibility_stats& stats) const {
+        if(!has_window) {
+            return;
+        }
+
+        for(std::size_t i = 0; i < visible.size(); i++) {
+            if(visible[i] == 0) {
+                continue;
+            }
+
+            glm::vec3 center(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+            if(!is_visible(center)) {
+                visible[i] = 0;
+                stats.num_culled++;
+            }
+        }
+    }
+
+    section_visibility_stats section_visibility_graph::get_stats() const {
+        section_visibility_stats stats = {};
+        stats.num_known_sections = connectivity.size();
+        stats.num_visited_sections = num_visited;
+        return stats;
+    }
+}
@@ -0,0 +1,123 @@
+/*!
+ * \brief Finds the chunk sections that can be seen from the camera through the sections in between
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_SECTION_VISIBILITY_H
+#define RENDERER_SECTION_VISIBILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "frustum_culling.h"
+#include "../../geometry_cache/section_connectivity.h"
+
+namespace nova {
+    struct section_position_hash {
+        std::size_t operator()(const glm::ivec3& section) const;
+    };
+
+    /*!
+     * \brief How much the last traversal found
+     */
+    struct section_visibility_stats {
+        std::size_t num_known_sections;
+        std::size_t num_visited_sections;
+
+        /*!
+         * \brief How many render_objects were in the frustum but in a section that the traversal didn't reach
+         */
+        std::size_t num_culled;
+    };
+
+    /*!
+     * \brief Which faces of each chunk section can see each other, and which sections the camera can see through them
+     *
+     * Each frame, a breadth first search starts at the camera's section and steps into a neighboring section through
+     * a face if
+     * - the neighbor is in the frustum,
+     * - the section being left lets the face it was entered through see the face it's being left through, and
+     * - the step doesn't go back the way the search has already come, so that it can't wrap around behind a wall.
+     *
+     * That's what Minecraft's own renderer does. Sections that nothing has been said about are see-through from every
+     * face, so the search walks straight through the sky, and through anything Minecraft hasn't sent opacity for.
+     *
+     * Only sections within a window around the camera are searched. Anything outside of the window, or anything at all
+     * while the camera is above or below the world, counts as visible
+     */
+    class section_visibility_graph {
+    public:
+        /*!
+         * \brief How many sections the window reaches from the camera's section on x and z
+         */
+        static const int MAX_TRAVERSAL_DISTANCE = 32;
+
+        void set_connectivity(const glm::ivec3& section, section_connectivity connectivity);
+
+        /*!
+         * \brief Forgets every section's connectivity, like when leaving a world
+         */
+        void clear();
+
+        /*!
+         * \brief Searches outwards from the camera for the sections that it might be able to see
+         *
+         * \param camera_position The camera's position in world space
+         * \param planes The camera's frustum
+         */
+        void find_visible_sections(const glm::vec3& camera_position, const frustum_planes& planes);
+
+        /*!
+         * \brief Returns false if the last search didn't reach the section that the given point is in
+         */
+        bool is_visible(const glm::vec3& position) const;
+
+        /*!
+         * \brief Sets the entries of visible to 0 for the boxes whose centers are in sections the last search didn't
+         * reach
+         *
+         * \param boxes The boxes to test, in world space
+         * \param visible One entry per box. Only entries that aren't 0 are looked at
+         * \param stats The number of boxes culled is added to this
+         */
+        void cull(const aabb_soa& boxes, std::vector<std::uint8_t>& visible, section_visibility_stats& stats) const;
+
+        section_visibility_stats get_stats() const;
+
+    private:
+        std::unordered_map<glm::ivec3, section_connectivity, section_position_hash> connectivity;
+
+        /*!
+         * \brief A step of the search: the section it's at, which face it came in through, and which directions it's
+         * stepped in to get there
+         */
+        struct traversal_step {
+            glm::ivec3 section;
+            int entered_through;
+            std::uint8_t directions;
+        };
+
+        std::vector<traversal_step> to_visit;
+
+        bool has_window = false;
+        glm::ivec3 window_min;
+        int window_width = 0;
+        int window_height = 0;
+
+        /*!
+         * \brief One entry per section in the window, x fastest and then z. Not 0 if the search reached the section
+         */
+        std::vector<std::uint8_t> reached;
+        std::size_t num_visited = 0;
+
+        int get_window_index(const glm::ivec3& section) const;
+
+        section_connectivity get_connectivity(const glm::ivec3& section) const;
+    };
+}
+
+#endif //RENDERER_SECTION_VISIBILITY_H
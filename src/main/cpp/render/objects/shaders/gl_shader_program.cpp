@@ -10,7 +10,8 @@
 #include "gl_shader_program.h"
 
 namespace nova {
-    gl_shader_program::gl_shader_program(const shader_definition &source) : name(source.name) {
+    gl_shader_program::gl_shader_program(const shader_definition &source) :
+            name(source.name), interned_name(intern_name(source.name)), translucent(source.is_translucent) {
         LOG(TRACE) << "Creating shader with filter expression " << source.filter_expression;
         filter = source.filter_expression;
         LOG(TRACE) << "Created filter expression " << filter;
@@ -23,7 +24,9 @@ namespace nova {
     }
 
     gl_shader_program::gl_shader_program(gl_shader_program &&other) noexcept :
-            name(std::move(other.name)), filter(std::move(other.filter)) {
+            name(std::move(other.name)), interned_name(other.interned_name),
+            uniform_locations_by_id(std::move(other.uniform_locations_by_id)), filter(std::move(other.filter)),
+            translucent(other.translucent) {
 
         this->gl_name = other.gl_name;
 
@@ -147,6 +150,14 @@ namespace nova {
         return name;
     }
 
+    name_id gl_shader_program::get_name_id() const noexcept {
+        return interned_name;
+    }
+
+    bool gl_shader_program::is_translucent() const noexcept {
+        return translucent;
+    }
+
     GLint gl_shader_program::get_uniform_location(const std::string uniform_name) {
         auto location_in_uniform_locations = uniform_locations.find(uniform_name);
         if(location_in_uniform_locations == uniform_locations.end()) {
@@ -156,6 +167,20 @@ namespace nova {
         return uniform_locations[uniform_name];
     }
 
+    GLint gl_shader_program::get_uniform_location(name_id uniform_name) {
+        const GLint unknown_location = -2;
+        if(uniform_name >= uniform_locations_by_id.size()) {
+            uniform_locations_by_id.resize(uniform_name + 1, unknown_location);
+        }
+
+        auto& location = uniform_locations_by_id[uniform_name];
+        if(location == unknown_location) {
+            location = get_uniform_location(get_interned_name(uniform_name));
+        }
+
+        return location;
+    }
+
     wrong_shader_version::wrong_shader_version(const std::string &version_line) :
             std::runtime_error(
                     "Invalid version line: '" + version_line + "'. Please only use GLSL version 450 (NOT compatibility profile)"
@@ -14,6 +14,7 @@
 
 #include <glad/glad.h>
 #include "../../../utils/export.h"
+#include "../../../utils/name_table.h"
 #include "../../../data_loading/loaders/shader_source_structs.h"
 
 
@@ -103,6 +104,16 @@ namespace nova {
 
         std::string& get_name() noexcept;
 
+        /*!
+         * \brief Returns the interned form of this shader's name
+         */
+        name_id get_name_id() const noexcept;
+
+        /*!
+         * \brief If this shader's geometry goes in the translucent pass
+         */
+        bool is_translucent() const noexcept;
+
         /*!
          * \brief Finds the uniform location of the given uniform variable
          *
@@ -115,9 +126,27 @@ namespace nova {
          */
         GLint get_uniform_location(std::string uniform_name);
 
+        /*!
+         * \brief Finds the uniform location of the uniform variable with the given interned name
+         *
+         * Works like the string version, but the cache is an array, so this is cheap enough to call for every draw
+         *
+         * \param uniform_name The interned name of the uniform variable to get the location of
+         * \return The location of the desired uniform variable
+         */
+        GLint get_uniform_location(name_id uniform_name);
+
     private:
         std::string name;
 
+        name_id interned_name = NO_NAME;
+
+        /*!
+         * \brief Uniform locations indexed by the uniform's interned name. Locations we haven't looked up yet are -2,
+         * since glGetUniformLocation uses -1 for uniforms that don't exist
+         */
+        std::vector<GLint> uniform_locations_by_id;
+
         std::vector<GLuint> added_shaders;
 
         std::unordered_map<std::string, GLint> uniform_locations;
@@ -130,6 +159,8 @@ namespace nova {
          */
         std::string filter;
 
+        bool translucent = false;
+
         void create_shader(const std::vector<shader_line>& shader_source, GLenum shader_type);
 
         void check_for_shader_errors(GLuint shader_to_check, const std::vector<shader_line>& line_map);
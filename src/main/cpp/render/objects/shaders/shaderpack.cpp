@@ -18,6 +18,7 @@ namespace nova {
             LOG(TRACE) << "Adding shader " << shader.name;
             try {
                 loaded_shaders.emplace(shader.name, gl_shader_program(shader));
+                shader_order.push_back(shader.name);
             } catch(std::exception& e) {
                 LOG(ERROR) << "Could not load shader " << shader.name << " because " << e.what();
             }
@@ -34,8 +35,13 @@ namespace nova {
         return loaded_shaders;
     }
 
+    const std::vector<std::string>& shaderpack::get_shader_order() const {
+        return shader_order;
+    }
+
     void shaderpack::operator=(const shaderpack &other) {
         loaded_shaders = other.loaded_shaders;
+        shader_order = other.shader_order;
     }
 
     std::string &shaderpack::get_name() {
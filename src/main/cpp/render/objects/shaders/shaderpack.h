@@ -46,6 +46,11 @@ namespace nova {
 
 		std::unordered_map<std::string, gl_shader_program> &get_loaded_shaders();
 
+        /*!
+         * \brief The names of the shaders that loaded, in the order that shaders.json lists them
+         */
+        const std::vector<std::string>& get_shader_order() const;
+
         void operator=(const shaderpack& other);
 
         std::string& get_name();
@@ -53,6 +58,8 @@ namespace nova {
     private:
         std::unordered_map<std::string, gl_shader_program> loaded_shaders;
 
+        std::vector<std::string> shader_order;
+
         std::string name;
 
         /*!
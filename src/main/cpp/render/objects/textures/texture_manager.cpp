@@ -34,6 +34,7 @@ namespace nova {
         glDeleteTextures((GLsizei) texture_ids.size(), texture_ids.data());
 
         atlases.clear();
+        atlases_by_id.clear();
         locations.clear();
 
         atlases["lightmap"] = texture2D{};
@@ -106,8 +107,21 @@ namespace nova {
         }
     }
 
-    texture2D &texture_manager::get_texture(std::string texture_name) {
-        return atlases[texture_name];
+    texture2D &texture_manager::get_texture(const std::string &texture_name) {
+        return get_texture(intern_name(texture_name));
+    }
+
+    texture2D &texture_manager::get_texture(name_id texture_name) {
+        if(texture_name >= atlases_by_id.size()) {
+            atlases_by_id.resize(texture_name + 1, nullptr);
+        }
+
+        auto*& texture = atlases_by_id[texture_name];
+        if(texture == nullptr) {
+            texture = &atlases[get_interned_name(texture_name)];
+        }
+
+        return *texture;
     }
 
     int texture_manager::get_max_texture_size() {
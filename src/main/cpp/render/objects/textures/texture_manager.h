@@ -8,11 +8,13 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include "../../../mc_interface/mc_objects.h"
 #include "texture2D.h"
 #include "../../../utils/smart_enum.h"
+#include "../../../utils/name_table.h"
 
 namespace nova {
     /*!
@@ -120,7 +122,18 @@ namespace nova {
          * \param texture_name The name of the texture to get
          * \return A pointer to the atlas texture
          */
-        texture2D &get_texture(std::string texture_name);
+        texture2D &get_texture(const std::string &texture_name);
+
+        /*!
+         * \brief Returns the texture with the given interned name
+         *
+         * After the first time a texture is asked for, this is just an array lookup, so it's what the draw loop should
+         * use
+         *
+         * \param texture_name The interned name of the texture to get. Must not be NO_NAME
+         * \return The texture
+         */
+        texture2D &get_texture(name_id texture_name);
 
         /*!
          * \brief Returns the maximum texture size supported by OpenGL on the current platform
@@ -134,6 +147,14 @@ namespace nova {
     private:
         std::unordered_map<std::string, texture2D> atlases;
 
+        /*!
+         * \brief Points at the entries in atlases, indexed by interned name. Empty slots haven't been asked for yet
+         *
+         * References to the values in an unordered_map stay valid until they're erased, so these only need to be
+         * cleared when atlases is
+         */
+        std::vector<texture2D*> atlases_by_id;
+
         /*!
          * \brief A map from the name of a texture according to Minecraft and the UV coordinates it takes up in its
          * texture atlas
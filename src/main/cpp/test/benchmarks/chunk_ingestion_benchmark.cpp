@@ -0,0 +1,56 @@
+/*!
+ * \brief Measures how fast the chunk ingestion stage can expand Minecraft's vertex data
+ *
+ * Runs the vertex expansion kernel on one worker, then on every worker, and prints the number of vertices per second
+ * that each core manages. The per-core number should stay about the same as workers are added; if it drops, the
+ * kernel is limited by memory bandwidth rather than by the CPU
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../../geometry_cache/vertex_kernels.h"
+#include "../../utils/worker_pool.h"
+
+namespace {
+    // About what a busy chunk section sends us: 4096 quads
+    const std::size_t VERTICES_PER_CHUNK = 4 * 4096;
+    const int CHUNKS_PER_WORKER = 2000;
+
+    double run_benchmark(std::size_t num_workers, const std::vector<int>& mc_data) {
+        nova::worker_pool pool(num_workers);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for(std::size_t worker = 0; worker < num_workers; worker++) {
+            pool.submit(worker, [&mc_data]() {
+                std::vector<int> expanded(VERTICES_PER_CHUNK * nova::EXPANDED_VERTEX_SIZE_INTS);
+                for(int chunk = 0; chunk < CHUNKS_PER_WORKER; chunk++) {
+                    nova::expand_mc_vertices(mc_data.data(), VERTICES_PER_CHUNK, expanded.data());
+                }
+            });
+        }
+        pool.wait_idle();
+        std::chrono::duration<double> seconds = std::chrono::high_resolution_clock::now() - start;
+
+        double total_vertices = double(VERTICES_PER_CHUNK) * CHUNKS_PER_WORKER * num_workers;
+        return total_vertices / seconds.count() / num_workers;
+    }
+}
+
+int main() {
+    std::vector<int> mc_data(VERTICES_PER_CHUNK * nova::MC_VERTEX_SIZE_INTS);
+    for(std::size_t i = 0; i < mc_data.size(); i++) {
+        mc_data[i] = static_cast<int>(i);
+    }
+
+    std::size_t max_workers = nova::worker_pool().get_num_workers();
+    for(std::size_t num_workers = 1; num_workers <= max_workers; num_workers *= 2) {
+        double vertices_per_second = run_benchmark(num_workers, mc_data);
+        std::printf("%zu worker(s): %.1f million vertices per second per core\n", num_workers, vertices_per_second / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*!
+ * \brief Tests for the ring buffer that Java writes chunk geometry into
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../data_loading/direct_buffers.h"
+
+namespace nova {
+    namespace test {
+        TEST(shared_ring_buffer_test, reservations_do_not_overlap) {
+            shared_ring_buffer ring(256);
+
+            long first = ring.reserve(100);
+            long second = ring.reserve(100);
+            ASSERT_EQ(0, first);
+            ASSERT_EQ(112, second);
+            ASSERT_EQ(224u, ring.get_bytes_in_use());
+
+            // Not enough room at the end, and the start is still in use
+            ASSERT_EQ(-1, ring.reserve(64));
+        }
+
+        TEST(shared_ring_buffer_test, wraps_around_once_the_oldest_space_is_released) {
+            shared_ring_buffer ring(256);
+
+            long first = ring.reserve(100);
+            long second = ring.reserve(100);
+
+            ring.release(first);
+            long third = ring.reserve(64);
+            ASSERT_EQ(0, third);
+
+            // The space between the wrapped reservation and the oldest one is free, but not big enough
+            ASSERT_EQ(-1, ring.reserve(64));
+            ASSERT_EQ(64, ring.reserve(48));
+
+            ring.release(second);
+            ring.release(third);
+            ASSERT_EQ(48u, ring.get_bytes_in_use());
+        }
+
+        TEST(shared_ring_buffer_test, space_is_reused_in_reservation_order) {
+            shared_ring_buffer ring(256);
+
+            long first = ring.reserve(128);
+            long second = ring.reserve(128);
+
+            // Releasing the newer reservation doesn't free anything while the older one is outstanding
+            ring.release(second);
+            ASSERT_EQ(-1, ring.reserve(16));
+
+            ring.release(first);
+            ASSERT_EQ(0u, ring.get_bytes_in_use());
+            ASSERT_EQ(0, ring.reserve(256));
+        }
+
+        TEST(shared_ring_buffer_test, knows_which_pointers_are_inside_it) {
+            shared_ring_buffer ring(64);
+            int outside = 0;
+
+            ASSERT_TRUE(ring.contains(ring.data() + 10));
+            ASSERT_FALSE(ring.contains(&outside));
+            ASSERT_EQ(10, ring.offset_of(ring.data() + 10));
+        }
+    }
+}
@@ -0,0 +1,292 @@
+/*!
+ * \brief Tests for saving converted chunk geometry to disk and loading it again
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/chunk_mesh_cache.h"
+
+namespace nova {
+    namespace test {
+        static const std::string CACHE_PATH = "chunk_mesh_cache_test.nova_meshes";
+
+        static chunk_upload_request make_chunk_part(float x, std::uint64_t content_hash, int first_vertex_int) {
+            chunk_upload_request request;
+            request.filter = intern_name("chunk_mesh_cache_test");
+            request.is_removal = false;
+            request.definition.position = {x, 16, 32};
+            request.definition.id = 7;
+            request.definition.vertex_format = format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT;
+            request.definition.vertex_data = {first_vertex_int, 2, 3, 4, 5, 6};
+            request.num_quads = 1;
+            request.content_hash = content_hash;
+            request.is_patchable = true;
+            request.bounds = {{x + 8, 20, 40}, {8, 4, 8}};
+            request.lods.push_back({{9, 8, 7}, 1});
+            request.occluders.push_back({{x + 4, 18, 40}, {4, 0, 2}});
+            request.facing_ranges = {{0, 0, 1, 1, 1, 1, 1, 1}};
+            request.quad_slots = {0};
+            return request;
+        }
+
+        static std::vector<chunk_upload_request> load_cache(chunk_mesh_cache& cache) {
+            std::vector<chunk_upload_request> loaded;
+            cache.load([&](chunk_upload_request&& request) {
+                loaded.push_back(std::move(request));
+            });
+            return loaded;
+        }
+
+        static std::vector<chunk_upload_request> open_cache(chunk_mesh_cache& cache) {
+            cache.open(CACHE_PATH);
+            return load_cache(cache);
+        }
+
+        static chunk_upload_request make_removal(float x) {
+            chunk_upload_request removal;
+            removal.filter = intern_name("chunk_mesh_cache_test");
+            removal.is_removal = true;
+            removal.definition.position = {x, 16, 32};
+            return removal;
+        }
+
+        TEST(chunk_mesh_cache_test, round_trips_a_chunk_part) {
+            auto original = make_chunk_part(48, 1234, 1);
+
+            std::vector<std::uint8_t> record;
+            chunk_mesh_cache::serialize(original, record);
+
+            chunk_upload_request loaded;
+            ASSERT_TRUE(chunk_mesh_cache::deserialize(record.data(), record.size(), loaded));
+            ASSERT_EQ(original.filter, loaded.filter);
+            ASSERT_EQ(original.definition.position, loaded.definition.position);
+            ASSERT_EQ(original.definition.id, loaded.definition.id);
+            ASSERT_EQ(original.definition.vertex_format, loaded.definition.vertex_format);
+            ASSERT_EQ(original.definition.vertex_data, loaded.definition.vertex_data);
+            ASSERT_EQ(original.content_hash, loaded.content_hash);
+            ASSERT_EQ(original.bounds.center, loaded.bounds.center);
+            ASSERT_EQ(original.bounds.extents, loaded.bounds.extents);
+            ASSERT_EQ(original.num_quads, loaded.num_quads);
+            ASSERT_TRUE(loaded.is_patchable);
+            ASSERT_TRUE(loaded.is_cached);
+            ASSERT_EQ(1u, loaded.lods.size());
+            ASSERT_EQ(original.lods[0].vertex_data, loaded.lods[0].vertex_data);
+            ASSERT_EQ(1u, loaded.occluders.size());
+            ASSERT_EQ(original.occluders[0].center, loaded.occluders[0].center);
+            ASSERT_EQ(original.occluders[0].extents, loaded.occluders[0].extents);
+            ASSERT_TRUE(loaded.facing_ranges.is_sorted());
+            ASSERT_EQ(1u, loaded.facing_ranges.first_quad[FACE_UP + 1]);
+            ASSERT_EQ(original.quad_slots, loaded.quad_slots);
+
+            // A record that's been cut short is rejected rather than read past its end
+            ASSERT_FALSE(chunk_mesh_cache::deserialize(record.data(), record.size() - 1, loaded));
+        }
+
+        TEST(chunk_mesh_cache_test, loads_the_newest_version_of_each_section) {
+            std::remove(CACHE_PATH.c_str());
+
+            {
+                chunk_mesh_cache cache;
+                ASSERT_TRUE(open_cache(cache).empty());
+                ASSERT_TRUE(cache.is_open());
+
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.write(make_chunk_part(16, 2, 2));
+                cache.write(make_chunk_part(0, 3, 3));
+
+                // A section that's removed and then sent again comes back
+                cache.write(make_chunk_part(32, 4, 4));
+                cache.write(make_removal(32));
+                cache.write(make_chunk_part(32, 5, 5));
+
+                cache.close();
+                ASSERT_EQ(6u, cache.get_stats().num_written);
+            }
+
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(3u, loaded.size());
+            for(const auto& request : loaded) {
+                ASSERT_FALSE(request.is_removal);
+                if(request.definition.position.x == 0) {
+                    ASSERT_EQ(3u, request.content_hash);
+                } else if(request.definition.position.x == 16) {
+                    ASSERT_EQ(2u, request.content_hash);
+                } else {
+                    ASSERT_EQ(5u, request.content_hash);
+                }
+            }
+
+            // Opening rewrote the file with just the newest versions
+            ASSERT_EQ(3u, cache.get_stats().num_written);
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+
+        TEST(chunk_mesh_cache_test, does_not_load_removed_sections) {
+            std::remove(CACHE_PATH.c_str());
+            {
+                chunk_mesh_cache cache;
+                open_cache(cache);
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.write(make_chunk_part(16, 2, 2));
+                cache.write(make_chunk_part(32, 3, 3));
+
+                // The section became empty while playing, and Minecraft never sends empty sections
+                cache.write(make_removal(0));
+                cache.close();
+            }
+
+            {
+                // Removed after opening but before loading got to it, like a removal that beats the loading worker
+                chunk_mesh_cache cache;
+                cache.open(CACHE_PATH);
+                cache.write(make_removal(16));
+
+                auto loaded = load_cache(cache);
+                ASSERT_EQ(1u, loaded.size());
+                ASSERT_EQ(32, loaded[0].definition.position.x);
+                cache.close();
+            }
+
+            // Both tombstones stuck
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(1u, loaded.size());
+            ASSERT_EQ(32, loaded[0].definition.position.x);
+
+            // Tombstones for sections that are gone aren't copied into the fresh file
+            ASSERT_EQ(1u, cache.get_stats().num_written);
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+
+        TEST(chunk_mesh_cache_test, parent_tombstones_remove_every_section_of_the_parent) {
+            std::remove(CACHE_PATH.c_str());
+            {
+                chunk_mesh_cache cache;
+                open_cache(cache);
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.write(make_chunk_part(16, 2, 2));
+
+                auto other_parent = make_chunk_part(32, 3, 3);
+                other_parent.definition.id = 8;
+                cache.write(other_parent);
+
+                chunk_upload_request parent_removal;
+                parent_removal.filter = NO_NAME;
+                parent_removal.is_removal = true;
+                parent_removal.is_parent_removal = true;
+                parent_removal.definition.id = 7;
+                cache.write(parent_removal);
+
+                // Sent again after the parent was removed, so it stays
+                cache.write(make_chunk_part(16, 4, 4));
+                cache.close();
+            }
+
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(2u, loaded.size());
+            for(const auto& request : loaded) {
+                if(request.definition.position.x == 16) {
+                    ASSERT_EQ(4u, request.content_hash);
+                } else {
+                    ASSERT_EQ(32, request.definition.position.x);
+                }
+            }
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+
+        TEST(chunk_mesh_cache_test, patched_sections_are_not_loaded) {
+            std::remove(CACHE_PATH.c_str());
+            {
+                chunk_mesh_cache cache;
+                open_cache(cache);
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.write(make_chunk_part(16, 2, 2));
+
+                // The cached record for the section doesn't have the patch's quads, so it can't be used any more
+                auto patch = make_chunk_part(0, 0, 5);
+                patch.is_patch = true;
+                cache.write(patch);
+                cache.close();
+            }
+
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(1u, loaded.size());
+            ASSERT_EQ(16, loaded[0].definition.position.x);
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+
+        TEST(chunk_mesh_cache_test, keeps_sections_that_are_not_loaded) {
+            std::remove(CACHE_PATH.c_str());
+            {
+                chunk_mesh_cache cache;
+                open_cache(cache);
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.write(make_chunk_part(16, 2, 2));
+                cache.close();
+            }
+
+            {
+                // Only the section at x = 0 is close enough to the player
+                chunk_mesh_cache cache;
+                cache.open(CACHE_PATH);
+                std::vector<chunk_upload_request> loaded;
+                auto num_loaded = cache.load([&](chunk_upload_request&& request) {
+                    loaded.push_back(std::move(request));
+                }, [](const chunk_section_key& key) {
+                    return key.section.x == 0;
+                });
+
+                ASSERT_EQ(1u, num_loaded);
+                ASSERT_EQ(1u, loaded.size());
+                ASSERT_EQ(0, loaded[0].definition.position.x);
+                cache.close();
+            }
+
+            // The section that wasn't loaded is still there for later
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(2u, loaded.size());
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+
+        TEST(chunk_mesh_cache_test, ignores_a_record_that_was_cut_off) {
+            std::remove(CACHE_PATH.c_str());
+            {
+                chunk_mesh_cache cache;
+                open_cache(cache);
+                cache.write(make_chunk_part(0, 1, 1));
+                cache.close();
+            }
+
+            // Half a record, like the game closed in the middle of writing it
+            {
+                std::vector<std::uint8_t> record;
+                chunk_mesh_cache::serialize(make_chunk_part(16, 2, 2), record);
+                auto record_size = static_cast<std::uint32_t>(record.size());
+
+                std::ofstream file(CACHE_PATH, std::ios::binary | std::ios::app);
+                file.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+                file.write(reinterpret_cast<const char*>(record.data()), record.size() / 2);
+            }
+
+            chunk_mesh_cache cache;
+            auto loaded = open_cache(cache);
+            ASSERT_EQ(1u, loaded.size());
+            ASSERT_EQ(1u, loaded[0].content_hash);
+            cache.close();
+            std::remove(CACHE_PATH.c_str());
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*!
+ * \brief Tests for building and picking simplified chunk sections
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include "../../geometry_cache/lod_builder.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    namespace test {
+        static int float_bits(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            return bits;
+        }
+
+        static glm::vec3 vertex_position(const std::vector<int>& vertices, std::size_t vertex) {
+            glm::vec3 position;
+            std::memcpy(&position, &vertices[vertex * MC_VERTEX_SIZE_INTS], sizeof(position));
+            return position;
+        }
+
+        /*!
+         * \brief Adds the top face of the block at the given position, wound so that it faces up
+         */
+        static void add_block_top(std::vector<int>& vertices, int x, int y, int z, int color) {
+            const float corners[4][3] = {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}};
+            for(const auto& corner : corners) {
+                vertices.push_back(float_bits(x + corner[0]));
+                vertices.push_back(float_bits(y + corner[1]));
+                vertices.push_back(float_bits(z + corner[2]));
+                vertices.push_back(color);
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(0xF000F0);
+            }
+        }
+
+        static std::size_t num_quads(const std::vector<int>& vertices) {
+            return vertices.size() / (4 * MC_VERTEX_SIZE_INTS);
+        }
+
+        TEST(lod_builder_test, merges_a_flat_section_into_columns) {
+            std::vector<int> vertices;
+            for(int z = 0; z < 16; z++) {
+                for(int x = 0; x < 16; x++) {
+                    add_block_top(vertices, x, 3, z, 0x11223344);
+                }
+            }
+
+            for(std::size_t level = 1; level <= MAX_CHUNK_LOD_LEVELS; level++) {
+                int scale = get_lod_scale(level);
+                auto lod = build_lod_vertices(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS, scale);
+
+                // Everything is the same height, so there are no walls or skirts
+                std::size_t columns_per_side = 16 / static_cast<std::size_t>(scale);
+                ASSERT_EQ(columns_per_side * columns_per_side, num_quads(lod));
+
+                for(std::size_t vertex = 0; vertex < lod.size() / MC_VERTEX_SIZE_INTS; vertex++) {
+                    ASSERT_EQ(4, vertex_position(lod, vertex).y);
+                    ASSERT_EQ(0x11223344, lod[vertex * MC_VERTEX_SIZE_INTS + 3]);
+                }
+
+                // The merged quads still face up
+                glm::vec3 p0 = vertex_position(lod, 0);
+                glm::vec3 normal = glm::cross(vertex_position(lod, 1) - p0, vertex_position(lod, 2) - p0);
+                ASSERT_GT(normal.y, 0);
+            }
+        }
+
+        TEST(lod_builder_test, uses_the_highest_surface_in_each_column) {
+            std::vector<int> vertices;
+            add_block_top(vertices, 0, 1, 0, 1);
+            add_block_top(vertices, 1, 5, 1, 2);
+
+            auto lod = build_lod_vertices(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS, 8);
+
+            // One column, and it's the lowest one so it has no skirts
+            ASSERT_EQ(1u, num_quads(lod));
+            ASSERT_EQ(6, vertex_position(lod, 0).y);
+            ASSERT_EQ(2, lod[3]);
+        }
+
+        TEST(lod_builder_test, adds_walls_between_columns_of_different_heights) {
+            std::vector<int> vertices;
+            add_block_top(vertices, 0, 1, 0, 1);
+            add_block_top(vertices, 8, 5, 0, 2);
+
+            auto lod = build_lod_vertices(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS, 8);
+
+            // Two tops, the wall between them, and skirts on the two edges of the tall column that are on the section's
+            // edge
+            ASSERT_EQ(5u, num_quads(lod));
+
+            bool found_wall = false;
+            for(std::size_t quad = 0; quad < num_quads(lod); quad++) {
+                glm::vec3 p0 = vertex_position(lod, quad * 4);
+                glm::vec3 normal = glm::cross(vertex_position(lod, quad * 4 + 1) - p0, vertex_position(lod, quad * 4 + 2) - p0);
+                if(p0.x == 8 && normal.x != 0) {
+                    // The wall hangs off the tall column and faces the short one
+                    ASSERT_LT(normal.x, 0);
+                    found_wall = true;
+                }
+            }
+            ASSERT_TRUE(found_wall);
+        }
+
+        TEST(lod_builder_test, ignores_sections_without_upward_faces) {
+            std::vector<int> vertices(4 * MC_VERTEX_SIZE_INTS, 0);
+            ASSERT_TRUE(build_lod_vertices(vertices.data(), 4, 2).empty());
+
+            // Not a list of quads
+            ASSERT_TRUE(build_lod_vertices(vertices.data(), 3, 2).empty());
+        }
+
+        TEST(lod_builder_test, switches_levels_with_hysteresis) {
+            lod_settings settings;
+            settings.base_distance = 100;
+            settings.hysteresis = 0.1f;
+
+            ASSERT_EQ(0u, select_lod_level(0, 3, 50, settings));
+
+            // Just past the switching distance isn't far enough to switch...
+            ASSERT_EQ(0u, select_lod_level(0, 3, 105, settings));
+            ASSERT_EQ(1u, select_lod_level(0, 3, 115, settings));
+
+            // ...and just before it isn't close enough to switch back
+            ASSERT_EQ(1u, select_lod_level(1, 3, 95, settings));
+            ASSERT_EQ(0u, select_lod_level(1, 3, 85, settings));
+
+            // Far away things go straight to the coarsest level they have
+            ASSERT_EQ(3u, select_lod_level(0, 3, 1000, settings));
+            ASSERT_EQ(2u, select_lod_level(0, 2, 1000, settings));
+            ASSERT_EQ(0u, select_lod_level(2, 0, 1000, settings));
+        }
+    }
+}
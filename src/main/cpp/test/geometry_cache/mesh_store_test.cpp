@@ -5,10 +5,12 @@
  * \date 17-Jan-17.
  */
 
+#include <cstring>
 #include <gtest/gtest.h>
 #include "../../render/nova_renderer.h"
 #include "../test_utils.h"
 #include "../../data_loading/loaders/loaders.h"
+#include "../../geometry_cache/vertex_kernels.h"
 
 namespace nova {
     namespace test {
@@ -45,7 +47,7 @@ namespace nova {
 
             auto& gui_meshes = meshes.get_meshes_for_shader("gui");
 
-            ASSERT_EQ(1, gui_meshes.size());
+            ASSERT_EQ(1u, gui_meshes.size());
 
             auto& gui_mesh = gui_meshes[0];
 
@@ -57,6 +59,301 @@ namespace nova {
             ASSERT_EQ(false, gui_mesh.data_texture.has_value());
         }
 
+        /*!
+         * \brief Makes a chunk with a single quad in it. The indices should be in the order Minecraft uses for quads,
+         * so that the chunk can be patched
+         */
+        mc_chunk_render_object make_test_chunk(float x, float y, float z, int id, int* vertex_data, int* indices) {
+            mc_chunk_render_object chunk = {};
+            chunk.format = format::POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT;
+            chunk.x = x;
+            chunk.y = y;
+            chunk.z = z;
+            chunk.id = id;
+            chunk.vertex_data = vertex_data;
+            chunk.vertex_buffer_size = 28;
+            chunk.indices = indices;
+            chunk.index_buffer_size = 6;
+
+            return chunk;
+        }
+
+        TEST_F(mesh_store_test, replace_and_remove_chunk_sections) {
+            int vertex_data[28] = {};
+            int indices[6] = {0, 1, 2, 0, 2, 3};
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto first = make_test_chunk(0, 0, 0, 1, vertex_data, indices);
+            auto second = make_test_chunk(16, 0, 0, 2, vertex_data, indices);
+            auto third = make_test_chunk(32, 0, 0, 2, vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", first);
+            meshes.add_chunk_render_object("gbuffers_terrain", second);
+            meshes.add_chunk_render_object("gbuffers_terrain", third);
+            meshes.add_chunk_render_object("gbuffers_water", first);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            auto& terrain = meshes.get_meshes_for_shader("gbuffers_terrain");
+            ASSERT_EQ(3u, terrain.size());
+            ASSERT_EQ(1u, meshes.get_meshes_for_shader("gbuffers_water").size());
+
+            // Sending the same section again replaces it rather than adding another one
+            meshes.add_chunk_render_object("gbuffers_terrain", first);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(3u, terrain.size());
+
+            // Removing a section only removes it for the given filter
+            meshes.remove_chunk_render_object("gbuffers_terrain", first);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(2u, terrain.size());
+            ASSERT_EQ(1u, meshes.get_meshes_for_shader("gbuffers_water").size());
+
+            // Removals wait for the next frame
+            meshes.remove_render_objects_with_parent(2);
+            meshes.wait_for_ingestion();
+            ASSERT_EQ(2u, terrain.size());
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(0u, terrain.size());
+            ASSERT_EQ(1u, meshes.get_meshes_for_shader("gbuffers_water").size());
+
+            // A parent's chunk parts that haven't been uploaded yet go too
+            meshes.add_chunk_render_object("gbuffers_terrain", second);
+            meshes.remove_render_objects_with_parent(2);
+            meshes.add_chunk_render_object("gbuffers_terrain", third);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(32, terrain[0].position.x);
+        }
+
+        TEST_F(mesh_store_test, skip_unchanged_chunk_sections) {
+            int vertex_data[28] = {};
+            int indices[6] = {0, 1, 2, 0, 2, 3};
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto chunk = make_test_chunk(0, 0, 0, 1, vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(0u, meshes.get_num_skipped_chunk_uploads());
+
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(1u, meshes.get_meshes_for_shader("gbuffers_terrain").size());
+            ASSERT_EQ(1u, meshes.get_num_skipped_chunk_uploads());
+
+            // Different geometry for the same section is uploaded
+            vertex_data[0] = 1;
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(1u, meshes.get_meshes_for_shader("gbuffers_terrain").size());
+            ASSERT_EQ(1u, meshes.get_num_skipped_chunk_uploads());
+        }
+
+        /*!
+         * \brief Moves all four vertices of a quad made by make_test_chunk to the given height
+         */
+        void set_quad_height(int* vertex_data, float y) {
+            for(std::size_t vertex = 0; vertex < 4; vertex++) {
+                std::memcpy(&vertex_data[vertex * MC_VERTEX_SIZE_INTS + 1], &y, sizeof(float));
+            }
+        }
+
+        TEST_F(mesh_store_test, keep_overhanging_quads_in_their_section) {
+            int above_vertex_data[28] = {};
+            int indices[12] = {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto above = make_test_chunk(0, 80, 0, 1, above_vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", above);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            auto& terrain = meshes.get_meshes_for_shader("gbuffers_terrain");
+            ASSERT_EQ(1u, terrain.size());
+
+            // The second quad is the top of a fence, sticking up into the section above
+            int vertex_data[56] = {};
+            set_quad_height(vertex_data, 8);
+            set_quad_height(vertex_data + 28, 17);
+            auto chunk = make_test_chunk(0, 64, 0, 1, vertex_data, indices);
+            chunk.vertex_buffer_size = 56;
+            chunk.index_buffer_size = 12;
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            // Both quads stay in the section they were sent for, and the section above is left alone
+            ASSERT_EQ(2u, terrain.size());
+            for(auto& obj : terrain) {
+                if(obj.position.y == 64) {
+                    ASSERT_EQ(72, obj.bounding_box.get_min().y);
+                    ASSERT_EQ(81, obj.bounding_box.get_max().y);
+                } else {
+                    ASSERT_EQ(80, obj.position.y);
+                    ASSERT_EQ(80, obj.bounding_box.get_max().y);
+                }
+            }
+
+            meshes.remove_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(80, terrain[0].position.y);
+        }
+
+        /*!
+         * \brief Makes a patch that replaces num_replaced_quads quads of a chunk made by make_test_chunk, starting at
+         * first_quad, with the quads in vertex_data
+         */
+        mc_chunk_patch make_test_patch(float x, float y, float z, int id, int first_quad, int num_replaced_quads,
+                                       int* vertex_data, int num_vertex_ints) {
+            mc_chunk_patch patch = {};
+            patch.x = x;
+            patch.y = y;
+            patch.z = z;
+            patch.id = id;
+            patch.first_quad = first_quad;
+            patch.num_replaced_quads = num_replaced_quads;
+            patch.vertex_data = vertex_data;
+            patch.vertex_buffer_size = num_vertex_ints;
+
+            return patch;
+        }
+
+        /*!
+         * \brief How many quads a chunk section's mesh draws
+         */
+        std::size_t get_num_drawn_quads(const render_object& obj) {
+            auto* allocation = obj.geometry->get_allocation();
+            if(allocation == nullptr) {
+                return 0;
+            }
+
+            return allocation->num_indices / INDICES_PER_QUAD;
+        }
+
+        TEST_F(mesh_store_test, patch_chunk_sections_before_upload) {
+            int vertex_data[28] = {};
+            int indices[6] = {0, 1, 2, 0, 2, 3};
+            set_quad_height(vertex_data, 8);
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto chunk = make_test_chunk(0, 64, 0, 1, vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+
+            // Adds a second quad after the first one, before the section has had a chance to be uploaded
+            int patch_vertex_data[28] = {};
+            set_quad_height(patch_vertex_data, 12);
+            auto patch = make_test_patch(0, 64, 0, 1, 1, 0, patch_vertex_data, 28);
+            meshes.patch_chunk_render_object("gbuffers_terrain", patch);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            auto stats = meshes.get_chunk_patch_stats();
+            ASSERT_EQ(1u, stats.num_applied_before_upload);
+            ASSERT_EQ(0u, stats.num_applied_in_place);
+            ASSERT_EQ(0u, stats.num_failed);
+
+            auto& terrain = meshes.get_meshes_for_shader("gbuffers_terrain");
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(2u, get_num_drawn_quads(terrain[0]));
+            ASSERT_EQ(72, terrain[0].bounding_box.get_min().y);
+            ASSERT_EQ(76, terrain[0].bounding_box.get_max().y);
+        }
+
+        TEST_F(mesh_store_test, patch_resident_chunk_sections_in_place) {
+            int vertex_data[28] = {};
+            int indices[6] = {0, 1, 2, 0, 2, 3};
+            set_quad_height(vertex_data, 8);
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto chunk = make_test_chunk(0, 64, 0, 1, vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            auto& terrain = meshes.get_meshes_for_shader("gbuffers_terrain");
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(1u, get_num_drawn_quads(terrain[0]));
+
+            // Replaces the only quad with two, one lower and one higher
+            int patch_vertex_data[56] = {};
+            set_quad_height(patch_vertex_data, 4);
+            set_quad_height(patch_vertex_data + 28, 12);
+            auto patch = make_test_patch(0, 64, 0, 1, 0, 1, patch_vertex_data, 56);
+            meshes.patch_chunk_render_object("gbuffers_terrain", patch);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            auto stats = meshes.get_chunk_patch_stats();
+            ASSERT_EQ(0u, stats.num_applied_before_upload);
+            ASSERT_EQ(1u, stats.num_applied_in_place);
+            ASSERT_EQ(0u, stats.num_failed);
+            ASSERT_LT(0u, stats.bytes_written);
+
+            // The section's mesh was written to rather than replaced
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(2u, get_num_drawn_quads(terrain[0]));
+            ASSERT_EQ(68, terrain[0].bounding_box.get_min().y);
+            ASSERT_EQ(76, terrain[0].bounding_box.get_max().y);
+        }
+
+        TEST_F(mesh_store_test, report_chunk_patches_that_fail) {
+            int vertex_data[28] = {};
+            int indices[6] = {0, 1, 2, 0, 2, 3};
+
+            nova::mesh_store meshes;
+            nova::camera player_camera;
+            player_camera.recalculate_frustum();
+
+            auto chunk = make_test_chunk(0, 64, 0, 1, vertex_data, indices);
+            meshes.add_chunk_render_object("gbuffers_terrain", chunk);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            // The section only has one quad, so there's no fourth quad to replace
+            int patch_vertex_data[28] = {};
+            auto patch = make_test_patch(0, 64, 0, 1, 3, 1, patch_vertex_data, 28);
+            meshes.patch_chunk_render_object("gbuffers_terrain", patch);
+            meshes.wait_for_ingestion();
+            meshes.upload_new_geometry(player_camera);
+
+            ASSERT_EQ(1u, meshes.get_chunk_patch_stats().num_failed);
+
+            mc_chunk_patch failed = {};
+            ASSERT_TRUE(meshes.get_next_failed_chunk_patch(failed));
+            ASSERT_EQ(0, failed.x);
+            ASSERT_EQ(64, failed.y);
+            ASSERT_EQ(0, failed.z);
+            ASSERT_EQ(1, failed.id);
+            ASSERT_FALSE(meshes.get_next_failed_chunk_patch(failed));
+
+            // The section is left as it was until Minecraft sends it whole
+            auto& terrain = meshes.get_meshes_for_shader("gbuffers_terrain");
+            ASSERT_EQ(1u, terrain.size());
+            ASSERT_EQ(1u, get_num_drawn_quads(terrain[0]));
+        }
+
         TEST_F(mesh_store_test, test_set_shaderpack) {
             //auto shaders = shaderpack();
         }
@@ -0,0 +1,91 @@
+/*!
+ * \brief Tests for finding occluders in chunk sections
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include "../../geometry_cache/occluder_builder.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    namespace test {
+        static int float_bits(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            return bits;
+        }
+
+        static void add_quad(std::vector<int>& vertices, const float corners[4][3]) {
+            for(int corner = 0; corner < 4; corner++) {
+                vertices.push_back(float_bits(corners[corner][0]));
+                vertices.push_back(float_bits(corners[corner][1]));
+                vertices.push_back(float_bits(corners[corner][2]));
+                vertices.push_back(-1);
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(0xF000F0);
+            }
+        }
+
+        static void add_block_top(std::vector<int>& vertices, float x, float y, float z) {
+            const float corners[4][3] = {{x, y + 1, z}, {x, y + 1, z + 1}, {x + 1, y + 1, z + 1}, {x + 1, y + 1, z}};
+            add_quad(vertices, corners);
+        }
+
+        TEST(occluder_builder_test, merges_block_faces_into_one_occluder) {
+            std::vector<int> vertices;
+            for(int z = 2; z < 6; z++) {
+                for(int x = 0; x < 4; x++) {
+                    add_block_top(vertices, x, 7, z);
+                }
+            }
+
+            // The top of a slab is only half a block up, so it's not on the grid and doesn't count
+            const float slab_top[4][3] = {{8, 0.5f, 8}, {8, 0.5f, 9}, {9, 0.5f, 9}, {9, 0.5f, 8}};
+            add_quad(vertices, slab_top);
+
+            auto occluders = build_section_occluders(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS,
+                                                     {32, 64, 16});
+            ASSERT_EQ(1u, occluders.size());
+            ASSERT_EQ(glm::vec3(32, 72, 18), occluders[0].get_min());
+            ASSERT_EQ(glm::vec3(36, 72, 22), occluders[0].get_max());
+        }
+
+        TEST(occluder_builder_test, keeps_the_biggest_occluders) {
+            std::vector<int> vertices;
+
+            // A checkerboard can't be merged at all, so each face is its own occluder
+            for(int z = 0; z < 16; z++) {
+                for(int x = (z % 2); x < 16; x += 2) {
+                    add_block_top(vertices, x, 0, z);
+                }
+            }
+
+            // A wall facing along x, 3 blocks wide and 2 tall
+            for(float y = 4; y < 6; y++) {
+                for(float z = 4; z < 7; z++) {
+                    const float corners[4][3] = {{10, y, z}, {10, y + 1, z}, {10, y + 1, z + 1}, {10, y, z + 1}};
+                    add_quad(vertices, corners);
+                }
+            }
+
+            auto occluders = build_section_occluders(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS, {});
+            ASSERT_EQ(MAX_OCCLUDERS_PER_SECTION, occluders.size());
+            ASSERT_EQ(glm::vec3(10, 4, 4), occluders[0].get_min());
+            ASSERT_EQ(glm::vec3(10, 6, 7), occluders[0].get_max());
+        }
+
+        TEST(occluder_builder_test, ignores_sections_without_whole_faces) {
+            std::vector<int> vertices;
+            const float torch[4][3] = {{7.5f, 0, 7.5f}, {7.5f, 0.6f, 7.5f}, {8.5f, 0.6f, 8.5f}, {8.5f, 0, 8.5f}};
+            add_quad(vertices, torch);
+
+            ASSERT_TRUE(build_section_occluders(vertices.data(), 4, {}).empty());
+            ASSERT_TRUE(build_section_occluders(vertices.data(), 3, {}).empty());
+        }
+    }
+}
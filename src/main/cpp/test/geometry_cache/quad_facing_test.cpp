@@ -0,0 +1,141 @@
+/*!
+ * \brief Tests for grouping chunk quads by which way they face
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include "../../geometry_cache/quad_facing.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    namespace test {
+        static int float_bits(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            return bits;
+        }
+
+        static void add_quad(std::vector<int>& vertices, const float corners[4][3], int color) {
+            for(int corner = 0; corner < 4; corner++) {
+                vertices.push_back(float_bits(corners[corner][0]));
+                vertices.push_back(float_bits(corners[corner][1]));
+                vertices.push_back(float_bits(corners[corner][2]));
+                vertices.push_back(color);
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(float_bits(0.5f));
+                vertices.push_back(0xF000F0);
+            }
+        }
+
+        static void add_block_top(std::vector<int>& vertices, float x, float y, float z, int color) {
+            const float corners[4][3] = {{x, y + 1, z}, {x, y + 1, z + 1}, {x + 1, y + 1, z + 1}, {x + 1, y + 1, z}};
+            add_quad(vertices, corners, color);
+        }
+
+        static void add_block_bottom(std::vector<int>& vertices, float x, float y, float z, int color) {
+            const float corners[4][3] = {{x, y, z}, {x + 1, y, z}, {x + 1, y, z + 1}, {x, y, z + 1}};
+            add_quad(vertices, corners, color);
+        }
+
+        static void add_block_east(std::vector<int>& vertices, float x, float y, float z, int color) {
+            const float corners[4][3] = {{x + 1, y, z}, {x + 1, y + 1, z}, {x + 1, y + 1, z + 1}, {x + 1, y, z + 1}};
+            add_quad(vertices, corners, color);
+        }
+
+        static void add_plant_quad(std::vector<int>& vertices, float x, float y, float z, int color) {
+            const float corners[4][3] = {{x, y, z}, {x, y + 1, z}, {x + 1, y + 1, z + 1}, {x + 1, y, z + 1}};
+            add_quad(vertices, corners, color);
+        }
+
+        static int get_color(const std::vector<int>& vertices, std::size_t quad) {
+            return vertices[quad * VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS + 3];
+        }
+
+        TEST(quad_facing_test, finds_which_way_quads_face) {
+            std::vector<int> vertices;
+            add_block_top(vertices, 0, 0, 0, 0);
+            add_block_bottom(vertices, 0, 0, 0, 0);
+            add_block_east(vertices, 0, 0, 0, 0);
+            add_plant_quad(vertices, 0, 0, 0, 0);
+
+            const std::size_t quad_size_ints = VERTICES_PER_QUAD * MC_VERTEX_SIZE_INTS;
+            ASSERT_EQ(FACE_UP, get_mc_quad_facing(&vertices[0]));
+            ASSERT_EQ(FACE_DOWN, get_mc_quad_facing(&vertices[quad_size_ints]));
+            ASSERT_EQ(FACE_EAST, get_mc_quad_facing(&vertices[quad_size_ints * 2]));
+            ASSERT_EQ(FACING_ANY, get_mc_quad_facing(&vertices[quad_size_ints * 3]));
+        }
+
+        TEST(quad_facing_test, sorts_quads_by_facing_and_remembers_where_they_went) {
+            std::vector<int> vertices;
+            add_plant_quad(vertices, 4, 0, 4, 0);
+            add_block_top(vertices, 0, 0, 0, 1);
+            add_block_east(vertices, 0, 0, 0, 2);
+            add_block_top(vertices, 1, 0, 0, 3);
+            add_block_bottom(vertices, 0, 0, 0, 4);
+
+            std::vector<int> sorted;
+            std::vector<std::uint16_t> quad_slots;
+            auto ranges = sort_mc_quads_by_facing(vertices.data(), vertices.size() / MC_VERTEX_SIZE_INTS, sorted,
+                                                  quad_slots);
+
+            ASSERT_TRUE(ranges.is_sorted());
+            ASSERT_EQ(0u, ranges.first_quad[FACE_DOWN]);
+            ASSERT_EQ(1u, ranges.first_quad[FACE_UP]);
+            ASSERT_EQ(3u, ranges.first_quad[FACE_NORTH]);
+            ASSERT_EQ(3u, ranges.first_quad[FACE_EAST]);
+            ASSERT_EQ(4u, ranges.first_quad[FACING_ANY]);
+            ASSERT_EQ(5u, ranges.first_quad[NUM_FACING_RANGES]);
+
+            // The two tops stay in the order they came in
+            ASSERT_EQ(sorted.size(), vertices.size());
+            ASSERT_EQ(4, get_color(sorted, 0));
+            ASSERT_EQ(1, get_color(sorted, 1));
+            ASSERT_EQ(3, get_color(sorted, 2));
+            ASSERT_EQ(2, get_color(sorted, 3));
+            ASSERT_EQ(0, get_color(sorted, 4));
+
+            ASSERT_EQ(5u, quad_slots.size());
+            for(std::size_t quad = 0; quad < quad_slots.size(); quad++) {
+                ASSERT_EQ(get_color(vertices, quad), get_color(sorted, quad_slots[quad]));
+            }
+
+            ASSERT_FALSE(quad_facing_ranges{}.is_sorted());
+        }
+
+        TEST(quad_facing_test, skips_facings_the_camera_is_behind) {
+            auto bounds = aabb::from_min_max({0, 0, 0}, {16, 16, 16});
+            std::uint8_t all = (1 << NUM_FACING_RANGES) - 1;
+
+            ASSERT_EQ(all, get_visible_facings(bounds, {8, 8, 8}));
+
+            // Above the section, so nothing facing down can be seen
+            ASSERT_EQ(all & ~(1 << FACE_DOWN), get_visible_facings(bounds, {8, 20, 8}));
+
+            std::uint8_t below_to_the_west = get_visible_facings(bounds, {-4, -4, 8});
+            ASSERT_EQ(all & ~(1 << FACE_UP) & ~(1 << FACE_EAST), below_to_the_west);
+        }
+
+        TEST(quad_facing_test, joins_visible_ranges_into_runs) {
+            // Nothing faces north or south
+            quad_facing_ranges ranges = {{0, 2, 5, 5, 5, 7, 8, 10}};
+            quad_run runs[NUM_FACING_RANGES];
+            facing_cull_stats stats = {};
+
+            // Down and up are next to each other, and the empty ranges between up and west don't split anything
+            std::uint8_t visible = (1 << FACE_DOWN) | (1 << FACE_UP) | (1 << FACE_WEST) | (1 << FACING_ANY);
+            ASSERT_EQ(2u, get_visible_quad_runs(ranges, visible, runs, stats));
+            ASSERT_EQ(0u, runs[0].first_quad);
+            ASSERT_EQ(7u, runs[0].num_quads);
+            ASSERT_EQ(8u, runs[1].first_quad);
+            ASSERT_EQ(2u, runs[1].num_quads);
+
+            // Only east was skipped, since the empty ranges have nothing to skip
+            ASSERT_EQ(1u, stats.num_ranges_skipped);
+            ASSERT_EQ(1u, stats.num_quads_skipped);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*!
+ * \brief Tests for mapping a chunk section's quads onto the slots of its mesh
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../geometry_cache/quad_layout.h"
+
+namespace nova {
+    namespace test {
+        TEST(quad_layout_test, replaces_quads_in_place) {
+            quad_layout layout(4, 6);
+            ASSERT_EQ(4u, layout.get_num_slots_to_draw());
+
+            std::vector<quad_slot_write> writes;
+            ASSERT_TRUE(layout.splice(1, 2, 2, writes));
+
+            // Same number of quads, so they go right where the old ones were
+            ASSERT_EQ(2u, writes.size());
+            ASSERT_EQ(1u, writes[0].slot);
+            ASSERT_EQ(0, writes[0].source_quad);
+            ASSERT_EQ(2u, writes[1].slot);
+            ASSERT_EQ(1, writes[1].source_quad);
+            ASSERT_EQ(4u, layout.size());
+            ASSERT_EQ(4u, layout.get_num_slots_to_draw());
+        }
+
+        TEST(quad_layout_test, frees_and_reuses_slots) {
+            quad_layout layout(4, 6);
+
+            // Removing a quad leaves a degenerate hole in the middle
+            std::vector<quad_slot_write> writes;
+            ASSERT_TRUE(layout.splice(1, 1, 0, writes));
+            ASSERT_EQ(1u, writes.size());
+            ASSERT_EQ(1u, writes[0].slot);
+            ASSERT_EQ(-1, writes[0].source_quad);
+            ASSERT_EQ(3u, layout.size());
+            ASSERT_EQ(3u, layout.get_slot(2));
+            ASSERT_EQ(4u, layout.get_num_slots_to_draw());
+
+            // New quads fill the hole before anything past the end
+            writes.clear();
+            ASSERT_TRUE(layout.splice(3, 0, 2, writes));
+            ASSERT_EQ(2u, writes.size());
+            ASSERT_EQ(1u, writes[0].slot);
+            ASSERT_EQ(4u, writes[1].slot);
+            ASSERT_EQ(5u, layout.size());
+            ASSERT_EQ(5u, layout.get_num_slots_to_draw());
+        }
+
+        TEST(quad_layout_test, shrinks_the_draw_range) {
+            quad_layout layout(4, 4);
+
+            std::vector<quad_slot_write> writes;
+            ASSERT_TRUE(layout.splice(2, 2, 0, writes));
+            ASSERT_EQ(2u, layout.get_num_slots_to_draw());
+        }
+
+        TEST(quad_layout_test, refuses_splices_that_dont_fit) {
+            quad_layout layout(4, 5);
+
+            std::vector<quad_slot_write> writes;
+            ASSERT_FALSE(layout.splice(3, 2, 1, writes));
+            ASSERT_FALSE(layout.splice(0, 1, 3, writes));
+            ASSERT_TRUE(writes.empty());
+            ASSERT_EQ(4u, layout.size());
+
+            // Sections that can't be patched have no room at all
+            quad_layout unpatchable;
+            ASSERT_EQ(0u, unpatchable.get_capacity());
+            ASSERT_FALSE(unpatchable.splice(0, 0, 1, writes));
+        }
+
+        TEST(quad_layout_test, starts_from_moved_quads) {
+            quad_layout layout(std::vector<std::uint16_t>{2, 0, 1}, 5);
+            ASSERT_EQ(3u, layout.size());
+            ASSERT_EQ(5u, layout.get_capacity());
+            ASSERT_EQ(2u, layout.get_slot(0));
+            ASSERT_EQ(3u, layout.get_num_slots_to_draw());
+
+            // Replacing the first quad writes to the slot it was moved to
+            std::vector<quad_slot_write> writes;
+            ASSERT_TRUE(layout.splice(0, 1, 2, writes));
+            ASSERT_EQ(2u, writes.size());
+            ASSERT_EQ(2u, writes[0].slot);
+            ASSERT_EQ(0, writes[0].source_quad);
+            ASSERT_EQ(3u, writes[1].slot);
+            ASSERT_EQ(1, writes[1].source_quad);
+        }
+    }
+}
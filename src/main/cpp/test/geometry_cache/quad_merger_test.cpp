@@ -0,0 +1,130 @@
+/*!
+ * \brief Tests for merging coplanar block faces
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/quad_merger.h"
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    namespace test {
+        static int float_bits(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            return bits;
+        }
+
+        /*!
+         * \brief Adds the top face of the block at the given position, with the texture at (0.5, 0.25) in a 1024x1024
+         * atlas
+         */
+        static void add_block_top(std::vector<int>& vertices, float x, float y, float z, int color, float size = 1) {
+            const float corners[4][2] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+            const float tile = 16.0f / 1024;
+            for(const auto& corner : corners) {
+                vertices.push_back(float_bits(x + corner[0] * size));
+                vertices.push_back(float_bits(y + 1));
+                vertices.push_back(float_bits(z + corner[1] * size));
+                vertices.push_back(color);
+                vertices.push_back(float_bits(0.5f + corner[0] * tile));
+                vertices.push_back(float_bits(0.25f + corner[1] * tile));
+                vertices.push_back(0xF000F0);
+            }
+        }
+
+        static std::size_t num_vertices(const std::vector<int>& vertices) {
+            return vertices.size() / MC_VERTEX_SIZE_INTS;
+        }
+
+        static std::size_t num_compact_quads(const std::vector<int>& vertices) {
+            return vertices.size() / (4 * COMPACT_VERTEX_SIZE_INTS);
+        }
+
+        static float compact_position(const std::vector<int>& compact, std::size_t vertex, int axis) {
+            std::uint16_t position[3];
+            std::memcpy(position, &compact[vertex * COMPACT_VERTEX_SIZE_INTS], sizeof(position));
+            return position[axis] / COMPACT_POSITION_SCALE - COMPACT_POSITION_BIAS;
+        }
+
+        static void read_tile(const std::vector<int>& compact, std::size_t vertex, std::uint8_t tile[4]) {
+            std::memcpy(tile, &compact[vertex * COMPACT_VERTEX_SIZE_INTS + 5], 4);
+        }
+
+        TEST(quad_merger_test, merges_a_flat_square_into_one_quad) {
+            std::vector<int> vertices;
+            for(int z = 0; z < 4; z++) {
+                for(int x = 0; x < 4; x++) {
+                    add_block_top(vertices, x, 0, z, 0x11223344);
+                }
+            }
+
+            std::vector<int> compact;
+            auto stats = merge_coplanar_quads(vertices.data(), num_vertices(vertices), compact);
+            ASSERT_EQ(16u, stats.num_input_quads);
+            ASSERT_EQ(1u, stats.num_output_quads);
+            ASSERT_FLOAT_EQ(15.0f / 16.0f, stats.get_triangle_reduction());
+            ASSERT_EQ(1u, num_compact_quads(compact));
+
+            // The corners are in the same order as the source faces' corners, just four times as far apart
+            const float expected_corners[4][2] = {{0, 0}, {0, 4}, {4, 4}, {4, 0}};
+            for(std::size_t vertex = 0; vertex < 4; vertex++) {
+                ASSERT_FLOAT_EQ(expected_corners[vertex][0], compact_position(compact, vertex, 0));
+                ASSERT_FLOAT_EQ(1, compact_position(compact, vertex, 1));
+                ASSERT_FLOAT_EQ(expected_corners[vertex][1], compact_position(compact, vertex, 2));
+
+                // The texture repeats four times each way, and is 16/1024ths of the atlas, or 32/2048ths
+                std::uint8_t tile[4];
+                read_tile(compact, vertex, tile);
+                ASSERT_EQ(expected_corners[vertex][0], tile[0]);
+                ASSERT_EQ(expected_corners[vertex][1], tile[1]);
+                ASSERT_EQ(32, tile[2]);
+                ASSERT_EQ(32, tile[3]);
+            }
+        }
+
+        TEST(quad_merger_test, merges_greedily) {
+            // An L shape. The bottom row is merged, and the face sticking up is left on its own
+            std::vector<int> vertices;
+            add_block_top(vertices, 0, 0, 0, 1);
+            add_block_top(vertices, 1, 0, 0, 1);
+            add_block_top(vertices, 0, 0, 1, 1);
+
+            std::vector<int> compact;
+            auto stats = merge_coplanar_quads(vertices.data(), num_vertices(vertices), compact);
+            ASSERT_EQ(2u, stats.num_output_quads);
+            ASSERT_EQ(2u, num_compact_quads(compact));
+
+            // The face on its own isn't in repeat-UV mode
+            std::size_t repeated_quads = 0;
+            for(std::size_t quad = 0; quad < 2; quad++) {
+                std::uint8_t tile[4];
+                read_tile(compact, quad * 4, tile);
+                if(tile[2] != 0) {
+                    repeated_quads++;
+                }
+            }
+            ASSERT_EQ(1u, repeated_quads);
+        }
+
+        TEST(quad_merger_test, keeps_different_faces_apart) {
+            std::vector<int> vertices;
+            add_block_top(vertices, 0, 0, 0, 1);
+            add_block_top(vertices, 1, 0, 0, 2);      // Different color
+            add_block_top(vertices, 2, 1, 0, 1);      // Different height
+            add_block_top(vertices, 3, 0, 0, 1, 0.5f); // Not a whole face
+
+            std::vector<int> compact;
+            auto stats = merge_coplanar_quads(vertices.data(), num_vertices(vertices), compact);
+            ASSERT_EQ(4u, stats.num_output_quads);
+            ASSERT_EQ(0, stats.get_triangle_reduction());
+
+            // Nothing was merged, so it's the same as just packing the vertices
+            ASSERT_EQ(compact_mc_vertices(vertices.data(), vertices.size()).size(), compact.size());
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*!
+ * \brief Tests for working out which faces of a chunk section can see each other
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/section_connectivity.h"
+
+namespace nova {
+    namespace test {
+        static void set_opaque(std::vector<std::uint64_t>& opaque, int x, int y, int z, bool is_opaque) {
+            int block = x + z * 16 + y * 256;
+            if(is_opaque) {
+                opaque[block / 64] |= std::uint64_t(1) << (block % 64);
+            } else {
+                opaque[block / 64] &= ~(std::uint64_t(1) << (block % 64));
+            }
+        }
+
+        TEST(section_connectivity_test, empty_and_solid_sections) {
+            std::vector<std::uint64_t> opaque(SECTION_OPACITY_WORDS, 0);
+            ASSERT_EQ(ALL_FACES_CONNECTED, compute_section_connectivity(opaque.data()));
+
+            opaque.assign(SECTION_OPACITY_WORDS, ~std::uint64_t(0));
+            auto connectivity = compute_section_connectivity(opaque.data());
+            ASSERT_EQ(0, connectivity);
+
+            // A face can always see itself, even when nothing else can
+            ASSERT_TRUE(faces_connect(connectivity, FACE_EAST, FACE_EAST));
+            ASSERT_FALSE(faces_connect(connectivity, FACE_EAST, FACE_WEST));
+        }
+
+        TEST(section_connectivity_test, floor_separates_up_from_down) {
+            std::vector<std::uint64_t> opaque(SECTION_OPACITY_WORDS, 0);
+            for(int z = 0; z < 16; z++) {
+                for(int x = 0; x < 16; x++) {
+                    set_opaque(opaque, x, 8, z, true);
+                }
+            }
+
+            auto connectivity = compute_section_connectivity(opaque.data());
+            ASSERT_FALSE(faces_connect(connectivity, FACE_UP, FACE_DOWN));
+            ASSERT_FALSE(faces_connect(connectivity, FACE_DOWN, FACE_UP));
+            ASSERT_TRUE(faces_connect(connectivity, FACE_UP, FACE_NORTH));
+            ASSERT_TRUE(faces_connect(connectivity, FACE_DOWN, FACE_EAST));
+            ASSERT_TRUE(faces_connect(connectivity, FACE_NORTH, FACE_SOUTH));
+            ASSERT_TRUE(faces_connect(connectivity, FACE_WEST, FACE_EAST));
+
+            // One hole in the floor lets everything through
+            set_opaque(opaque, 3, 8, 12, false);
+            ASSERT_EQ(ALL_FACES_CONNECTED, compute_section_connectivity(opaque.data()));
+        }
+
+        TEST(section_connectivity_test, tunnel_only_connects_its_ends) {
+            std::vector<std::uint64_t> opaque(SECTION_OPACITY_WORDS, ~std::uint64_t(0));
+            for(int x = 0; x < 16; x++) {
+                set_opaque(opaque, x, 5, 5, false);
+            }
+
+            // A pocket of air inside the section doesn't touch any face, so it doesn't matter
+            set_opaque(opaque, 10, 10, 10, false);
+
+            auto connectivity = compute_section_connectivity(opaque.data());
+            for(int a = 0; a < NUM_SECTION_FACES; a++) {
+                for(int b = 0; b < NUM_SECTION_FACES; b++) {
+                    auto face_a = static_cast<section_face>(a);
+                    auto face_b = static_cast<section_face>(b);
+                    bool is_tunnel = (face_a == FACE_WEST || face_a == FACE_EAST) &&
+                                     (face_b == FACE_WEST || face_b == FACE_EAST);
+                    ASSERT_EQ(a == b || is_tunnel, faces_connect(connectivity, face_a, face_b)) << a << " " << b;
+                }
+            }
+        }
+
+        TEST(section_connectivity_test, opposite_faces) {
+            ASSERT_EQ(FACE_UP, get_opposite_face(FACE_DOWN));
+            ASSERT_EQ(FACE_NORTH, get_opposite_face(FACE_SOUTH));
+            ASSERT_EQ(FACE_WEST, get_opposite_face(FACE_EAST));
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*!
+ * \brief Tests for the functions that expand and pack Minecraft's vertex data
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include "../../geometry_cache/vertex_kernels.h"
+
+namespace nova {
+    namespace test {
+        TEST(vertex_kernels_test, expands_vertices_and_zeros_normals_and_tangents) {
+            const std::size_t num_vertices = 5;
+            std::vector<int> mc_data(num_vertices * MC_VERTEX_SIZE_INTS);
+            for(std::size_t i = 0; i < mc_data.size(); i++) {
+                mc_data[i] = static_cast<int>(i) + 1;
+            }
+
+            auto expanded = expand_mc_vertices(mc_data.data(), mc_data.size());
+            ASSERT_EQ(num_vertices * EXPANDED_VERTEX_SIZE_INTS, expanded.size());
+
+            for(std::size_t vertex = 0; vertex < num_vertices; vertex++) {
+                for(std::size_t i = 0; i < EXPANDED_VERTEX_SIZE_INTS; i++) {
+                    int expected = i < MC_VERTEX_SIZE_INTS ? mc_data[vertex * MC_VERTEX_SIZE_INTS + i] : 0;
+                    ASSERT_EQ(expected, expanded[vertex * EXPANDED_VERTEX_SIZE_INTS + i]);
+                }
+            }
+        }
+
+        TEST(vertex_kernels_test, ignores_partial_vertices) {
+            std::vector<int> mc_data(MC_VERTEX_SIZE_INTS + 3, 7);
+
+            auto expanded = expand_mc_vertices(mc_data.data(), mc_data.size());
+            ASSERT_EQ(EXPANDED_VERTEX_SIZE_INTS, expanded.size());
+        }
+
+        static int float_bits(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            return bits;
+        }
+
+        static int sign_extend_10(std::uint32_t value) {
+            return static_cast<int>(value << 22) >> 22;
+        }
+
+        TEST(vertex_kernels_test, compacts_a_quad) {
+            // A quad on the top of a block, wound so that its normal points up
+            const float positions[4][3] = {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1.5f, 1, 0.25f}};
+            std::vector<int> mc_data;
+            for(const auto& position : positions) {
+                mc_data.push_back(float_bits(position[0]));
+                mc_data.push_back(float_bits(position[1]));
+                mc_data.push_back(float_bits(position[2]));
+                mc_data.push_back(0x11223344);              // color
+                mc_data.push_back(float_bits(0.5f));        // u
+                mc_data.push_back(float_bits(1.0f));        // v
+                mc_data.push_back((240 << 16) | 32);        // sky light 240, block light 32
+            }
+
+            auto compacted = compact_mc_vertices(mc_data.data(), mc_data.size());
+            ASSERT_EQ(4 * COMPACT_VERTEX_SIZE_INTS, compacted.size());
+
+            for(std::size_t vertex = 0; vertex < 4; vertex++) {
+                std::uint8_t bytes[COMPACT_VERTEX_SIZE_INTS * sizeof(int)];
+                std::memcpy(bytes, &compacted[vertex * COMPACT_VERTEX_SIZE_INTS], sizeof(bytes));
+
+                std::uint16_t shorts[8];
+                std::memcpy(shorts, bytes, sizeof(shorts));
+
+                for(int i = 0; i < 3; i++) {
+                    float decoded = shorts[i] / COMPACT_POSITION_SCALE - COMPACT_POSITION_BIAS;
+                    EXPECT_FLOAT_EQ(positions[vertex][i], decoded);
+                }
+
+                EXPECT_EQ(32, bytes[6]);
+                EXPECT_EQ(240, bytes[7]);
+
+                int color;
+                std::memcpy(&color, &bytes[8], sizeof(int));
+                EXPECT_EQ(0x11223344, color);
+
+                EXPECT_NEAR(0.5f, shorts[6] / 65535.0f, 1.0f / 65535.0f);
+                EXPECT_EQ(65535, shorts[7]);
+
+                std::uint32_t normal;
+                std::memcpy(&normal, &bytes[16], sizeof(normal));
+                EXPECT_EQ(0, sign_extend_10(normal));
+                EXPECT_EQ(511, sign_extend_10(normal >> 10));
+                EXPECT_EQ(0, sign_extend_10(normal >> 20));
+            }
+        }
+
+        TEST(vertex_kernels_test, clamps_compact_positions) {
+            std::vector<int> mc_data(MC_VERTEX_SIZE_INTS, 0);
+            mc_data[0] = float_bits(-100);
+            mc_data[1] = float_bits(1000);
+
+            auto compacted = compact_mc_vertices(mc_data.data(), mc_data.size());
+
+            std::uint16_t shorts[3];
+            std::memcpy(shorts, compacted.data(), sizeof(shorts));
+            EXPECT_EQ(0, shorts[0]);
+            EXPECT_EQ(65535, shorts[1]);
+            EXPECT_EQ(COMPACT_POSITION_BIAS * COMPACT_POSITION_SCALE, shorts[2]);
+        }
+
+        TEST(vertex_kernels_test, recognizes_quad_lists) {
+            auto quad_indices = make_quad_indices(3);
+            std::vector<int> indices(quad_indices.begin(), quad_indices.end());
+            ASSERT_EQ(std::vector<int>({0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 8, 9, 10, 8, 10, 11}), indices);
+
+            EXPECT_TRUE(is_quad_list(indices.data(), indices.size(), 12));
+
+            // Extra vertices that no quad uses
+            EXPECT_FALSE(is_quad_list(indices.data(), indices.size(), 13));
+
+            // Not a whole number of quads
+            EXPECT_FALSE(is_quad_list(indices.data(), indices.size() - 3, 12));
+
+            // Different winding
+            std::swap(indices[7], indices[8]);
+            EXPECT_FALSE(is_quad_list(indices.data(), indices.size(), 12));
+
+            EXPECT_FALSE(is_quad_list(nullptr, 0, 0));
+        }
+
+        /*!
+         * \brief Adds a horizontal quad at the given height, one block wide
+         */
+        static void add_flat_quad(std::vector<int>& mc_data, float x, float y) {
+            const float corners[4][2] = {{0, 0}, {0, 1}, {1, 1}, {1, 0}};
+            for(const auto& corner : corners) {
+                mc_data.push_back(float_bits(x + corner[0]));
+                mc_data.push_back(float_bits(y));
+                mc_data.push_back(float_bits(corner[1]));
+                mc_data.push_back(0);
+                mc_data.push_back(0);
+                mc_data.push_back(0);
+                mc_data.push_back(0);
+            }
+        }
+
+        TEST(vertex_kernels_test, computes_bounds) {
+            std::vector<int> mc_data;
+            add_flat_quad(mc_data, 2, 3);
+            add_flat_quad(mc_data, 5, 9);
+
+            aabb bounds = {};
+            ASSERT_TRUE(compute_mc_vertex_bounds(mc_data.data(), 8, {100, 0, 200}, bounds));
+            ASSERT_EQ(glm::vec3(102, 3, 200), bounds.get_min());
+            ASSERT_EQ(glm::vec3(106, 9, 201), bounds.get_max());
+
+            ASSERT_FALSE(compute_mc_vertex_bounds(mc_data.data(), 0, {}, bounds));
+        }
+    }
+}
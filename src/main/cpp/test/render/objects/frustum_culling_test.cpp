@@ -0,0 +1,111 @@
+/*!
+ * \brief Tests for culling bounding boxes against a view frustum
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <random>
+#include <gtest/gtest.h>
+#include "../../../render/objects/frustum_culling.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief A frustum that's just the box from -10 to 10 on every axis, so it's easy to tell what's inside it
+         */
+        static const frustum_planes BOX_FRUSTUM = {
+                { 1,  0,  0, 10},
+                {-1,  0,  0, 10},
+                { 0,  1,  0, 10},
+                { 0, -1,  0, 10},
+                { 0,  0,  1, 10},
+                { 0,  0, -1, 10}
+        };
+
+        /*!
+         * \brief The old way of testing a box: it's outside if all eight of its corners are behind one plane
+         */
+        static bool is_any_corner_in_frustum(const frustum_planes& planes, const aabb& box) {
+            for(const auto& plane : planes) {
+                bool any_corner_in_front = false;
+                for(int corner = 0; corner < 8; corner++) {
+                    glm::vec3 offset((corner & 1) ? box.extents.x : -box.extents.x,
+                                     (corner & 2) ? box.extents.y : -box.extents.y,
+                                     (corner & 4) ? box.extents.z : -box.extents.z);
+                    glm::vec3 point = box.center + offset;
+                    if(plane[0] * point.x + plane[1] * point.y + plane[2] * point.z + plane[3] > 0) {
+                        any_corner_in_front = true;
+                        break;
+                    }
+                }
+
+                if(!any_corner_in_front) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        TEST(frustum_culling_test, tests_single_boxes) {
+            ASSERT_TRUE(is_aabb_in_frustum(BOX_FRUSTUM, {{0, 0, 0}, {1, 1, 1}}));
+            ASSERT_TRUE(is_aabb_in_frustum(BOX_FRUSTUM, {{12, 0, 0}, {4, 1, 1}}));
+            ASSERT_FALSE(is_aabb_in_frustum(BOX_FRUSTUM, {{12, 0, 0}, {1, 1, 1}}));
+            ASSERT_FALSE(is_aabb_in_frustum(BOX_FRUSTUM, {{0, -30, 0}, {8, 8, 8}}));
+
+            // Only touching the frustum doesn't count
+            ASSERT_FALSE(is_aabb_in_frustum(BOX_FRUSTUM, {{11, 0, 0}, {1, 1, 1}}));
+
+            ASSERT_EQ(INSIDE_FRUSTUM, test_aabb_against_frustum(BOX_FRUSTUM, {{0, 0, 0}, {1, 1, 1}}));
+            ASSERT_EQ(CROSSES_FRUSTUM, test_aabb_against_frustum(BOX_FRUSTUM, {{9, 0, 0}, {1, 1, 1}}));
+        }
+
+        TEST(frustum_culling_test, batches_match_single_boxes) {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> center(-20, 20);
+            std::uniform_real_distribution<float> extent(0, 6);
+
+            // Every count up to a few batches, so the leftovers after the last full batch are covered too
+            for(std::size_t num_boxes = 0; num_boxes < 20; num_boxes++) {
+                aabb_soa boxes;
+                for(std::size_t i = 0; i < num_boxes; i++) {
+                    boxes.push_back({{center(rng), center(rng), center(rng)}, {extent(rng), extent(rng), extent(rng)}});
+                }
+
+                std::vector<std::uint8_t> visible;
+                frustum_cull_stats stats = {};
+                cull_aabbs_against_frustum(BOX_FRUSTUM, boxes, visible, stats);
+
+                ASSERT_EQ(num_boxes, visible.size());
+                ASSERT_EQ(num_boxes, stats.num_tested);
+
+                std::size_t num_rejected = 0;
+                for(std::size_t i = 0; i < num_boxes; i++) {
+                    bool expected = is_any_corner_in_frustum(BOX_FRUSTUM, boxes.get(i));
+                    ASSERT_EQ(expected, visible[i] != 0) << "box " << i << " of " << num_boxes;
+                    ASSERT_EQ(test_aabb_against_frustum(BOX_FRUSTUM, boxes.get(i)), visible[i]);
+                    num_rejected += expected ? 0 : 1;
+                }
+                ASSERT_EQ(num_rejected, stats.num_rejected);
+            }
+        }
+
+        TEST(frustum_culling_test, swap_remove_moves_the_last_box) {
+            aabb_soa boxes;
+            boxes.push_back({{1, 0, 0}, {1, 1, 1}});
+            boxes.push_back({{2, 0, 0}, {1, 1, 1}});
+            boxes.push_back({{3, 0, 0}, {2, 2, 2}});
+
+            boxes.swap_remove(0);
+            ASSERT_EQ(2u, boxes.size());
+            ASSERT_EQ(glm::vec3(3, 0, 0), boxes.get(0).center);
+            ASSERT_EQ(glm::vec3(2, 2, 2), boxes.get(0).extents);
+            ASSERT_EQ(glm::vec3(2, 0, 0), boxes.get(1).center);
+
+            boxes.swap_remove(1);
+            ASSERT_EQ(1u, boxes.size());
+            ASSERT_EQ(glm::vec3(3, 0, 0), boxes.get(0).center);
+        }
+    }
+}
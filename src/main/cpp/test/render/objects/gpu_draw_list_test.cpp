@@ -0,0 +1,86 @@
+/*!
+ * \brief Tests for laying render_objects out for the GPU culling compute shader
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../render/objects/gpu_draw_list.h"
+
+namespace nova {
+    namespace test {
+        static draw_group_key make_key(std::uint32_t vertex_array, name_id color_texture) {
+            return {vertex_array, 0x1405, format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT, color_texture,
+                    NO_NAME, NO_NAME};
+        }
+
+        static aabb make_box() {
+            return aabb::from_min_max({0, 0, 0}, {16, 16, 16});
+        }
+
+        TEST(gpu_draw_list_test, writes_records_in_the_shader_layout) {
+            gpu_draw_list list;
+
+            gpu_draw_level levels[2] = {
+                    {600, 12, 400, make_key(1, 7)},
+                    {60, 0, -1, make_key(2, 7)}
+            };
+            list.add(make_box(), {32, 0, -16}, levels, 2);
+            list.finish();
+
+            ASSERT_EQ(1u, list.get_records().size());
+            const auto& record = list.get_records()[0];
+            ASSERT_FLOAT_EQ(8, record.center_and_num_lods[0]);
+            ASSERT_FLOAT_EQ(1, record.center_and_num_lods[3]);
+            ASSERT_FLOAT_EQ(8, record.extent[1]);
+            ASSERT_FLOAT_EQ(-16, record.position[2]);
+
+            ASSERT_EQ(600u, record.levels[0][0]);
+            ASSERT_EQ(12u, record.levels[0][1]);
+            ASSERT_EQ(400u, record.levels[0][2]);
+            ASSERT_EQ(0u, record.levels[0][3]);
+            ASSERT_EQ(-1, static_cast<std::int32_t>(record.levels[1][2]));
+            ASSERT_EQ(1u, record.levels[1][3]);
+
+            // Levels that don't exist have nothing to draw
+            ASSERT_EQ(0u, record.levels[2][0]);
+        }
+
+        TEST(gpu_draw_list_test, gives_each_group_a_slot_per_render_object) {
+            gpu_draw_list list;
+
+            // Both levels are in the same group, so the render_object only needs one slot there
+            gpu_draw_level same_page[2] = {
+                    {600, 0, 0, make_key(1, 7)},
+                    {60, 0, 100, make_key(1, 7)}
+            };
+            list.add(make_box(), {}, same_page, 2);
+
+            gpu_draw_level other_texture[1] = {{300, 0, 200, make_key(1, 8)}};
+            list.add(make_box(), {}, other_texture, 1);
+            list.add(make_box(), {}, same_page, 2);
+
+            // Nothing to draw at full detail, so no slot in the first group
+            gpu_draw_level empty_mesh[2] = {
+                    {0, 0, 0, make_key(1, 7)},
+                    {60, 0, 300, make_key(1, 8)}
+            };
+            list.add(make_box(), {}, empty_mesh, 2);
+            list.finish();
+
+            const auto& groups = list.get_groups();
+            ASSERT_EQ(2u, groups.size());
+            ASSERT_EQ(2u, groups[0].capacity);
+            ASSERT_EQ(0u, groups[0].first_command);
+            ASSERT_EQ(2u, groups[1].capacity);
+            ASSERT_EQ(2u, groups[1].first_command);
+            ASSERT_EQ(4u, list.get_num_commands());
+
+            list.clear();
+            ASSERT_TRUE(list.get_records().empty());
+            ASSERT_TRUE(list.get_groups().empty());
+            ASSERT_EQ(0u, list.get_num_commands());
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*!
+ * \brief Tests for gathering draws into multi-draw groups
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../render/objects/indirect_draw_list.h"
+
+namespace nova {
+    namespace test {
+        static draw_group_key make_key(std::uint32_t vertex_array, name_id color_texture) {
+            return {vertex_array, 0x1405, format::COMPACT_POS_COLOR_UV_LIGHTMAPUV_NORMAL_TANGENT, color_texture,
+                    NO_NAME, NO_NAME};
+        }
+
+        TEST(indirect_draw_list_test, groups_commands_and_keeps_their_order) {
+            indirect_draw_list list;
+            list.add({600, 0, 0, make_key(1, 7)}, {0, 0, 0});
+            list.add({300, 6, 400, make_key(2, 7)}, {16, 0, 0});
+            list.add({60, 12, 800, make_key(1, 7)}, {32, 0, 0});
+
+            // Nothing to draw, so it doesn't get a command
+            list.add({0, 0, 0, make_key(3, 7)}, {48, 0, 0});
+            list.finish();
+
+            const auto& groups = list.get_groups();
+            ASSERT_EQ(2u, groups.size());
+            ASSERT_EQ(0u, groups[0].first_command);
+            ASSERT_EQ(2u, groups[0].num_commands);
+            ASSERT_EQ(2u, groups[1].first_command);
+            ASSERT_EQ(1u, groups[1].num_commands);
+
+            const auto& commands = list.get_commands();
+            ASSERT_EQ(3u, commands.size());
+            ASSERT_EQ(600u, commands[0].count);
+            ASSERT_EQ(60u, commands[1].count);
+            ASSERT_EQ(12u, commands[1].first_index);
+            ASSERT_EQ(800, commands[1].base_vertex);
+            ASSERT_EQ(300u, commands[2].count);
+
+            // Each command reads its own position
+            const auto& positions = list.get_positions();
+            for(std::uint32_t i = 0; i < commands.size(); i++) {
+                ASSERT_EQ(1u, commands[i].instance_count);
+                ASSERT_EQ(i, commands[i].base_instance);
+            }
+            ASSERT_EQ(32, positions[1].x);
+            ASSERT_EQ(16, positions[2].x);
+
+            list.clear();
+            list.finish();
+            ASSERT_TRUE(list.get_groups().empty());
+            ASSERT_TRUE(list.get_commands().empty());
+        }
+    }
+}
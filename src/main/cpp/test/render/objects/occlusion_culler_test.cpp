@@ -0,0 +1,97 @@
+/*!
+ * \brief Tests for culling boxes that are hidden behind occluders
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../render/objects/occlusion_culler.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief A camera at the origin looking down -z with a 90 degree field of view, so a point's position on screen
+         * is just its x and y divided by how far away it is
+         */
+        static glm::mat4 make_view_projection() {
+            glm::mat4 view_projection(1.0f);
+            view_projection[2][3] = -1;
+            view_projection[3][3] = 0;
+            return view_projection;
+        }
+
+        static aabb make_box(const glm::vec3& min, const glm::vec3& max) {
+            return aabb::from_min_max(min, max);
+        }
+
+        TEST(occlusion_culler_test, hides_boxes_behind_a_wall) {
+            occlusion_culler culler(64, 32, 2);
+            culler.begin_frame(make_view_projection());
+
+            // A wall 10 blocks away that covers the middle half of the screen
+            culler.add_occluder(make_box({-5, -5, -10}, {5, 5, -10}));
+            culler.rasterize();
+            ASSERT_EQ(1u, culler.get_occluder_stats().num_occluders_drawn);
+            ASSERT_FLOAT_EQ(0.1f, culler.get_depth(32, 16));
+            ASSERT_EQ(0, culler.get_depth(2, 16));
+
+            aabb_soa boxes;
+            boxes.push_back(make_box({-1, -1, -22}, {1, 1, -20}));      // Right behind the wall
+            boxes.push_back(make_box({-1, -1, -6}, {1, 1, -4}));        // In front of the wall
+            boxes.push_back(make_box({15, -1, -22}, {17, 1, -20}));     // Behind, but off to the side of it
+            boxes.push_back(make_box({-1, -1, -12}, {1, 1, -8}));       // Poking through it
+            boxes.push_back(make_box({-1, -1, -30}, {1, 1, 1}));        // Reaching behind the camera
+
+            // The last box is hidden, but it's already been culled by something else so it's not tested
+            boxes.push_back(make_box({-1, -1, -22}, {1, 1, -20}));
+
+            std::vector<std::uint8_t> visible = {1, 1, 1, 1, 1, 0};
+            occlusion_cull_stats stats = {};
+            culler.cull(boxes, visible, stats);
+
+            ASSERT_EQ(std::vector<std::uint8_t>({0, 1, 1, 1, 1, 0}), visible);
+            ASSERT_EQ(5u, stats.num_tested);
+            ASSERT_EQ(1u, stats.num_occluded);
+        }
+
+        TEST(occlusion_culler_test, does_not_hide_a_section_behind_its_own_faces) {
+            occlusion_culler culler(64, 32, 2);
+            culler.begin_frame(make_view_projection());
+
+            // The front face of the box is its own occluder
+            auto section = make_box({-8, -8, -24}, {8, 8, -8});
+            culler.add_occluder(make_box({-8, -8, -8}, {8, 8, -8}));
+            culler.rasterize();
+
+            ASSERT_TRUE(culler.is_box_visible(section));
+        }
+
+        TEST(occlusion_culler_test, only_fills_pixels_an_occluder_covers_completely) {
+            occlusion_culler culler(64, 32, 1);
+            culler.begin_frame(make_view_projection());
+
+            // Covers pixel columns 32 to 40 on screen, plus part of pixel column 40
+            culler.add_occluder(make_box({0, -10, -10}, {2.6f, 10, -10}));
+            culler.rasterize();
+
+            ASSERT_EQ(0, culler.get_depth(31, 16));
+            ASSERT_FLOAT_EQ(0.1f, culler.get_depth(32, 16));
+            ASSERT_FLOAT_EQ(0.1f, culler.get_depth(39, 16));
+            ASSERT_EQ(0, culler.get_depth(40, 16));
+        }
+
+        TEST(occlusion_culler_test, skips_occluders_behind_the_camera) {
+            occlusion_culler culler(64, 32, 1);
+            culler.begin_frame(make_view_projection());
+
+            culler.add_occluder(make_box({-5, -5, 10}, {5, 5, 10}));
+            culler.add_occluder(make_box({-5, -5, -10}, {5, -5, 10}));
+            culler.rasterize();
+
+            auto stats = culler.get_occluder_stats();
+            ASSERT_EQ(2u, stats.num_occluders);
+            ASSERT_EQ(0u, stats.num_occluders_drawn);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*!
+ * \brief Tests for culling boxes by region
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <random>
+#include <gtest/gtest.h>
+#include "../../../render/objects/region_grid.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief The box from -10 to 100 on x and z, and -1000 to 1000 on y
+         */
+        static const frustum_planes NEAR_ORIGIN = {
+                { 1,  0,  0,   10},
+                {-1,  0,  0,  100},
+                { 0,  1,  0, 1000},
+                { 0, -1,  0, 1000},
+                { 0,  0,  1,   10},
+                { 0,  0, -1,  100}
+        };
+
+        static aabb make_section(float x, float y, float z) {
+            return {{x + 8, y + 8, z + 8}, {8, 8, 8}};
+        }
+
+        /*!
+         * \brief Checks that the grid culls exactly what testing every box on its own would
+         */
+        static void expect_same_as_flat_culling(region_grid& grid, const aabb_soa& boxes) {
+            std::vector<std::uint8_t> from_grid;
+            frustum_cull_stats grid_stats = {};
+            grid.cull(NEAR_ORIGIN, boxes, from_grid, grid_stats);
+
+            ASSERT_EQ(boxes.size(), from_grid.size());
+            std::size_t num_rejected = 0;
+            for(std::size_t i = 0; i < boxes.size(); i++) {
+                bool expected = is_aabb_in_frustum(NEAR_ORIGIN, boxes.get(i));
+                ASSERT_EQ(expected, from_grid[i] != 0) << "box " << i;
+                num_rejected += expected ? 0 : 1;
+            }
+            ASSERT_EQ(num_rejected, grid_stats.num_rejected);
+        }
+
+        TEST(region_grid_test, rejects_whole_regions) {
+            region_grid grid;
+            aabb_soa boxes;
+
+            // Four chunks' worth of sections near the origin, and four far away
+            for(int chunk = 0; chunk < 8; chunk++) {
+                float x = chunk < 4 ? chunk * 16.0f : 12800.0f + chunk * 16.0f;
+                for(int section = 0; section < 16; section++) {
+                    boxes.push_back(make_section(x, section * 16.0f, 16));
+                    grid.insert(boxes.size() - 1, boxes.get(boxes.size() - 1));
+                }
+            }
+            ASSERT_EQ(2u, grid.get_num_regions());
+
+            std::vector<std::uint8_t> visible;
+            frustum_cull_stats stats = {};
+            grid.cull(NEAR_ORIGIN, boxes, visible, stats);
+
+            // Both regions are tested, then nothing else since the near region is entirely in view
+            ASSERT_EQ(2u, stats.num_tested);
+            ASSERT_EQ(64u, stats.num_rejected);
+            ASSERT_EQ(64u, stats.num_rejected_by_region);
+            for(std::size_t i = 0; i < 64; i++) {
+                ASSERT_NE(0, visible[i]);
+                ASSERT_EQ(0, visible[i + 64]);
+            }
+        }
+
+        TEST(region_grid_test, stays_in_step_with_changes) {
+            std::mt19937 rng(4321);
+            std::uniform_int_distribution<int> chunk(-20, 20);
+            std::uniform_int_distribution<int> section(0, 15);
+
+            region_grid grid;
+            aabb_soa boxes;
+            for(int i = 0; i < 500; i++) {
+                boxes.push_back(make_section(chunk(rng) * 16.0f, section(rng) * 16.0f, chunk(rng) * 16.0f));
+                grid.insert(boxes.size() - 1, boxes.get(boxes.size() - 1));
+            }
+            expect_same_as_flat_culling(grid, boxes);
+
+            // Move some boxes, which changes the region of a lot of them
+            for(std::size_t i = 0; i < boxes.size(); i += 3) {
+                boxes.set(i, make_section(chunk(rng) * 16.0f, section(rng) * 16.0f, chunk(rng) * 16.0f));
+                grid.update(i, boxes.get(i));
+            }
+            expect_same_as_flat_culling(grid, boxes);
+
+            // Remove most of them, including some that were moved into the places of removed ones
+            std::uniform_int_distribution<std::size_t> any_box(0, 10000);
+            while(boxes.size() > 20) {
+                std::size_t index = any_box(rng) % boxes.size();
+                boxes.swap_remove(index);
+                grid.swap_remove(index);
+            }
+            expect_same_as_flat_culling(grid, boxes);
+
+            while(boxes.size() > 0) {
+                boxes.swap_remove(0);
+                grid.swap_remove(0);
+            }
+            ASSERT_EQ(0u, grid.get_num_regions());
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*!
+ * \brief Tests for the render_object bucket
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../../render/objects/render_object_bucket.h"
+
+namespace nova {
+    namespace test {
+        static render_object make_object(int parent_id, float x) {
+            render_object obj = {};
+            obj.parent_id = parent_id;
+            obj.name = "chunk";
+            obj.position = {x, 0, 0};
+            obj.bounding_box.center = {x + 8, 8, 8};
+            return obj;
+        }
+
+        TEST(render_object_bucket_test, keeps_hot_arrays_in_step) {
+            render_object_bucket bucket;
+            auto a = bucket.insert(make_object(1, 0));
+            auto b = bucket.insert(make_object(2, 16));
+            auto c = bucket.insert(make_object(3, 32));
+
+            ASSERT_TRUE(bucket.erase(a));
+            ASSERT_EQ(2u, bucket.size());
+            ASSERT_EQ(2u, bucket.get_positions().size());
+            ASSERT_EQ(2u, bucket.get_bounds().size());
+            ASSERT_EQ(2u, bucket.get_meshes().size());
+
+            for(std::size_t i = 0; i < bucket.size(); i++) {
+                ASSERT_EQ(bucket[i].position, bucket.get_positions()[i]);
+                ASSERT_EQ(bucket[i].bounding_box.center, bucket.get_bounds().get(i).center);
+            }
+
+            ASSERT_EQ(2, bucket.get(b)->parent_id);
+            ASSERT_EQ(3, bucket.get(c)->parent_id);
+            ASSERT_EQ("chunk", bucket.get(c)->name);
+            ASSERT_EQ(nullptr, bucket.get(a));
+            ASSERT_FALSE(bucket.erase(a));
+        }
+
+        TEST(render_object_bucket_test, replace_updates_hot_arrays) {
+            render_object_bucket bucket;
+            bucket.insert(make_object(1, 0));
+            auto b = bucket.insert(make_object(2, 16));
+
+            ASSERT_TRUE(bucket.replace(b, make_object(2, 48)));
+            std::size_t index = bucket.get(b) - &bucket[0];
+            ASSERT_EQ(48, bucket.get_positions()[index].x);
+            ASSERT_EQ(56, bucket.get_bounds().get(index).center.x);
+        }
+
+        TEST(render_object_bucket_test, replace_clamps_lod_level) {
+            render_object_bucket bucket;
+            auto a = bucket.insert(make_object(1, 0));
+            ASSERT_EQ(0u, bucket.get_lods()[0].num_levels);
+            ASSERT_EQ(0, bucket.get_lod_levels()[0]);
+
+            // The new render_object has no simplified meshes, so it can't stay at level 2
+            bucket.get_lod_levels()[0] = 2;
+            ASSERT_TRUE(bucket.replace(a, make_object(1, 0)));
+            ASSERT_EQ(0, bucket.get_lod_levels()[0]);
+        }
+
+        TEST(render_object_bucket_test, set_bounds_updates_hot_arrays) {
+            render_object_bucket bucket;
+            auto a = bucket.insert(make_object(1, 0));
+
+            ASSERT_TRUE(bucket.set_bounds(a, {{4, 2, 4}, {4, 2, 4}}));
+            ASSERT_EQ(glm::vec3(4, 2, 4), bucket.get(a)->bounding_box.center);
+            ASSERT_EQ(glm::vec3(4, 2, 4), bucket.get_bounds().get(0).extents);
+
+            ASSERT_TRUE(bucket.erase(a));
+            ASSERT_FALSE(bucket.set_bounds(a, {}));
+        }
+
+        TEST(render_object_bucket_test, version_changes_with_every_change) {
+            render_object_bucket bucket;
+            auto version = bucket.get_version();
+
+            auto a = bucket.insert(make_object(1, 0));
+            ASSERT_NE(version, bucket.get_version());
+            version = bucket.get_version();
+
+            ASSERT_TRUE(bucket.set_bounds(a, {{4, 2, 4}, {4, 2, 4}}));
+            ASSERT_NE(version, bucket.get_version());
+            version = bucket.get_version();
+
+            ASSERT_TRUE(bucket.replace(a, make_object(1, 16)));
+            ASSERT_NE(version, bucket.get_version());
+            version = bucket.get_version();
+
+            ASSERT_TRUE(bucket.erase(a));
+            ASSERT_NE(version, bucket.get_version());
+            version = bucket.get_version();
+
+            // Stale handles don't change anything
+            ASSERT_FALSE(bucket.erase(a));
+            ASSERT_EQ(version, bucket.get_version());
+        }
+
+        TEST(render_object_bucket_test, keeps_facing_ranges_in_step) {
+            render_object_bucket bucket;
+            auto a = make_object(1, 0);
+            a.facing_ranges = {{0, 2, 2, 2, 2, 2, 5, 6}};
+            auto a_handle = bucket.insert(std::move(a));
+            auto b_handle = bucket.insert(make_object(2, 16));
+
+            ASSERT_TRUE(bucket.get_facing_ranges()[0].is_sorted());
+            ASSERT_FALSE(bucket.get_facing_ranges()[1].is_sorted());
+
+            auto version = bucket.get_version();
+            ASSERT_TRUE(bucket.set_facing_ranges(a_handle, {}));
+            ASSERT_NE(version, bucket.get_version());
+            ASSERT_FALSE(bucket.get_facing_ranges()[0].is_sorted());
+            ASSERT_FALSE(bucket.get(a_handle)->facing_ranges.is_sorted());
+
+            // b moves into a's place
+            ASSERT_TRUE(bucket.set_facing_ranges(b_handle, {{0, 0, 1, 1, 1, 1, 1, 1}}));
+            ASSERT_TRUE(bucket.erase(a_handle));
+            ASSERT_EQ(1u, bucket.get_facing_ranges().size());
+            ASSERT_EQ(1u, bucket.get_facing_ranges()[0].first_quad[FACE_NORTH]);
+        }
+    }
+}
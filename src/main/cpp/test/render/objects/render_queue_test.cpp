@@ -0,0 +1,114 @@
+/*!
+ * \brief Tests for sorting a frame's draws by key
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+#include "../../../render/objects/render_queue.h"
+
+namespace nova {
+    namespace test {
+        static std::uint64_t make_key(render_pass pass, std::uint32_t shader, std::uint32_t depth) {
+            return make_sort_key(pass, shader, hash_texture_set(1, NO_NAME, NO_NAME), 0, depth);
+        }
+
+        TEST(render_queue_test, opaque_draws_front_to_back_and_translucent_draws_back_to_front) {
+            render_queue queue;
+            queue.add(make_key(render_pass::translucent, 0, 10), 0, 0, 0);
+            queue.add(make_key(render_pass::opaque, 1, 500), 1, 1, 0);
+            queue.add(make_key(render_pass::translucent, 1, 900), 2, 1, 0);
+            queue.add(make_key(render_pass::opaque, 1, 20), 3, 1, 0);
+            queue.add(make_key(render_pass::opaque, 0, 800), 4, 0, 0);
+            queue.sort();
+
+            const auto& entries = queue.get_entries();
+            ASSERT_EQ(5u, entries.size());
+
+            // Opaque draws are grouped by shader first, then go from near to far
+            ASSERT_EQ(4u, entries[0].object);
+            ASSERT_EQ(3u, entries[1].object);
+            ASSERT_EQ(1u, entries[2].object);
+
+            // Translucent draws go from far to near, whichever shader they use
+            ASSERT_EQ(2u, entries[3].object);
+            ASSERT_EQ(0u, entries[4].object);
+
+            ASSERT_EQ(0u, queue.find_pass_start(render_pass::opaque));
+            ASSERT_EQ(3u, queue.find_pass_start(render_pass::translucent));
+            ASSERT_EQ(render_pass::translucent, get_sort_key_pass(entries[3].key));
+        }
+
+        TEST(render_queue_test, groups_opaque_draws_by_state_before_depth) {
+            auto near_key = make_sort_key(render_pass::opaque, 0, 7, 2, 1);
+            auto far_key = make_sort_key(render_pass::opaque, 0, 7, 2, MAX_SORT_DEPTH);
+            auto other_page_key = make_sort_key(render_pass::opaque, 0, 7, 3, 0);
+            auto other_textures_key = make_sort_key(render_pass::opaque, 0, 8, 0, 0);
+            auto other_shader_key = make_sort_key(render_pass::opaque, 1, 0, 0, 0);
+
+            ASSERT_LT(near_key, far_key);
+            ASSERT_LT(far_key, other_page_key);
+            ASSERT_LT(other_page_key, other_textures_key);
+            ASSERT_LT(other_textures_key, other_shader_key);
+            ASSERT_LT(other_shader_key, make_sort_key(render_pass::translucent, 0, 0, 0, MAX_SORT_DEPTH));
+        }
+
+        TEST(render_queue_test, quantizes_depth_to_the_far_plane) {
+            ASSERT_EQ(0u, quantize_sort_depth(0, 1000));
+            ASSERT_EQ(0u, quantize_sort_depth(-5, 1000));
+            ASSERT_EQ(MAX_SORT_DEPTH, quantize_sort_depth(1000, 1000));
+            ASSERT_EQ(MAX_SORT_DEPTH, quantize_sort_depth(5000, 1000));
+            ASSERT_LT(quantize_sort_depth(10, 1000), quantize_sort_depth(11, 1000));
+        }
+
+        TEST(render_queue_test, sorts_like_a_stable_sort) {
+            std::mt19937_64 random(42);
+            std::vector<render_queue_entry> expected;
+
+            render_queue queue;
+            for(std::uint32_t i = 0; i < 5000; i++) {
+                // Only a few distinct keys, so that plenty of them are equal and the stability gets checked
+                auto key = random() % 64;
+                key = (key << 56) | (key & 3);
+                queue.add(key, i, 0, 0);
+                expected.push_back({key, i, 0, 0});
+            }
+            queue.sort();
+
+            std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+                return a.key < b.key;
+            });
+
+            const auto& entries = queue.get_entries();
+            ASSERT_EQ(expected.size(), entries.size());
+            for(std::size_t i = 0; i < entries.size(); i++) {
+                ASSERT_EQ(expected[i].key, entries[i].key);
+                ASSERT_EQ(expected[i].object, entries[i].object);
+            }
+
+            // Only the bytes that actually differ between keys get a pass
+            ASSERT_EQ(2u, queue.get_num_sort_passes());
+        }
+
+        TEST(render_queue_test, skips_sorting_keys_that_are_all_the_same) {
+            render_queue queue;
+            for(std::uint32_t i = 0; i < 10; i++) {
+                queue.add(make_key(render_pass::opaque, 3, 40), i, 3, 0);
+            }
+            queue.sort();
+
+            ASSERT_EQ(0u, queue.get_num_sort_passes());
+            for(std::uint32_t i = 0; i < 10; i++) {
+                ASSERT_EQ(i, queue.get_entries()[i].object);
+            }
+
+            queue.clear();
+            queue.sort();
+            ASSERT_TRUE(queue.get_entries().empty());
+            ASSERT_EQ(0u, queue.find_pass_start(render_pass::translucent));
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*!
+ * \brief Tests for finding the chunk sections that the camera can see through other sections
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "../../../render/objects/section_visibility.h"
+
+namespace nova {
+    namespace test {
+        /*!
+         * \brief A frustum big enough to hold the whole world
+         */
+        static const frustum_planes EVERYTHING = {
+                { 1,  0,  0, 100000},
+                {-1,  0,  0, 100000},
+                { 0,  1,  0, 100000},
+                { 0, -1,  0, 100000},
+                { 0,  0,  1, 100000},
+                { 0,  0, -1, 100000}
+        };
+
+        /*!
+         * \brief Makes every section at the given height solid, as far as the search can reach
+         */
+        static void add_solid_layer(section_visibility_graph& graph, int section_y) {
+            int distance = section_visibility_graph::MAX_TRAVERSAL_DISTANCE;
+            for(int z = -distance; z <= distance; z++) {
+                for(int x = -distance; x <= distance; x++) {
+                    graph.set_connectivity({x, section_y, z}, 0);
+                }
+            }
+        }
+
+        TEST(section_visibility_test, solid_ground_hides_caves) {
+            section_visibility_graph graph;
+            add_solid_layer(graph, 3);
+            graph.find_visible_sections({8, 72, 8}, EVERYTHING);
+
+            // The solid sections can be seen, but nothing can be seen through them
+            ASSERT_TRUE(graph.is_visible({8, 72, 8}));
+            ASSERT_TRUE(graph.is_visible({100, 200, -100}));
+            ASSERT_TRUE(graph.is_visible({8, 50, 8}));
+            ASSERT_FALSE(graph.is_visible({8, 40, 8}));
+            ASSERT_FALSE(graph.is_visible({-200, 10, 300}));
+
+            // Beyond the search, everything is visible
+            ASSERT_TRUE(graph.is_visible({16 * 40, 10, 8}));
+
+            aabb_soa boxes;
+            boxes.push_back({{8, 40, 8}, {8, 8, 8}});
+            boxes.push_back({{8, 72, 8}, {8, 8, 8}});
+            boxes.push_back({{8, 40, 40}, {8, 8, 8}});
+            std::vector<std::uint8_t> visible = {1, 1, 0};
+            section_visibility_stats stats = {};
+            graph.cull(boxes, visible, stats);
+
+            ASSERT_EQ(std::vector<std::uint8_t>({0, 1, 0}), visible);
+            ASSERT_EQ(1u, stats.num_culled);
+            ASSERT_EQ(65u * 65u, graph.get_stats().num_known_sections);
+        }
+
+        TEST(section_visibility_test, sees_down_a_shaft) {
+            section_visibility_graph graph;
+            add_solid_layer(graph, 3);
+
+            // A shaft straight down through the camera's column
+            graph.set_connectivity({0, 3, 0}, ALL_FACES_CONNECTED);
+
+            graph.find_visible_sections({8, 72, 8}, EVERYTHING);
+            ASSERT_TRUE(graph.is_visible({8, 40, 8}));
+
+            // So can the cave that the shaft leads into
+            ASSERT_TRUE(graph.is_visible({100, 40, 8}));
+        }
+
+        TEST(section_visibility_test, only_sees_along_a_tunnel) {
+            section_visibility_graph graph;
+            for(int y = 0; y < 16; y++) {
+                add_solid_layer(graph, y);
+            }
+
+            // A section that's solid apart from a tunnel that goes from west to east
+            std::vector<std::uint64_t> opaque(SECTION_OPACITY_WORDS, ~std::uint64_t(0));
+            for(int x = 0; x < 16; x++) {
+                int block = x + 5 * 16 + 5 * 256;
+                opaque[block / 64] &= ~(std::uint64_t(1) << (block % 64));
+            }
+            auto tunnel = compute_section_connectivity(opaque.data());
+
+            // The camera is in a cave that leads into the tunnel, which leads to another cave
+            graph.set_connectivity({0, 4, 0}, ALL_FACES_CONNECTED);
+            for(int x = 1; x <= 5; x++) {
+                graph.set_connectivity({x, 4, 0}, tunnel);
+            }
+            graph.set_connectivity({6, 4, 0}, ALL_FACES_CONNECTED);
+
+            graph.find_visible_sections({8, 72, 8}, EVERYTHING);
+
+            // The camera's cave can see the walls around it, but not past them
+            ASSERT_TRUE(graph.is_visible({8, 72, 24}));
+            ASSERT_FALSE(graph.is_visible({8, 72, 40}));
+
+            // The whole tunnel, the cave at the end and its walls can be seen, but not what's beside the tunnel
+            ASSERT_TRUE(graph.is_visible({88, 72, 8}));
+            ASSERT_TRUE(graph.is_visible({104, 72, 8}));
+            ASSERT_TRUE(graph.is_visible({120, 72, 8}));
+            ASSERT_TRUE(graph.is_visible({104, 72, 24}));
+            ASSERT_FALSE(graph.is_visible({88, 72, 24}));
+            ASSERT_FALSE(graph.is_visible({136, 72, 8}));
+        }
+
+        TEST(section_visibility_test, frustum_stops_the_search) {
+            section_visibility_graph graph;
+
+            // Only what's east of the camera
+            frustum_planes east = {
+                    { 1, 0, 0, 0},
+                    {-1, 0, 0, 100000},
+                    { 0, 1, 0, 100000},
+                    { 0, -1, 0, 100000},
+                    { 0, 0, 1, 100000},
+                    { 0, 0, -1, 100000}
+            };
+            graph.find_visible_sections({8, 72, 8}, east);
+
+            ASSERT_TRUE(graph.is_visible({40, 72, 8}));
+            ASSERT_FALSE(graph.is_visible({-40, 72, 8}));
+        }
+
+        TEST(section_visibility_test, everything_is_visible_from_outside_the_world) {
+            section_visibility_graph graph;
+            add_solid_layer(graph, 3);
+            graph.find_visible_sections({8, 300, 8}, EVERYTHING);
+
+            ASSERT_TRUE(graph.is_visible({8, 40, 8}));
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/*!
+ * \brief Tests for the hash functions
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "../../utils/hashing.h"
+
+namespace nova {
+    namespace test {
+        TEST(hashing_test, equal_data_hashes_equal) {
+            std::vector<int> a = {1, 2, 3, 4, 5};
+            std::vector<int> b = a;
+            ASSERT_EQ(hash_bytes(a.data(), a.size() * sizeof(int)), hash_bytes(b.data(), b.size() * sizeof(int)));
+        }
+
+        TEST(hashing_test, small_changes_change_the_hash) {
+            std::vector<int> data(1000, 7);
+            auto original = hash_bytes(data.data(), data.size() * sizeof(int));
+
+            // Change one int in the middle, and one in the tail that doesn't fill a whole word
+            data[500] = 8;
+            ASSERT_NE(original, hash_bytes(data.data(), data.size() * sizeof(int)));
+            data[500] = 7;
+
+            ASSERT_NE(hash_bytes(data.data(), 5 * sizeof(int)), hash_bytes(data.data(), 4 * sizeof(int)));
+            ASSERT_NE(original, hash_bytes(data.data(), data.size() * sizeof(int), 1));
+        }
+    }
+}
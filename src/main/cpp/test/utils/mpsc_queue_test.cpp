@@ -0,0 +1,81 @@
+/*!
+ * \brief Tests for the lock-free queue that chunk parts wait in
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <algorithm>
+#include "../../utils/mpsc_queue.h"
+
+namespace nova {
+    namespace test {
+        TEST(mpsc_queue_test, pops_in_push_order) {
+            mpsc_queue<int> queue;
+            queue.push(1);
+            queue.push(2);
+            queue.push(3);
+
+            int value = 0;
+            ASSERT_TRUE(queue.try_pop(value));
+            ASSERT_EQ(1, value);
+            ASSERT_TRUE(queue.try_pop(value));
+            ASSERT_EQ(2, value);
+            ASSERT_TRUE(queue.try_pop(value));
+            ASSERT_EQ(3, value);
+            ASSERT_FALSE(queue.try_pop(value));
+            ASSERT_TRUE(queue.empty());
+        }
+
+        TEST(mpsc_queue_test, pop_batch_respects_limit) {
+            mpsc_queue<int> queue;
+            for(int i = 0; i < 10; i++) {
+                queue.push(i);
+            }
+
+            std::vector<int> batch;
+            ASSERT_EQ(4u, queue.pop_batch(batch, 4));
+            ASSERT_EQ(4u, batch.size());
+            ASSERT_EQ(6u, queue.pop_batch(batch, 100));
+            ASSERT_EQ(10u, batch.size());
+
+            auto stats = queue.get_stats();
+            ASSERT_EQ(10, stats.num_pushed);
+            ASSERT_EQ(10, stats.num_popped);
+            ASSERT_EQ(0, stats.depth);
+            ASSERT_EQ(10, stats.max_depth);
+        }
+
+        TEST(mpsc_queue_test, many_producers_lose_nothing) {
+            const int num_producers = 4;
+            const int items_per_producer = 10000;
+
+            mpsc_queue<int> queue;
+            std::vector<std::thread> producers;
+            for(int p = 0; p < num_producers; p++) {
+                producers.emplace_back([&queue, p, items_per_producer]() {
+                    for(int i = 0; i < items_per_producer; i++) {
+                        queue.push(p * items_per_producer + i);
+                    }
+                });
+            }
+
+            std::vector<int> received;
+            while(received.size() < num_producers * items_per_producer) {
+                queue.pop_batch(received, 64);
+            }
+
+            for(auto& producer : producers) {
+                producer.join();
+            }
+
+            std::sort(received.begin(), received.end());
+            for(int i = 0; i < num_producers * items_per_producer; i++) {
+                ASSERT_EQ(i, received[i]);
+            }
+            ASSERT_TRUE(queue.empty());
+        }
+    }
+}
@@ -0,0 +1,29 @@
+/*!
+ * \brief Tests for the name table
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../utils/name_table.h"
+
+namespace nova {
+    namespace test {
+        TEST(name_table_test, same_name_gets_same_id) {
+            auto terrain = intern_name("name_table_test_terrain");
+            auto water = intern_name("name_table_test_water");
+
+            ASSERT_NE(terrain, water);
+            ASSERT_EQ(terrain, intern_name("name_table_test_terrain"));
+            ASSERT_EQ("name_table_test_water", get_interned_name(water));
+
+            ASSERT_LT(terrain, get_num_interned_names());
+            ASSERT_LT(water, get_num_interned_names());
+        }
+
+        TEST(name_table_test, unknown_ids_have_no_name) {
+            ASSERT_EQ("", get_interned_name(NO_NAME));
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*!
+ * \brief Tests for the range allocator
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include "../../utils/range_allocator.h"
+
+namespace nova {
+    namespace test {
+        TEST(range_allocator_test, allocates_first_fit) {
+            range_allocator allocator(100);
+
+            ASSERT_EQ(0, allocator.allocate(10));
+            ASSERT_EQ(10, allocator.allocate(20));
+            ASSERT_EQ(30, allocator.allocate(70));
+            ASSERT_EQ(-1, allocator.allocate(1));
+
+            allocator.free(10);
+            ASSERT_EQ(-1, allocator.allocate(21));
+            ASSERT_EQ(10, allocator.allocate(5));
+            ASSERT_EQ(15, allocator.allocate(15));
+        }
+
+        TEST(range_allocator_test, merges_neighboring_free_ranges) {
+            range_allocator allocator(40);
+            allocator.allocate(10);
+            allocator.allocate(10);
+            allocator.allocate(10);
+            allocator.allocate(10);
+
+            allocator.free(0);
+            allocator.free(20);
+            ASSERT_EQ(2u, allocator.get_stats().num_free_ranges);
+
+            // Freeing the middle joins everything before the last allocation into one range
+            allocator.free(10);
+            auto stats = allocator.get_stats();
+            ASSERT_EQ(1u, stats.num_free_ranges);
+            ASSERT_EQ(30u, stats.largest_free_range);
+            ASSERT_FLOAT_EQ(0.0f, stats.fragmentation);
+
+            allocator.free(30);
+            ASSERT_EQ(0, allocator.allocate(40));
+        }
+
+        TEST(range_allocator_test, reports_fragmentation) {
+            range_allocator allocator(40);
+            for(int i = 0; i < 4; i++) {
+                allocator.allocate(10);
+            }
+            allocator.free(0);
+            allocator.free(20);
+
+            auto stats = allocator.get_stats();
+            ASSERT_EQ(40u, stats.capacity);
+            ASSERT_EQ(20u, stats.num_allocated);
+            ASSERT_EQ(2u, stats.num_allocations);
+            ASSERT_EQ(10u, stats.largest_free_range);
+            ASSERT_FLOAT_EQ(0.5f, stats.fragmentation);
+
+            ASSERT_EQ(0, allocator.find_free_range(10));
+            ASSERT_EQ(-1, allocator.find_free_range(11));
+        }
+
+        TEST(range_allocator_test, rejects_unknown_offsets) {
+            range_allocator allocator(10);
+            allocator.allocate(5);
+            ASSERT_THROW(allocator.free(3), std::invalid_argument);
+            ASSERT_THROW(allocator.allocate(0), std::invalid_argument);
+        }
+    }
+}
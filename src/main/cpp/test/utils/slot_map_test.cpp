@@ -0,0 +1,63 @@
+/*!
+ * \brief Tests for the slot map
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "../../utils/slot_map.h"
+
+namespace nova {
+    namespace test {
+        TEST(slot_map_test, handles_survive_other_erases) {
+            slot_map<std::string> map;
+            auto a = map.insert("a");
+            auto b = map.insert("b");
+            auto c = map.insert("c");
+
+            // Erasing the first value moves the last one into its place
+            ASSERT_TRUE(map.erase(a));
+            ASSERT_EQ(2u, map.size());
+            ASSERT_EQ("c", map[0]);
+
+            ASSERT_EQ("b", *map.get(b));
+            ASSERT_EQ("c", *map.get(c));
+            ASSERT_EQ(c, map.get_handle(0));
+        }
+
+        TEST(slot_map_test, detects_stale_handles) {
+            slot_map<std::string> map;
+            auto a = map.insert("a");
+            ASSERT_TRUE(map.erase(a));
+
+            // The new value reuses a's slot, but a's handle must not see it
+            auto b = map.insert("b");
+            ASSERT_EQ(a.index, b.index);
+            ASSERT_FALSE(map.contains(a));
+            ASSERT_EQ(nullptr, map.get(a));
+            ASSERT_FALSE(map.erase(a));
+            ASSERT_EQ("b", *map.get(b));
+
+            ASSERT_FALSE(map.contains(slot_handle()));
+        }
+
+        TEST(slot_map_test, iterates_over_values) {
+            slot_map<int> map;
+            std::vector<slot_handle> handles;
+            for(int i = 0; i < 10; i++) {
+                handles.push_back(map.insert(int(i)));
+            }
+            for(int i = 0; i < 10; i += 2) {
+                map.erase(handles[i]);
+            }
+
+            int sum = 0;
+            for(int value : map) {
+                sum += value;
+            }
+            ASSERT_EQ(1 + 3 + 5 + 7 + 9, sum);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*!
+ * \brief Tests for the worker pool
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include "../../utils/worker_pool.h"
+
+namespace nova {
+    namespace test {
+        TEST(worker_pool_test, runs_every_task) {
+            std::atomic<int> num_run{0};
+            {
+                worker_pool pool(4);
+                for(int i = 0; i < 1000; i++) {
+                    pool.submit([&num_run]() { num_run++; });
+                }
+                pool.wait_idle();
+                ASSERT_EQ(1000, num_run.load());
+            }
+        }
+
+        TEST(worker_pool_test, tasks_with_the_same_key_run_in_order) {
+            std::vector<int> order;
+            worker_pool pool(4);
+            for(int i = 0; i < 1000; i++) {
+                pool.submit(7, [&order, i]() { order.push_back(i); });
+            }
+            pool.wait_idle();
+
+            ASSERT_EQ(1000u, order.size());
+            for(int i = 0; i < 1000; i++) {
+                ASSERT_EQ(i, order[i]);
+            }
+        }
+
+        TEST(worker_pool_test, barriers_wait_for_every_worker) {
+            std::atomic<int> num_before{0};
+            std::atomic<int> num_after{0};
+            int num_before_at_barrier = -1;
+            int num_after_at_barrier = -1;
+
+            worker_pool pool(4);
+            for(std::size_t i = 0; i < 100; i++) {
+                pool.submit(i, [&num_before]() { num_before++; });
+            }
+            pool.submit_barrier([&]() {
+                num_before_at_barrier = num_before.load();
+                num_after_at_barrier = num_after.load();
+            });
+            for(std::size_t i = 0; i < 100; i++) {
+                pool.submit(i, [&num_after]() { num_after++; });
+            }
+            pool.wait_idle();
+
+            ASSERT_EQ(100, num_before_at_barrier);
+            ASSERT_EQ(0, num_after_at_barrier);
+            ASSERT_EQ(100, num_after.load());
+        }
+    }
+}
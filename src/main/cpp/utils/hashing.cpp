@@ -0,0 +1,53 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <cstring>
+#include "hashing.h"
+
+namespace nova {
+    static const std::uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+    static const std::uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+
+    static std::uint64_t rotate_left(std::uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static std::uint64_t mix(std::uint64_t hash, std::uint64_t word) {
+        hash ^= rotate_left(word * prime_2, 31) * prime_1;
+        return rotate_left(hash, 27) * prime_1 + prime_2;
+    }
+
+    /*!
+     * \brief Makes sure every input bit affects every output bit. From MurmurHash3
+     */
+    static std::uint64_t finalize(std::uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    std::uint64_t hash_bytes(const void* data, std::size_t num_bytes, std::uint64_t seed) {
+        auto* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t hash = seed + prime_2 + num_bytes;
+
+        std::size_t i = 0;
+        for(; i + sizeof(std::uint64_t) <= num_bytes; i += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = mix(hash, word);
+        }
+
+        if(i < num_bytes) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes + i, num_bytes - i);
+            hash = mix(hash, word);
+        }
+
+        return finalize(hash);
+    }
+}
@@ -0,0 +1,29 @@
+/*!
+ * \brief Fast non-cryptographic hashing for big blocks of data
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_HASHING_H
+#define RENDERER_HASHING_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nova {
+    /*!
+     * \brief Hashes a block of memory into 64 bits
+     *
+     * Reads eight bytes at a time and mixes them with multiplies and shifts, so it's limited by memory bandwidth
+     * rather than by the hash itself. Not suitable for anything where someone might craft collisions on purpose
+     *
+     * \param data The bytes to hash
+     * \param num_bytes How many bytes to hash
+     * \param seed Hashing more data into an existing hash can be done by passing the existing hash as the seed
+     * \return The hash of the data
+     */
+    std::uint64_t hash_bytes(const void* data, std::size_t num_bytes, std::uint64_t seed = 0);
+}
+
+#endif //RENDERER_HASHING_H
@@ -0,0 +1,93 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nova {
+#if defined(_WIN32)
+    mapped_file::mapped_file(const std::string& path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        file_handle = file;
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            return;
+        }
+
+        mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping_handle == nullptr) {
+            return;
+        }
+
+        mapped_data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if(mapped_data != nullptr) {
+            mapped_size = static_cast<std::size_t>(file_size.QuadPart);
+        }
+    }
+
+    mapped_file::~mapped_file() {
+        if(mapped_data != nullptr) {
+            UnmapViewOfFile(mapped_data);
+        }
+        if(mapping_handle != nullptr) {
+            CloseHandle(mapping_handle);
+        }
+        if(file_handle != nullptr) {
+            CloseHandle(file_handle);
+        }
+    }
+
+#else
+    mapped_file::mapped_file(const std::string& path) {
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0) {
+            return;
+        }
+
+        struct stat file_info;
+        if(fstat(file, &file_info) == 0 && file_info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if(mapping != MAP_FAILED) {
+                mapped_data = static_cast<const std::uint8_t*>(mapping);
+                mapped_size = static_cast<std::size_t>(file_info.st_size);
+            }
+        }
+
+        // The mapping keeps the file alive on its own
+        close(file);
+    }
+
+    mapped_file::~mapped_file() {
+        if(mapped_data != nullptr) {
+            munmap(const_cast<std::uint8_t*>(mapped_data), mapped_size);
+        }
+    }
+#endif
+
+    bool mapped_file::is_open() const {
+        return mapped_data != nullptr;
+    }
+
+    const std::uint8_t* mapped_file::data() const {
+        return mapped_data;
+    }
+
+    std::size_t mapped_file::size() const {
+        return mapped_size;
+    }
+}
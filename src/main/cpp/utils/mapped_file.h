@@ -0,0 +1,52 @@
+/*!
+ * \brief Read-only memory mapping of a whole file
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_MAPPED_FILE_H
+#define RENDERER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nova {
+    /*!
+     * \brief Maps a file into memory so it can be read without copying it into a buffer first
+     *
+     * The operating system pages the file in as it's read, so only the parts that are actually touched cost anything.
+     * The mapping is read-only and goes away when the mapped_file is destroyed
+     */
+    class mapped_file {
+    public:
+        /*!
+         * \brief Maps the file at the given path. If the file can't be opened or is empty, nothing is mapped and
+         * is_open returns false
+         */
+        explicit mapped_file(const std::string& path);
+
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        bool is_open() const;
+
+        const std::uint8_t* data() const;
+
+        std::size_t size() const;
+
+    private:
+        const std::uint8_t* mapped_data = nullptr;
+        std::size_t mapped_size = 0;
+
+#if defined(_WIN32)
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#endif
+    };
+}
+
+#endif //RENDERER_MAPPED_FILE_H
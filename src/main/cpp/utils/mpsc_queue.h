@@ -0,0 +1,161 @@
+/*!
+ * \brief A lock-free queue that many threads can push into and one thread can pop from
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_MPSC_QUEUE_H
+#define RENDERER_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Counters that describe how a mpsc_queue has been used
+     *
+     * All the values are snapshots, so they might be slightly out of date by the time you read them
+     */
+    struct mpsc_queue_stats {
+        long num_pushed;        //!< How many items have been pushed since the queue was created
+        long num_popped;        //!< How many items have been popped since the queue was created
+        long depth;             //!< How many items are in the queue right now
+        long max_depth;         //!< The largest number of items that the queue has held at once
+        long consumer_stalls;   //!< How many times the consumer found an item that a producer had not finished pushing
+    };
+
+    /*!
+     * \brief A multi-producer, single-consumer queue
+     *
+     * This is Dmitry Vyukov's intrusive MPSC node queue. Pushing is a single atomic exchange, so producers never wait
+     * on each other or on the consumer. Only one thread may pop from the queue at a time.
+     *
+     * The one place where producers and the consumer can collide is the short window between a producer swapping
+     * itself in as the head and linking the previous head to its node. If the consumer sees that window it reports the
+     * queue as empty for now and counts a stall, so the stall counter is a direct measure of contention.
+     *
+     * \tparam T The type of thing to hold. Must be default-constructible and movable
+     */
+    template <typename T>
+    class mpsc_queue {
+    public:
+        mpsc_queue() : head(new node), tail(head.load(std::memory_order_relaxed)) {}
+
+        ~mpsc_queue() {
+            T item;
+            while(try_pop(item)) {}
+            delete tail;
+        }
+
+        mpsc_queue(const mpsc_queue&) = delete;
+        mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+        /*!
+         * \brief Adds an item to the back of the queue. Safe to call from any number of threads
+         *
+         * \param value The item to add
+         */
+        void push(T value) {
+            auto* new_node = new node(std::move(value));
+
+            // Count the item before it's linked in, so the consumer can never pop it first and take depth below zero
+            num_pushed.fetch_add(1, std::memory_order_relaxed);
+            long cur_depth = depth.fetch_add(1, std::memory_order_relaxed) + 1;
+            long cur_max = max_depth.load(std::memory_order_relaxed);
+            while(cur_depth > cur_max && !max_depth.compare_exchange_weak(cur_max, cur_depth, std::memory_order_relaxed)) {}
+
+            node* prev_head = head.exchange(new_node, std::memory_order_acq_rel);
+            prev_head->next.store(new_node, std::memory_order_release);
+        }
+
+        /*!
+         * \brief Removes the item at the front of the queue. May only be called from the consumer thread
+         *
+         * \param out Where to put the item
+         * \return True if an item was popped, false if the queue was empty
+         */
+        bool try_pop(T& out) {
+            node* next = tail->next.load(std::memory_order_acquire);
+            if(next == nullptr) {
+                if(head.load(std::memory_order_acquire) != tail) {
+                    // A producer has claimed the head but not linked it in yet
+                    consumer_stalls.fetch_add(1, std::memory_order_relaxed);
+                }
+                return false;
+            }
+
+            out = std::move(next->value);
+            delete tail;
+            tail = next;
+
+            num_popped.fetch_add(1, std::memory_order_relaxed);
+            depth.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /*!
+         * \brief Pops up to max_items items into the back of the given vector. May only be called from the consumer
+         * thread
+         *
+         * \param out The vector to append the popped items to
+         * \param max_items The most items to pop
+         * \return The number of items that were popped
+         */
+        std::size_t pop_batch(std::vector<T>& out, std::size_t max_items) {
+            std::size_t num_items = 0;
+            T item;
+            while(num_items < max_items && try_pop(item)) {
+                out.push_back(std::move(item));
+                num_items++;
+            }
+
+            return num_items;
+        }
+
+        /*!
+         * \brief Checks if there's anything ready to pop. Only meaningful on the consumer thread
+         */
+        bool empty() const {
+            return tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+        mpsc_queue_stats get_stats() const {
+            return {
+                    num_pushed.load(std::memory_order_relaxed),
+                    num_popped.load(std::memory_order_relaxed),
+                    depth.load(std::memory_order_relaxed),
+                    max_depth.load(std::memory_order_relaxed),
+                    consumer_stalls.load(std::memory_order_relaxed)
+            };
+        }
+
+    private:
+        struct node {
+            std::atomic<node*> next;
+            T value;
+
+            node() : next(nullptr) {}
+            explicit node(T&& value) : next(nullptr), value(std::move(value)) {}
+        };
+
+        /*!
+         * \brief The most recently pushed node. Producers race on this one
+         */
+        std::atomic<node*> head;
+
+        /*!
+         * \brief The node before the next one to pop. Only the consumer touches this
+         */
+        node* tail;
+
+        std::atomic<long> num_pushed{0};
+        std::atomic<long> num_popped{0};
+        std::atomic<long> depth{0};
+        std::atomic<long> max_depth{0};
+        std::atomic<long> consumer_stalls{0};
+    };
+}
+
+#endif //RENDERER_MPSC_QUEUE_H
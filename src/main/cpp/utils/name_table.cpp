@@ -0,0 +1,57 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "name_table.h"
+
+namespace nova {
+    struct name_table {
+        std::mutex lock;
+        std::unordered_map<std::string, name_id> ids;
+        std::deque<std::string> names;
+    };
+
+    static name_table& get_name_table() {
+        // Function-local so that it's ready before any static initializer interns a name
+        static name_table table;
+        return table;
+    }
+
+    name_id intern_name(const std::string& name) {
+        auto& table = get_name_table();
+        std::lock_guard<std::mutex> lock_guard(table.lock);
+
+        auto id_itr = table.ids.find(name);
+        if(id_itr != table.ids.end()) {
+            return id_itr->second;
+        }
+
+        auto id = static_cast<name_id>(table.names.size());
+        table.names.push_back(name);
+        table.ids.emplace(name, id);
+
+        return id;
+    }
+
+    std::string get_interned_name(name_id id) {
+        auto& table = get_name_table();
+        std::lock_guard<std::mutex> lock_guard(table.lock);
+
+        if(id >= table.names.size()) {
+            return "";
+        }
+
+        return table.names[id];
+    }
+
+    std::size_t get_num_interned_names() {
+        auto& table = get_name_table();
+        std::lock_guard<std::mutex> lock_guard(table.lock);
+
+        return table.names.size();
+    }
+}
@@ -0,0 +1,45 @@
+/*!
+ * \brief Turns the names of things like shaders, filters and textures into small integers
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_NAME_TABLE_H
+#define RENDERER_NAME_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace nova {
+    /*!
+     * \brief The interned form of a name. IDs are handed out densely starting from zero, so they can index arrays
+     */
+    using name_id = std::uint32_t;
+
+    /*!
+     * \brief Stands in for a name that isn't there, like an object without a normal map
+     */
+    const name_id NO_NAME = UINT32_MAX;
+
+    /*!
+     * \brief Returns the ID of the given name, giving it a new ID if it's never been interned before
+     *
+     * The same name always gets the same ID for the life of the program. Safe to call from any thread, but takes a
+     * lock, so intern names when they come in rather than every frame
+     */
+    name_id intern_name(const std::string& name);
+
+    /*!
+     * \brief Returns the name that the given ID was interned from. Safe to call from any thread
+     */
+    std::string get_interned_name(name_id id);
+
+    /*!
+     * \brief Returns how many names have been interned so far. Every ID is less than this
+     */
+    std::size_t get_num_interned_names();
+}
+
+#endif //RENDERER_NAME_TABLE_H
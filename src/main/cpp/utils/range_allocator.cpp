@@ -0,0 +1,105 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <iterator>
+#include "range_allocator.h"
+
+namespace nova {
+    range_allocator::range_allocator(std::size_t capacity) : capacity(capacity) {
+        if(capacity > 0) {
+            free_ranges[0] = capacity;
+        }
+    }
+
+    long range_allocator::allocate(std::size_t size) {
+        if(size == 0) {
+            throw std::invalid_argument("Can't allocate an empty range");
+        }
+
+        for(auto itr = free_ranges.begin(); itr != free_ranges.end(); ++itr) {
+            if(itr->second < size) {
+                continue;
+            }
+
+            std::size_t offset = itr->first;
+            std::size_t remaining = itr->second - size;
+            free_ranges.erase(itr);
+            if(remaining > 0) {
+                free_ranges[offset + size] = remaining;
+            }
+
+            allocations[offset] = size;
+            num_allocated += size;
+
+            return static_cast<long>(offset);
+        }
+
+        return -1;
+    }
+
+    void range_allocator::free(std::size_t offset) {
+        auto allocation = allocations.find(offset);
+        if(allocation == allocations.end()) {
+            throw std::invalid_argument("No allocation at offset " + std::to_string(offset));
+        }
+
+        std::size_t size = allocation->second;
+        allocations.erase(allocation);
+        num_allocated -= size;
+
+        // Merge with the free range after this one, then with the one before
+        auto next = free_ranges.lower_bound(offset);
+        if(next != free_ranges.end() && next->first == offset + size) {
+            size += next->second;
+            next = free_ranges.erase(next);
+        }
+
+        if(next != free_ranges.begin()) {
+            auto previous = std::prev(next);
+            if(previous->first + previous->second == offset) {
+                previous->second += size;
+                return;
+            }
+        }
+
+        free_ranges[offset] = size;
+    }
+
+    long range_allocator::find_free_range(std::size_t size) const {
+        for(const auto& range : free_ranges) {
+            if(range.second >= size) {
+                return static_cast<long>(range.first);
+            }
+        }
+
+        return -1;
+    }
+
+    const std::map<std::size_t, std::size_t>& range_allocator::get_allocations() const {
+        return allocations;
+    }
+
+    range_allocator_stats range_allocator::get_stats() const {
+        range_allocator_stats stats = {};
+        stats.capacity = capacity;
+        stats.num_allocated = num_allocated;
+        stats.num_allocations = allocations.size();
+        stats.num_free_ranges = free_ranges.size();
+
+        for(const auto& range : free_ranges) {
+            stats.largest_free_range = std::max(stats.largest_free_range, range.second);
+        }
+
+        std::size_t num_free = capacity - num_allocated;
+        if(num_free > 0) {
+            stats.fragmentation = 1.0f - static_cast<float>(stats.largest_free_range) / num_free;
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,85 @@
+/*!
+ * \brief Hands out ranges of some larger block, like a big GPU buffer
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_RANGE_ALLOCATOR_H
+#define RENDERER_RANGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <map>
+
+namespace nova {
+    /*!
+     * \brief Counters that describe how full and how fragmented a range_allocator is
+     */
+    struct range_allocator_stats {
+        std::size_t capacity;
+        std::size_t num_allocated;
+        std::size_t num_allocations;
+        std::size_t num_free_ranges;
+        std::size_t largest_free_range;
+
+        /*!
+         * \brief 0 if all the free space is in one range, approaching 1 as the free space gets split into more and
+         * smaller ranges
+         */
+        float fragmentation;
+    };
+
+    /*!
+     * \brief A first-fit free-list allocator over the range [0, capacity)
+     *
+     * The allocator doesn't own any memory itself, it only keeps track of which parts of the range are in use. Units
+     * are whatever the caller wants them to be - bytes, vertices, etc. Neighboring free ranges are merged as soon as
+     * they're freed.
+     *
+     * Not thread-safe
+     */
+    class range_allocator {
+    public:
+        explicit range_allocator(std::size_t capacity);
+
+        /*!
+         * \brief Finds room for the given number of units, starting from the lowest offset
+         *
+         * \param size How many units to allocate. Must not be zero
+         * \return The offset of the new allocation, or -1 if there's no free range that's big enough
+         */
+        long allocate(std::size_t size);
+
+        /*!
+         * \brief Gives back the allocation that starts at the given offset
+         *
+         * \param offset An offset that #allocate returned
+         */
+        void free(std::size_t offset);
+
+        /*!
+         * \brief Returns the offset of the lowest free range that could fit the given size, or -1 if there isn't one
+         */
+        long find_free_range(std::size_t size) const;
+
+        /*!
+         * \brief Returns all the live allocations, as a map from offset to size
+         */
+        const std::map<std::size_t, std::size_t>& get_allocations() const;
+
+        range_allocator_stats get_stats() const;
+
+    private:
+        std::size_t capacity;
+        std::size_t num_allocated = 0;
+
+        /*!
+         * \brief Map from offset to size of every free range. Free ranges never touch each other
+         */
+        std::map<std::size_t, std::size_t> free_ranges;
+
+        std::map<std::size_t, std::size_t> allocations;
+    };
+}
+
+#endif //RENDERER_RANGE_ALLOCATOR_H
@@ -0,0 +1,193 @@
+/*!
+ * \brief A container with stable handles and contiguous storage
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_SLOT_MAP_H
+#define RENDERER_SLOT_MAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief Refers to one value in a slot_map
+     *
+     * A handle stays valid until the value it refers to is erased. After that the handle is stale, and the slot_map
+     * will tell you so rather than handing back whatever value has moved into the slot since
+     */
+    struct slot_handle {
+        std::uint32_t index = 0;
+
+        /*!
+         * \brief Generations start at 1, so a default-constructed handle never refers to anything
+         */
+        std::uint32_t generation = 0;
+
+        bool operator==(const slot_handle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const slot_handle& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /*!
+     * \brief Stores values in one contiguous array and hands out generational handles to them
+     *
+     * Inserting and erasing are both O(1). Erasing moves the last value into the erased value's place, so values don't
+     * keep their position in the array, but their handles keep working. Iterating over a slot_map walks the array
+     * directly, in no particular order.
+     *
+     * Not thread-safe
+     */
+    template <typename T>
+    class slot_map {
+    public:
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        /*!
+         * \brief Adds a value and returns a handle to it
+         */
+        slot_handle insert(T&& value) {
+            std::uint32_t slot_index;
+            if(free_slots.empty()) {
+                slot_index = static_cast<std::uint32_t>(slots.size());
+                slots.push_back({0, 1});
+
+            } else {
+                slot_index = free_slots.back();
+                free_slots.pop_back();
+            }
+
+            auto& s = slots[slot_index];
+            s.value_index = static_cast<std::uint32_t>(values.size());
+
+            values.push_back(std::move(value));
+            value_slots.push_back(slot_index);
+
+            return {slot_index, s.generation};
+        }
+
+        /*!
+         * \brief Erases the value that the given handle refers to
+         *
+         * \return True if the value was erased, false if the handle was stale
+         */
+        bool erase(const slot_handle& handle) {
+            if(!contains(handle)) {
+                return false;
+            }
+
+            auto& s = slots[handle.index];
+            std::uint32_t value_index = s.value_index;
+            std::uint32_t last_index = static_cast<std::uint32_t>(values.size() - 1);
+
+            if(value_index != last_index) {
+                values[value_index] = std::move(values[last_index]);
+                value_slots[value_index] = value_slots[last_index];
+                slots[value_slots[value_index]].value_index = value_index;
+            }
+            values.pop_back();
+            value_slots.pop_back();
+
+            // Bumping the generation makes every existing handle to this slot stale
+            s.generation++;
+            free_slots.push_back(handle.index);
+
+            return true;
+        }
+
+        /*!
+         * \brief Checks if the given handle still refers to a value in this slot_map
+         */
+        bool contains(const slot_handle& handle) const {
+            return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+        }
+
+        /*!
+         * \brief Returns the value that the given handle refers to, or nullptr if the handle is stale
+         */
+        T* get(const slot_handle& handle) {
+            return contains(handle) ? &values[slots[handle.index].value_index] : nullptr;
+        }
+
+        const T* get(const slot_handle& handle) const {
+            return contains(handle) ? &values[slots[handle.index].value_index] : nullptr;
+        }
+
+        /*!
+         * \brief Returns the position in the array of the value that the given handle refers to. The handle must not be
+         * stale
+         */
+        std::size_t index_of(const slot_handle& handle) const {
+            return slots[handle.index].value_index;
+        }
+
+        /*!
+         * \brief Returns the handle of the value at the given position in the array
+         */
+        slot_handle get_handle(std::size_t value_index) const {
+            std::uint32_t slot_index = value_slots[value_index];
+            return {slot_index, slots[slot_index].generation};
+        }
+
+        /*!
+         * \brief Accesses values by their position in the array, not by handle
+         */
+        T& operator[](std::size_t value_index) {
+            return values[value_index];
+        }
+
+        const T& operator[](std::size_t value_index) const {
+            return values[value_index];
+        }
+
+        std::size_t size() const {
+            return values.size();
+        }
+
+        bool empty() const {
+            return values.empty();
+        }
+
+        iterator begin() {
+            return values.begin();
+        }
+
+        iterator end() {
+            return values.end();
+        }
+
+        const_iterator begin() const {
+            return values.begin();
+        }
+
+        const_iterator end() const {
+            return values.end();
+        }
+
+    private:
+        struct slot {
+            std::uint32_t value_index;
+            std::uint32_t generation;
+        };
+
+        std::vector<T> values;
+
+        /*!
+         * \brief The slot that points at each value, in the same order as values
+         */
+        std::vector<std::uint32_t> value_slots;
+
+        std::vector<slot> slots;
+        std::vector<std::uint32_t> free_slots;
+    };
+}
+
+#endif //RENDERER_SLOT_MAP_H
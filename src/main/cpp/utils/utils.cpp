@@ -7,6 +7,13 @@
 
 #include "utils.h"
 
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+#include <cerrno>
+
 void initialize_logging() {
     // Configure the logger
     el::Configurations conf("config/logging.conf");
@@ -89,5 +96,13 @@ namespace nova {
 
         return ss.str();
     }
-}
 
+    bool make_directory(const std::string& path) {
+#if defined(_WIN32)
+        int result = _mkdir(path.c_str());
+#else
+        int result = mkdir(path.c_str(), 0755);
+#endif
+        return result == 0 || errno == EEXIST;
+    }
+}
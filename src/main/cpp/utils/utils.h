@@ -130,6 +130,13 @@ namespace nova {
     std::string print_color(unsigned int color);
 
     std::string print_array(int data[], int num_elements);
+
+    /*!
+     * \brief Makes a directory, if it doesn't already exist. Its parent directory has to exist
+     *
+     * \return False if the directory isn't there afterwards
+     */
+    bool make_directory(const std::string& path);
 }
 
 #endif //RENDERER_UTILS_H
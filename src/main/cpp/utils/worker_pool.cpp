@@ -0,0 +1,118 @@
+/*!
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#include <algorithm>
+#include "worker_pool.h"
+
+namespace nova {
+    worker_pool::worker_pool(std::size_t num_workers) {
+        if(num_workers == 0) {
+            unsigned int hardware_threads = std::thread::hardware_concurrency();
+            num_workers = hardware_threads > 1 ? hardware_threads - 1 : 1;
+        }
+
+        for(std::size_t i = 0; i < num_workers; i++) {
+            workers.push_back(std::make_unique<worker>());
+        }
+
+        // Start the threads after all the workers exist so none of them sees a half-built vector
+        for(auto& w : workers) {
+            worker* self = w.get();
+            w->thread = std::thread([self]() { run(*self); });
+        }
+    }
+
+    worker_pool::~worker_pool() {
+        for(auto& w : workers) {
+            std::lock_guard<std::mutex> lock_guard(w->lock);
+            w->should_stop = true;
+            w->has_work.notify_one();
+        }
+
+        for(auto& w : workers) {
+            w->thread.join();
+        }
+    }
+
+    void worker_pool::submit(std::size_t key, std::function<void()> task) {
+        auto& w = *workers[key % workers.size()];
+
+        std::lock_guard<std::mutex> lock_guard(w.lock);
+        w.tasks.push_back(std::move(task));
+        w.has_work.notify_one();
+    }
+
+    void worker_pool::submit(std::function<void()> task) {
+        submit(next_worker.fetch_add(1, std::memory_order_relaxed), std::move(task));
+    }
+
+    void worker_pool::submit_barrier(std::function<void()> task) {
+        struct barrier {
+            std::mutex lock;
+            std::condition_variable has_run;
+            std::size_t num_waiting;
+            bool done = false;
+            std::function<void()> task;
+        };
+
+        auto shared = std::make_shared<barrier>();
+        shared->num_waiting = workers.size();
+        shared->task = std::move(task);
+
+        std::lock_guard<std::mutex> barrier_guard(barrier_lock);
+        for(auto& w : workers) {
+            std::lock_guard<std::mutex> lock_guard(w->lock);
+            w->tasks.push_back([shared]() {
+                std::unique_lock<std::mutex> lock(shared->lock);
+                shared->num_waiting--;
+                if(shared->num_waiting > 0) {
+                    shared->has_run.wait(lock, [&]() { return shared->done; });
+                    return;
+                }
+
+                shared->task();
+                shared->done = true;
+                shared->has_run.notify_all();
+            });
+            w->has_work.notify_one();
+        }
+    }
+
+    void worker_pool::wait_idle() {
+        for(auto& w : workers) {
+            std::unique_lock<std::mutex> lock(w->lock);
+            w->is_idle.wait(lock, [&]() { return w->tasks.empty() && !w->busy; });
+        }
+    }
+
+    std::size_t worker_pool::get_num_workers() const {
+        return workers.size();
+    }
+
+    void worker_pool::run(worker& self) {
+        std::unique_lock<std::mutex> lock(self.lock);
+        while(true) {
+            self.has_work.wait(lock, [&]() { return self.should_stop || !self.tasks.empty(); });
+
+            // Finish everything that was submitted before we were told to stop
+            if(self.tasks.empty()) {
+                return;
+            }
+
+            auto task = std::move(self.tasks.front());
+            self.tasks.pop_front();
+            self.busy = true;
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            self.busy = false;
+            if(self.tasks.empty()) {
+                self.is_idle.notify_all();
+            }
+        }
+    }
+}
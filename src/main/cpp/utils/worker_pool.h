@@ -0,0 +1,104 @@
+/*!
+ * \brief A small pool of threads to push CPU-heavy work off of the render and JNI threads
+ *
+ * \author ddubois
+ * \date 15-Oct-26.
+ */
+
+#ifndef RENDERER_WORKER_POOL_H
+#define RENDERER_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nova {
+    /*!
+     * \brief A fixed set of worker threads, each with its own queue of tasks
+     *
+     * Tasks that are submitted with the same key always run on the same worker, in the order they were submitted.
+     * That's what lets the chunk ingestion stage run on many threads without a removal for a chunk section overtaking
+     * the addition that came before it.
+     */
+    class worker_pool {
+    public:
+        /*!
+         * \brief Starts the worker threads
+         *
+         * \param num_workers How many threads to start. If this is zero, one thread per hardware thread (minus one for
+         * the render thread) is started
+         */
+        explicit worker_pool(std::size_t num_workers = 0);
+
+        /*!
+         * \brief Waits for all submitted tasks to finish, then stops the workers
+         */
+        ~worker_pool();
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        /*!
+         * \brief Runs the given task on the worker that owns the given key
+         *
+         * \param key Tasks with the same key run in order on the same worker
+         * \param task The task to run
+         */
+        void submit(std::size_t key, std::function<void()> task);
+
+        /*!
+         * \brief Runs the given task on whichever worker is next in line
+         *
+         * \param task The task to run
+         */
+        void submit(std::function<void()> task);
+
+        /*!
+         * \brief Runs the given task once, after every task that was submitted before it has finished, and before any
+         * task that's submitted after it starts
+         *
+         * Every worker waits at the barrier until the last one gets there, and that one runs the task. This is for
+         * work that has to stay in order with tasks for more than one key
+         *
+         * \param task The task to run
+         */
+        void submit_barrier(std::function<void()> task);
+
+        /*!
+         * \brief Blocks until every task that's been submitted so far has finished
+         */
+        void wait_idle();
+
+        std::size_t get_num_workers() const;
+
+    private:
+        struct worker {
+            std::mutex lock;
+            std::condition_variable has_work;
+            std::condition_variable is_idle;
+            std::deque<std::function<void()>> tasks;
+            bool busy = false;
+            bool should_stop = false;
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<worker>> workers;
+
+        std::atomic<std::size_t> next_worker{0};
+
+        /*!
+         * \brief Held while a barrier is handed to the workers, so that every worker sees the barriers in the same
+         * order. Otherwise two workers could each wait at a different barrier for the other
+         */
+        std::mutex barrier_lock;
+
+        static void run(worker& self);
+    };
+}
+
+#endif //RENDERER_WORKER_POOL_H
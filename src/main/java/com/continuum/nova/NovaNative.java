@@ -93,6 +93,9 @@ public interface NovaNative extends Library {
     }
 
     class mc_chunk_render_object extends Structure {
+        /**
+         * Ignored by Nova, which picks the format to convert chunk vertices to from the compactChunkVertices setting
+         */
         public int format;
         public float x;
         public float y;
@@ -127,12 +130,96 @@ public interface NovaNative extends Library {
             index_buffer_size = indices.size();
         }
 
+        /**
+         * Writes the vertex data and indices into Nova's chunk transfer buffer and points this object at them, so that
+         * Nova can read them without copying
+         *
+         * @param transferBuffer The pointer returned by get_chunk_transfer_buffer
+         * @param vertexData The vertex data to write
+         * @param indices The indices to write
+         * @return True if the data was written, false if the transfer buffer is full or there's no data to write. If
+         * this returns false, use setVertex_data and setIndices instead
+         */
+        public boolean setDataInTransferBuffer(Pointer transferBuffer, IntBuffer vertexData, List<Integer> indices) {
+            int intSize = Native.getNativeSize(Integer.TYPE);
+            int vertexBytes = vertexData.limit() * intSize;
+            int indexBytes = indices.size() * intSize;
+            if(vertexBytes == 0) {
+                return false;
+            }
+
+            int offset = NovaNative.INSTANCE.reserve_chunk_transfer_space(vertexBytes + indexBytes);
+            if(offset < 0) {
+                return false;
+            }
+
+            ByteBuffer buffer = transferBuffer.getByteBuffer(offset, vertexBytes + indexBytes).order(ByteOrder.nativeOrder());
+            IntBuffer intBuffer = buffer.asIntBuffer();
+            vertexData.position(0);
+            intBuffer.put(vertexData);
+            for(Integer index : indices) {
+                intBuffer.put(index);
+            }
+
+            vertex_data = transferBuffer.share(offset);
+            this.indices = transferBuffer.share(offset + vertexBytes);
+            vertex_buffer_size = vertexData.limit();
+            index_buffer_size = indices.size();
+
+            return true;
+        }
+
         @Override
         public List<String> getFieldOrder() {
             return Arrays.asList("format", "x", "y", "z", "id", "vertex_data", "indices", "vertex_buffer_size", "index_buffer_size");
         }
     }
 
+    class mc_chunk_patch extends Structure {
+        public float x;
+        public float y;
+        public float z;
+        public int id;
+        public int first_quad;
+        public int num_replaced_quads;
+        public Pointer vertex_data; // int[]
+        public int vertex_buffer_size;
+
+        public void setVertex_data(IntBuffer vertexData) {
+            int s = vertexData.limit();
+            Memory vertex_datam = new Memory(s * Native.getNativeSize(Integer.class));
+            ByteBuffer bbuf = vertex_datam.getByteBuffer(0, s * Native.getNativeSize(Integer.class));
+            vertexData.position(0);
+            bbuf.asIntBuffer().put(vertexData);
+            vertex_data = vertex_datam;
+
+            vertex_buffer_size = s;
+        }
+
+        @Override
+        public List<String> getFieldOrder() {
+            return Arrays.asList("x", "y", "z", "id", "first_quad", "num_replaced_quads", "vertex_data", "vertex_buffer_size");
+        }
+    }
+
+    class mc_chunk_section_opacity extends Structure {
+        public float x;
+        public float y;
+        public float z;
+        public Pointer opaque_blocks; // int[128]
+
+        public void setOpaque_blocks(int[] opaqueBlocks) {
+            Memory opaque_blocksm = new Memory(opaqueBlocks.length * Native.getNativeSize(Integer.class));
+            opaque_blocksm.write(0, opaqueBlocks, 0, opaqueBlocks.length);
+            opaque_blocks = opaque_blocksm;
+        }
+
+        @Override
+        public List<String> getFieldOrder() {
+            return Arrays.asList("x", "y", "z", "opaque_blocks");
+        }
+    }
+
     class mc_settings extends Structure {
         public boolean render_menu;
 
@@ -278,6 +365,24 @@ public interface NovaNative extends Library {
 
     void remove_chunk_geometry_for_filter(String filter_name, mc_chunk_render_object render_object);
 
+    void patch_chunk_geometry_for_filter(String filter_name, mc_chunk_patch patch);
+
+    boolean get_next_failed_chunk_patch(mc_chunk_patch patch);
+
+    void set_chunk_section_opacity(mc_chunk_section_opacity section);
+
+    void open_chunk_mesh_cache(String world_name);
+
+    void load_chunk_mesh_cache(float center_x, float center_z, float radius);
+
+    void close_chunk_mesh_cache();
+
+    Pointer get_chunk_transfer_buffer();
+
+    int get_chunk_transfer_buffer_size();
+
+    int reserve_chunk_transfer_space(int num_bytes);
+
     boolean should_close();
 
     void add_gui_geometry(mc_gui_buffer buffer);
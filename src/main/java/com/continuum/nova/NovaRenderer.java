@@ -2,16 +2,19 @@ package com.continuum.nova;
 
 import com.continuum.nova.NovaNative.window_size;
 import com.continuum.nova.chunks.ChunkBuilder;
+import com.continuum.nova.chunks.ChunkPatches;
 import com.continuum.nova.chunks.ChunkUpdateListener;
 import com.continuum.nova.chunks.IGeometryFilter;
 import com.continuum.nova.gui.NovaDraw;
 import com.continuum.nova.utils.Profiler;
 import com.continuum.nova.utils.Utils;
+import com.sun.jna.Pointer;
 import glm.Glm;
 import glm.vec._2.Vec2;
 import glm.vec._3.i.Vec3i;
 import net.minecraft.client.Minecraft;
 import net.minecraft.client.entity.EntityPlayerSP;
+import net.minecraft.client.gui.GuiDownloadTerrain;
 import net.minecraft.client.gui.ScaledResolution;
 import net.minecraft.client.renderer.BlockModelShapes;
 import net.minecraft.client.renderer.EntityRenderer;
@@ -24,6 +27,7 @@ import net.minecraft.client.resources.IResourceManager;
 import net.minecraft.client.resources.IResourceManagerReloadListener;
 import net.minecraft.entity.Entity;
 import net.minecraft.util.ResourceLocation;
+import net.minecraft.util.math.BlockPos;
 import net.minecraft.world.World;
 import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
@@ -83,6 +87,13 @@ public class NovaRenderer implements IResourceManagerReloadListener {
     private ChunkBuilder chunkBuilder;
     private HashMap<String, IGeometryFilter> filterMap;
 
+    private Pointer chunkTransferBuffer;
+
+    /**
+     * True from when a world is joined until its chunk mesh cache has been loaded
+     */
+    private boolean shouldLoadChunkMeshCache;
+
     public NovaRenderer() {
         // I put these in Utils to make this class smaller
         Utils.initBlockTextureLocations(BLOCK_COLOR_TEXTURES_LOCATIONS);
@@ -95,6 +106,14 @@ public class NovaRenderer implements IResourceManagerReloadListener {
       return this.filterMap;
     }
 
+    /**
+     * @return The shared memory that chunk geometry can be written into with
+     * {@link NovaNative.mc_chunk_render_object#setDataInTransferBuffer}
+     */
+    public Pointer getChunkTransferBuffer() {
+        return chunkTransferBuffer;
+    }
+
     @Override
     public void onResourceManagerReload(@Nonnull IResourceManager resourceManager) {
         this.resourceManager = resourceManager;
@@ -243,6 +262,7 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         LOG.info("PID: " + pid + " TID: " + Thread.currentThread().getId());
         NovaNative.INSTANCE.initialize();
         LOG.info("Native code initialized");
+        chunkTransferBuffer = NovaNative.INSTANCE.get_chunk_transfer_buffer();
         updateWindowSize();
 
         // Moved here so that it's initialized after the native code is loaded
@@ -325,6 +345,18 @@ public class NovaRenderer implements IResourceManagerReloadListener {
         }
         Profiler.end("update_chunks");
 
+        Profiler.start("resend_failed_patches");
+        // Nova couldn't apply these patches, so the sections they were for are rebuilt and sent whole
+        NovaNative.mc_chunk_patch failedPatch = new NovaNative.mc_chunk_patch();
+        while(NovaNative.INSTANCE.get_next_failed_chunk_patch(failedPatch)) {
+            BlockPos sectionPos = new BlockPos((int) failedPatch.x, (int) failedPatch.y, (int) failedPatch.z);
+            ChunkPatches.sendWholeNextTime(sectionPos);
+            if(world != null) {
+                world.markBlockRangeForRenderUpdate(sectionPos, sectionPos.add(15, 15, 15));
+            }
+        }
+        Profiler.end("resend_failed_patches");
+
         Profiler.start("update_player");
         EntityPlayerSP viewEntity = mc.thePlayer;
         if(viewEntity != null) {
@@ -334,6 +366,14 @@ public class NovaRenderer implements IResourceManagerReloadListener {
             double y = viewEntity.posY + viewEntity.getEyeHeight();
             double z = viewEntity.posZ;
             NovaNative.INSTANCE.set_player_camera_transform(x, y, z, yaw, pitch);
+
+            // The player is at the origin until the server says where they are, which it's done by the time the
+            // terrain screen goes away
+            if(shouldLoadChunkMeshCache && !(mc.currentScreen instanceof GuiDownloadTerrain)) {
+                float renderDistance = mc.gameSettings.renderDistanceChunks * 16;
+                NovaNative.INSTANCE.load_chunk_mesh_cache((float) x, (float) z, renderDistance);
+                shouldLoadChunkMeshCache = false;
+            }
         }
         Profiler.end("update_player");
 
@@ -363,6 +403,11 @@ public class NovaRenderer implements IResourceManagerReloadListener {
     }
 
     public void setWorld(World world) {
+        // Minecraft goes through here when leaving a world and when changing dimension, and nothing from the old world
+        // belongs in the new one's cache
+        NovaNative.INSTANCE.close_chunk_mesh_cache();
+        shouldLoadChunkMeshCache = false;
+
         if(world != null) {
             world.addEventListener(chunkUpdateListener);
             this.world = world;
@@ -371,9 +416,29 @@ public class NovaRenderer implements IResourceManagerReloadListener {
             if(chunkBuilder != null) {
                 chunkBuilder.setWorld(world);
             }
+
+            NovaNative.INSTANCE.open_chunk_mesh_cache(getChunkMeshCacheName(world));
+            shouldLoadChunkMeshCache = true;
         }
     }
 
+    /**
+     * @return A name for the world's chunk mesh cache that's different for every save, server and dimension
+     */
+    private static String getChunkMeshCacheName(World world) {
+        Minecraft mc = Minecraft.getMinecraft();
+        String worldName;
+        if(mc.getIntegratedServer() != null) {
+            worldName = mc.getIntegratedServer().getFolderName();
+        } else if(mc.getCurrentServerData() != null) {
+            worldName = mc.getCurrentServerData().serverIP;
+        } else {
+            worldName = world.getWorldInfo().getWorldName();
+        }
+
+        return worldName + "_" + world.provider.getDimensionType().getId();
+    }
+
     /**
      * Loads the specified texture, adding it to Minecraft as a texture outside of an atlas
      *
@@ -161,6 +161,17 @@ public class CapturingVertexBuffer extends VertexBuffer {
         return this.rawIntBuffer;
     }
 
+    /**
+     * @return A copy of the vertices that have been written, without the unused space after them
+     */
+    public int[] getVertexData() {
+        int[] vertexData = new int[getBufferSize()];
+        int oldPos = this.rawIntBuffer.position();
+        ((IntBuffer) this.rawIntBuffer.position(0)).get(vertexData);
+        this.rawIntBuffer.position(oldPos);
+        return vertexData;
+    }
+
     public boolean isEmpty(){
       return this.vertexCount<1;
     }
@@ -0,0 +1,104 @@
+package com.continuum.nova.chunks;
+
+import com.continuum.nova.NovaNative;
+import net.minecraft.util.math.BlockPos;
+
+import java.nio.IntBuffer;
+import java.util.Arrays;
+import java.util.Optional;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Works out which quads of a chunk section changed since it was last sent to Nova, so that a block update only sends
+ * those quads instead of the whole section
+ *
+ * @author ddubois
+ * @since 16-Oct-26
+ */
+public class ChunkPatches {
+    /**
+     * Four of Minecraft's seven-int vertices
+     */
+    private static final int QUAD_SIZE_INTS = 28;
+
+    /**
+     * Sections that Nova couldn't patch, by position. They're sent whole the next time they're rebuilt
+     */
+    private static final Set<Long> sectionsToSendWhole = ConcurrentHashMap.newKeySet();
+
+    /**
+     * Makes the section at the given position get sent whole the next time it's rebuilt
+     *
+     * @param sectionPos The minimum corner of the section
+     */
+    public static void sendWholeNextTime(BlockPos sectionPos) {
+        sectionsToSendWhole.add(sectionPos.toLong());
+    }
+
+    /**
+     * Checks whether the section at the given position has to be sent whole, and forgets about it if it does
+     *
+     * @param sectionPos The minimum corner of the section
+     * @return True if the section has to be sent whole
+     */
+    public static boolean takeSendWhole(BlockPos sectionPos) {
+        return sectionsToSendWhole.remove(sectionPos.toLong());
+    }
+
+    /**
+     * Makes a patch that turns the quads that were last sent into the new ones
+     *
+     * Minecraft builds a section's quads block by block, in the same order every time, so changing a block only
+     * changes the quads in the middle. The patch replaces everything between the quads that are the same at the start
+     * and the quads that are the same at the end
+     *
+     * @param sentVertexData The vertex data that was last sent for the section
+     * @param vertexData The section's new vertex data
+     * @return The patch, without its position or ID, or nothing if so much changed that the section may as well be
+     * sent whole
+     */
+    public static Optional<NovaNative.mc_chunk_patch> makePatch(int[] sentVertexData, int[] vertexData) {
+        int numSentQuads = sentVertexData.length / QUAD_SIZE_INTS;
+        int numQuads = vertexData.length / QUAD_SIZE_INTS;
+
+        int firstChanged = 0;
+        while(firstChanged < numSentQuads && firstChanged < numQuads &&
+                isSameQuad(sentVertexData, firstChanged, vertexData, firstChanged)) {
+            firstChanged++;
+        }
+
+        int numSameAtEnd = 0;
+        while(numSameAtEnd < numSentQuads - firstChanged && numSameAtEnd < numQuads - firstChanged &&
+                isSameQuad(sentVertexData, numSentQuads - 1 - numSameAtEnd, vertexData, numQuads - 1 - numSameAtEnd)) {
+            numSameAtEnd++;
+        }
+
+        int numNewQuads = numQuads - firstChanged - numSameAtEnd;
+        if(numNewQuads * 2 > numQuads) {
+            return Optional.empty();
+        }
+
+        NovaNative.mc_chunk_patch patch = new NovaNative.mc_chunk_patch();
+        patch.first_quad = firstChanged;
+        patch.num_replaced_quads = numSentQuads - firstChanged - numSameAtEnd;
+        if(numNewQuads > 0) {
+            int start = firstChanged * QUAD_SIZE_INTS;
+            patch.setVertex_data(IntBuffer.wrap(Arrays.copyOfRange(vertexData, start, start + numNewQuads * QUAD_SIZE_INTS)));
+        }
+
+        return Optional.of(patch);
+    }
+
+    private static boolean isSameQuad(int[] a, int aQuad, int[] b, int bQuad) {
+        int aStart = aQuad * QUAD_SIZE_INTS;
+        int bStart = bQuad * QUAD_SIZE_INTS;
+        for(int i = 0; i < QUAD_SIZE_INTS; i++) {
+            if(a[aStart + i] != b[bStart + i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}